@@ -32,6 +32,14 @@
 #include <arpa/inet.h>
 #endif
 
+#ifdef __LINUX__
+#include <sys/socket.h>
+#include <poll.h>
+#endif
+
+// spill buffered packet data to disk once this much is waiting
+#define SPILL_FLUSH_SIZE (1024 * 1024)
+
 #include "../include/xLights.xpm"
 #include "../include/xLights-16.xpm"
 #include "../include/xLights-32.xpm"
@@ -120,10 +128,79 @@ void xCaptureFrame::PurgeCollectedData()
         _capturedData.pop_front();
         delete toDelete;
     }
+    ResetSpill();
+}
+
+#pragma region Capture Spill File
+void xCaptureFrame::ResetSpill()
+{
+    if (_spill.IsOpened())
+    {
+        _spill.Close();
+    }
+    if (_spillFile != "" && wxFile::Exists(_spillFile))
+    {
+        wxRemoveFile(_spillFile);
+    }
+    _spillFile = "";
+    _spillSize = 0;
+    _spillBuffer.clear();
+}
+
+wxFileOffset xCaptureFrame::SpillPacketData(const wxByte* data, int length)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (!_spill.IsOpened())
+    {
+        _spillFile = wxFileName::CreateTempFileName("xCapture");
+        if (_spillFile == "" || !_spill.Open(_spillFile, wxFile::read_write))
+        {
+            logger_base.error("Unable to create capture spill file.");
+            _spillFile = "";
+            return -1;
+        }
+        logger_base.debug("Capturing packet data to %s.", (const char*)_spillFile.c_str());
+        _spillBuffer.reserve(SPILL_FLUSH_SIZE + CAPTURE_SLOT_SIZE);
+    }
+
+    wxFileOffset offset = _spillSize + _spillBuffer.size();
+    _spillBuffer.insert(_spillBuffer.end(), data, data + length);
+
+    if (_spillBuffer.size() >= SPILL_FLUSH_SIZE)
+    {
+        _spill.SeekEnd();
+        _spill.Write(_spillBuffer.data(), _spillBuffer.size());
+        _spillSize += _spillBuffer.size();
+        _spillBuffer.clear();
+    }
+
+    return offset;
+}
+
+bool xCaptureFrame::ReadPacketData(const PacketData& p, wxByte* buffer)
+{
+    if (p._offset < 0 || !_spill.IsOpened()) return false;
+
+    // still sitting in the write buffer
+    if (p._offset >= _spillSize)
+    {
+        memcpy(buffer, _spillBuffer.data() + (p._offset - _spillSize), p._length);
+        return true;
+    }
+
+    if (_spill.Seek(p._offset) == wxInvalidOffset) return false;
+    return _spill.Read(buffer, p._length) == (ssize_t)p._length;
 }
+#pragma endregion Capture Spill File
 
-void xCaptureFrame::StashPacket(long type, wxByte* packet, int len)
+void xCaptureFrame::StashPacket(long type, wxByte* packet, int len, wxLongLong timeStamp)
 {
+    int seq = 0;
+    int length = 0;
+    const wxByte* data = nullptr;
+    if (!PacketData::Parse(type, packet, len, seq, length, data)) return;
+
     int universe = -1;
     if (type == ID_E131SOCKET)
     {
@@ -143,7 +220,9 @@ void xCaptureFrame::StashPacket(long type, wxByte* packet, int len)
     {
         if (universe == SpinCtrl_Universe->GetValue())
         {
-            wxByte c = packet[125 + SpinCtrl_Channel->GetValue()];
+            int channel = SpinCtrl_Channel->GetValue();
+            if (channel < 1 || channel > length) return;
+            wxByte c = data[channel - 1];
 
             if (c >= SpinCtrl_TriggerStart->GetValue())
             {
@@ -162,22 +241,29 @@ void xCaptureFrame::StashPacket(long type, wxByte* packet, int len)
 
     if (!_capturing) return;
 
+    Collector* c = nullptr;
     for (auto it = _capturedData.begin(); it != _capturedData.end(); ++it)
     {
         if ((*it)->_protocol == type && (*it)->_universe == universe)
         {
-            _capturedPackets++;
-            (*it)->AddPacket(type, packet, len);
-            return;
+            c = *it;
+            break;
         }
     }
 
-    // Doing thise here means we only need to check the list when it isnt already captured
-    if (!IsUniverseToBeCaptured(universe)) return;
+    if (c == nullptr)
+    {
+        // Doing thise here means we only need to check the list when it isnt already captured
+        if (!IsUniverseToBeCaptured(universe)) return;
+
+        c = new Collector(type, universe);
+        _capturedData.push_back(c);
+    }
+
+    wxFileOffset offset = SpillPacketData(data, length);
+    if (offset < 0) return;
 
-    Collector* c = new Collector(type, universe);
-    _capturedData.push_back(c);
-    c->AddPacket(type, packet, len);
+    c->AddPacket(PacketData(timeStamp, seq, length, offset));
     _capturedPackets++;
 }
 
@@ -206,7 +292,7 @@ int xCaptureFrame::GuessFrameMS()
     Collector* c = _capturedData.front();
 
     bool first = true;
-    wxDateTime last;
+    wxLongLong last;
     double totalgap = 0;
     int count = 0;
     // look at the first 10 intervals
@@ -218,10 +304,10 @@ int xCaptureFrame::GuessFrameMS()
         }
         else
         {
-            totalgap += ((*it)->_timeStamp - last).GetValue().ToDouble();
+            totalgap += (it->_timeStamp - last).ToDouble();
             count++;
         }
-        last = (*it)->_timeStamp;
+        last = it->_timeStamp;
     }
     logger_base.debug("Guessing frame time. Total time %fms. Intervals %d, Average Frame %fms, Estimate %dms",
         totalgap,
@@ -239,6 +325,10 @@ xCaptureFrame::xCaptureFrame(wxWindow* parent, const std::string& showdir, const
 
     _e131Socket = nullptr;
     _artNETSocket = nullptr;
+    _receiver = nullptr;
+    _stopReceiver = false;
+    _drainPending = false;
+    _spillSize = 0;
     _capturing = false;
     _capturedPackets = 0;
     _capturedDesc = "";
@@ -379,9 +469,6 @@ xCaptureFrame::xCaptureFrame(wxWindow* parent, const std::string& showdir, const
     Connect(wxEVT_SIZE,(wxObjectEventFunction)&xCaptureFrame::OnResize);
     //*)
 
-    Connect(ID_E131SOCKET, wxEVT_SOCKET, (wxObjectEventFunction)&xCaptureFrame::OnE131SocketEvent);
-    Connect(ID_ARTNETSOCKET, wxEVT_SOCKET, (wxObjectEventFunction)&xCaptureFrame::OnArtNETSocketEvent);
-
     SetTitle("xLights Capture " + GetDisplayVersionString());
 
     wxIconBundle icons;
@@ -412,6 +499,7 @@ xCaptureFrame::xCaptureFrame(wxWindow* parent, const std::string& showdir, const
 
     if (CheckBox_ArtNET->GetValue()) CreateArtNETListener();
     if (CheckBox_E131->GetValue()) CreateE131Listener();
+    StartReceiver();
 
     Button_StartStop->SetLabel("Start");
 
@@ -558,6 +646,9 @@ void xCaptureFrame::SaveState()
 // close not required sockets
 void xCaptureFrame::CloseSockets(bool force)
 {
+    // the receive thread owns the sockets while it runs ... callers restart it once the sockets are recreated
+    StopReceiver();
+
     if (force || !CheckBox_E131->GetValue())
     {
         if (_e131Socket != nullptr)
@@ -590,78 +681,75 @@ void xCaptureFrame::OnAbout(wxCommandEvent& event)
     wxMessageBox(about, _("Welcome to..."));
 }
 
-PacketData::PacketData(long type, wxByte* packet, int len)
+bool PacketData::Parse(long type, const wxByte* packet, int len, int& seq, int& length, const wxByte*& data)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    _timeStamp = wxDateTime::UNow();
-    _frameTimeMS = -1;
-    _seq = 0;
-    _length = 0;
-    _pdata = nullptr;
 
     if (type == xCaptureFrame::ID_E131SOCKET)
     {
         // validate the packet
-        if (len < 126) return;
-        if (packet[4] != 0x41) return;
-        if (packet[5] != 0x53) return;
-        if (packet[6] != 0x43) return;
-        if (packet[7] != 0x2d) return;
-        if (packet[8] != 0x45) return;
-        if (packet[9] != 0x31) return;
-        if (packet[10] != 0x2e) return;
-        if (packet[11] != 0x31) return;
-        if (packet[12] != 0x37) return;
-
-        _seq = (int)packet[111];
-        _length = (((int)packet[115] - 0x70) << 8) + (int)packet[116] - 11;
-        if (_length > len - 126)
+        if (len < 126) return false;
+        if (packet[4] != 0x41) return false;
+        if (packet[5] != 0x53) return false;
+        if (packet[6] != 0x43) return false;
+        if (packet[7] != 0x2d) return false;
+        if (packet[8] != 0x45) return false;
+        if (packet[9] != 0x31) return false;
+        if (packet[10] != 0x2e) return false;
+        if (packet[11] != 0x31) return false;
+        if (packet[12] != 0x37) return false;
+
+        seq = (int)packet[111];
+        length = (((int)packet[115] - 0x70) << 8) + (int)packet[116] - 11;
+        if (length > len - 126)
         {
-            logger_base.warn("E131 packet of claimed length %d truncated to actual packet length %d.", _length, len - 126);
+            logger_base.warn("E131 packet of claimed length %d truncated to actual packet length %d.", length, len - 126);
             logger_base.warn("    Packet looks unlikely to be valid.");
-            _length = len - 126;
+            length = len - 126;
         }
-        _pdata = (wxByte*)malloc(_length);
-        memcpy(_pdata, &packet[126], _length);
+        if (length < 0) return false;
+        data = &packet[126];
+        return true;
     }
     else if (type == xCaptureFrame::ID_ARTNETSOCKET)
     {
         // validate the packet
-        if (len < 18) return;
-        if (packet[0] != 'A') return;
-        if (packet[1] != 'r') return;
-        if (packet[2] != 't') return;
-        if (packet[3] != '-') return;
-        if (packet[4] != 'N') return;
-        if (packet[5] != 'e') return;
-        if (packet[6] != 't') return;
-        if (packet[9] != 0x50) return;
-
-        _seq = (int)packet[12];
-        _length = ((int)packet[16] << 8) + (int)packet[17];
-        if (_length > len - 18)
+        if (len < 18) return false;
+        if (packet[0] != 'A') return false;
+        if (packet[1] != 'r') return false;
+        if (packet[2] != 't') return false;
+        if (packet[3] != '-') return false;
+        if (packet[4] != 'N') return false;
+        if (packet[5] != 'e') return false;
+        if (packet[6] != 't') return false;
+        if (packet[9] != 0x50) return false;
+
+        seq = (int)packet[12];
+        length = ((int)packet[16] << 8) + (int)packet[17];
+        if (length > len - 18)
         {
-            logger_base.warn("ArtNet packet of claimed length %d truncated to actual packet length %d.", _length, len - 18);
+            logger_base.warn("ArtNet packet of claimed length %d truncated to actual packet length %d.", length, len - 18);
             logger_base.warn("    Packet looks unlikely to be valid.");
-            _length = len - 18;
+            length = len - 18;
         }
-        _pdata = (wxByte*)malloc(_length);
-        memcpy(_pdata, &packet[18], _length);
+        data = &packet[18];
+        return true;
     }
+    return false;
 }
 
-Collector::~Collector()
+void Collector::AddPacket(const PacketData& packet)
 {
-    while (_packets.size() > 0)
+    if (_packets.size() > 0)
     {
-        auto toDelete = _packets.front();
-        _packets.pop_front();
-        delete toDelete;
+        int gap = ((int)packet._seq - (int)_packets.back()._seq - 1) & 0xFF;
+        _missing += gap;
     }
+    _packets.push_back(packet);
 }
 
 // relies on missing sequence numbers to detect missing frames
-void Collector::CalculateFrames(wxDateTime startTime, int frameMS)
+void Collector::CalculateFrames(wxLongLong startTime, int frameMS)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
@@ -672,9 +760,9 @@ void Collector::CalculateFrames(wxDateTime startTime, int frameMS)
     // rebase the start time to the start time in this universe if possible
     if (_packets.size() > 0)
     {
-        double rawFrameMS = (_packets.front()->_timeStamp - startTime).GetValue().ToDouble();
+        double rawFrameMS = (_packets.front()._timeStamp - startTime).ToDouble();
         ms = ((int)(rawFrameMS / frameMS)) * frameMS;
-        lastseq = _packets.front()->_seq - 1;
+        lastseq = _packets.front()._seq - 1;
         if (lastseq < 0) lastseq = 255;
     }
 
@@ -684,14 +772,14 @@ void Collector::CalculateFrames(wxDateTime startTime, int frameMS)
         lastseq += 1;
         if (lastseq > 255) lastseq = 0;
 
-        if (lastseq != (*it)->_seq)
+        if (lastseq != it->_seq)
         {
             // a frame is missing
             // check it is only one
             auto next = it;
             ++next;
 
-            if (next != _packets.end() && (*next)->_seq == lastseq)
+            if (next != _packets.end() && next->_seq == lastseq)
             {
                 logger_base.warn("Universe %d missing one packet sequence lastSeq %d", _universe, lastseq);
                 // only one frame was missing so assume it was lost
@@ -705,26 +793,24 @@ void Collector::CalculateFrames(wxDateTime startTime, int frameMS)
                 {
                     logger_base.warn("Universe %d missing multiple packets from sequence %d", _universe, lastseq);
                 }
-                lastseq = (*it)->_seq;
+                lastseq = it->_seq;
             }
         }
-        (*it)->_frameTimeMS = ms;
+        it->_frameTimeMS = ms;
         ms += frameMS;
         first = false;
     }
 }
 
+// frame times are ascending once CalculateFrames has run
 PacketData* Collector::GetPacket(long ms)
 {
-    auto it = _packets.begin();
-    while (it != _packets.end() && ms > (*it)->_frameTimeMS)
-    {
-        ++it;
-    }
+    auto it = std::lower_bound(_packets.begin(), _packets.end(), ms,
+        [](const PacketData& p, long m) { return p._frameTimeMS < m; });
 
-    if (it != _packets.end() && ms == (*it)->_frameTimeMS)
+    if (it != _packets.end() && ms == it->_frameTimeMS)
     {
-        return (*it);
+        return &(*it);
     }
 
     return nullptr;
@@ -819,7 +905,7 @@ void xCaptureFrame::CreateE131Listener()
     addr.AnyAddress();
     addr.Service(E131PORT);
     //create and bind to the address above
-    _e131Socket = new wxDatagramSocket(addr);
+    _e131Socket = new wxDatagramSocket(addr, wxSOCKET_BLOCK);
 
     if (_e131Socket->IsOk())
     {
@@ -845,13 +931,6 @@ void xCaptureFrame::CreateE131Listener()
                 }
             }
         }
-
-        //enable event handling
-        _e131Socket->SetEventHandler(*this, ID_E131SOCKET);
-        //Notify us about incomming data
-        _e131Socket->SetNotify(wxSOCKET_INPUT_FLAG);
-        //enable event handling
-        _e131Socket->Notify(true);
     }
     else
     {
@@ -872,7 +951,7 @@ void xCaptureFrame::CreateArtNETListener()
     addr.AnyAddress();
     addr.Service(ARTNETPORT);
     //create and bind to the address above
-    _artNETSocket = new wxDatagramSocket(addr);
+    _artNETSocket = new wxDatagramSocket(addr, wxSOCKET_BLOCK);
 
     if (_artNETSocket->IsOk())
     {
@@ -898,13 +977,6 @@ void xCaptureFrame::CreateArtNETListener()
                 }
             }
         }
-
-        //enable event handling
-        _artNETSocket->SetEventHandler(*this, ID_ARTNETSOCKET);
-        //Notify us about incomming data
-        _artNETSocket->SetNotify(wxSOCKET_INPUT_FLAG);
-        //enable event handling
-        _artNETSocket->Notify(true);
     }
     else
     {
@@ -1065,6 +1137,7 @@ void xCaptureFrame::OnButton_StartStopClick(wxCommandEvent& event)
     {
         _capturedDesc = "";
         _capturedPackets = 0;
+        _ring.ResetDropped();
         PurgeCollectedData();
         Button_StartStop->SetLabel("Stop");
         _capturedDesc = "";
@@ -1077,11 +1150,12 @@ void xCaptureFrame::OnButton_StartStopClick(wxCommandEvent& event)
         logger_base.debug("Capture stopped.");
         for (auto it = _capturedData.begin(); it != _capturedData.end(); ++it)
         {
-            logger_base.debug("    Protocol %s, Universe %d, Size %d, Frames %d",
+            logger_base.debug("    Protocol %s, Universe %d, Size %d, Frames %d, Missing %ld",
                 (*it)->_protocol == ID_E131SOCKET ? "E131" : "ArtNET",
                 (*it)->_universe,
-                (*it)->_packets.size() > 0 ? (*it)->_packets.front()->_length : 0,
-                (int)(*it)->_packets.size()
+                (*it)->_packets.size() > 0 ? (*it)->_packets.front()._length : 0,
+                (int)(*it)->_packets.size(),
+                (*it)->_missing
             );
         }
     }
@@ -1123,7 +1197,7 @@ void xCaptureFrame::OnButton_SaveClick(wxCommandEvent& event)
         long channelsPerFrame = RoundTo4(GetChannelsPerFrame());
         log += wxString::Format("Channels Per Frame: %ld\n", channelsPerFrame);
 
-        wxDateTime startTime = GetStartTime();
+        wxLongLong startTime = GetStartTime();
 
         int frames = GetFrames();
         log += wxString::Format("Frames: %d\n", frames);
@@ -1135,9 +1209,9 @@ void xCaptureFrame::OnButton_SaveClick(wxCommandEvent& event)
 
             log += wxString::Format("Channel %ld, Protocol %s, Universe %d, Size %d, Frames %d, StartFrameMS %dms, EndFrameMS %dms\n",
                 (*it)->_startChannel, (*it)->_protocol == ID_E131SOCKET ? "E131" : "ArtNET",
-                (*it)->_universe, (*it)->_packets.size() > 0 ? (*it)->_packets.front()->_length : 0,
-                (int)(*it)->_packets.size(), (*it)->_packets.size() > 0 ? (*it)->_packets.front()->_frameTimeMS : -1,
-                (*it)->_packets.size() > 0 ? (*it)->_packets.back()->_frameTimeMS : -1);
+                (*it)->_universe, (*it)->_packets.size() > 0 ? (*it)->_packets.front()._length : 0,
+                (int)(*it)->_packets.size(), (*it)->_packets.size() > 0 ? (*it)->_packets.front()._frameTimeMS : -1,
+                (*it)->_packets.size() > 0 ? (*it)->_packets.back()._frameTimeMS : -1);
         }
         log += wxString::Format("Channel Structure End!\n");
 
@@ -1165,23 +1239,23 @@ long xCaptureFrame::GetChannelsPerFrame()
         (*it)->_startChannel = size + 1;
         if ((*it)->_packets.size() > 0)
         {
-            size += (*it)->_packets.front()->_length;
+            size += (*it)->_packets.front()._length;
         }
     }
 
     return size;
 }
 
-wxDateTime xCaptureFrame::GetStartTime()
+wxLongLong xCaptureFrame::GetStartTime()
 {
-    wxDateTime startTime = wxDateTime::Now();
+    wxLongLong startTime = wxGetUTCTimeMillis();
     for (auto it = _capturedData.begin(); it != _capturedData.end(); ++it)
     {
         if ((*it)->_packets.size() > 0)
         {
-            if ((*it)->_packets.front()->_timeStamp < startTime)
+            if ((*it)->_packets.front()._timeStamp < startTime)
             {
-                startTime = (*it)->_packets.front()->_timeStamp;
+                startTime = (*it)->_packets.front()._timeStamp;
             }
         }
     }
@@ -1231,6 +1305,7 @@ void xCaptureFrame::OnButton_ClearClick(wxCommandEvent& event)
 {
     _capturedDesc = "";
     _capturedPackets = 0;
+    _ring.ResetDropped();
     PurgeCollectedData();
     ValidateWindow();
 }
@@ -1242,6 +1317,7 @@ void xCaptureFrame::OnCheckBox_E131Click(wxCommandEvent& event)
     {
         CreateE131Listener();
     }
+    StartReceiver();
     ValidateWindow();
 }
 
@@ -1252,64 +1328,168 @@ void xCaptureFrame::OnCheckBox_ArtNETClick(wxCommandEvent& event)
     {
         CreateArtNETListener();
     }
+    StartReceiver();
     ValidateWindow();
 }
 
-void xCaptureFrame::OnE131SocketEvent(wxSocketEvent& event)
+#pragma region Receive Thread
+void xCaptureFrame::StartReceiver()
+{
+    if (_receiver != nullptr) return;
+    if (_e131Socket == nullptr && _artNETSocket == nullptr) return;
+
+    _stopReceiver = false;
+    _receiver = new std::thread(&xCaptureFrame::Receive, this, _e131Socket, _artNETSocket);
+}
+
+void xCaptureFrame::StopReceiver()
+{
+    if (_receiver == nullptr) return;
+
+    _stopReceiver = true;
+    _receiver->join();
+    delete _receiver;
+    _receiver = nullptr;
+
+    // anything already received is still worth keeping
+    DrainRing();
+}
+
+// runs on the receive thread ... only touches the sockets and the ring
+void xCaptureFrame::Receive(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSocket)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    logger_base.debug("Capture receive thread started.");
 
-    wxIPV4address addr;
-    addr.Service(E131PORT);
-    wxByte buf[126+512];
-    switch (event.GetSocketEvent())
-    {
-    case wxSOCKET_INPUT:
+    while (!_stopReceiver)
     {
-        _e131Socket->Notify(false);
-        size_t n = _e131Socket->RecvFrom(addr, buf, sizeof(buf)).LastCount();
-        if (!n) {
-            logger_base.error("ERROR: failed to receive E131 data");
-            return;
+        bool received = false;
+
+#ifdef __LINUX__
+        struct pollfd fds[2];
+        wxDatagramSocket* sockets[2];
+        long types[2];
+        int count = 0;
+        if (e131Socket != nullptr)
+        {
+            fds[count].fd = e131Socket->GetSocket();
+            fds[count].events = POLLIN;
+            fds[count].revents = 0;
+            sockets[count] = e131Socket;
+            types[count++] = ID_E131SOCKET;
+        }
+        if (artNETSocket != nullptr)
+        {
+            fds[count].fd = artNETSocket->GetSocket();
+            fds[count].events = POLLIN;
+            fds[count].revents = 0;
+            sockets[count] = artNETSocket;
+            types[count++] = ID_ARTNETSOCKET;
+        }
+
+        if (poll(fds, count, 100) > 0)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                if ((fds[i].revents & POLLIN) != 0)
+                {
+                    received |= ReceiveBatch(sockets[i], types[i]);
+                }
+            }
+        }
+#else
+        int wait = (e131Socket != nullptr && artNETSocket != nullptr) ? 50 : 100;
+        if (e131Socket != nullptr && e131Socket->WaitForRead(0, wait))
+        {
+            received |= ReceiveBatch(e131Socket, ID_E131SOCKET);
+        }
+        if (artNETSocket != nullptr && artNETSocket->WaitForRead(0, wait))
+        {
+            received |= ReceiveBatch(artNETSocket, ID_ARTNETSOCKET);
+        }
+#endif
+
+        // only one drain queued at a time no matter how fast packets arrive
+        if (received && !_drainPending.exchange(true))
+        {
+            CallAfter(&xCaptureFrame::DrainRing);
         }
-        //logger_base.debug("E131 packet received.");
-        StashPacket(ID_E131SOCKET, buf, n);
-        _e131Socket->Notify(true);
-    }
-        break;
-    default:
-        logger_base.warn("OnE131SocketEvent: Unexpected event !");
-        break;
     }
+
+    logger_base.debug("Capture receive thread stopped. Dropped %ld packets.", _ring.GetDropped());
 }
 
-void xCaptureFrame::OnArtNETSocketEvent(wxSocketEvent & event)
+// reads everything waiting on the socket (up to a batch) straight into ring slots
+bool xCaptureFrame::ReceiveBatch(wxDatagramSocket* socket, long type)
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    CaptureRing::Slot* slots = nullptr;
+    int available = _ring.Reserve(slots, CAPTURE_BATCH);
 
-    wxIPV4address addr;
-    addr.Service(ARTNETPORT);
-    wxByte buf[18 + 512];
-    switch (event.GetSocketEvent())
+    if (available == 0)
+    {
+        // the GUI is not keeping up ... throw the packet away so the socket buffer does not back up
+        wxByte discard[CAPTURE_SLOT_SIZE];
+#ifdef __LINUX__
+        if (recv(socket->GetSocket(), discard, sizeof(discard), MSG_DONTWAIT) <= 0) return false;
+#else
+        wxIPV4address addr;
+        if (socket->RecvFrom(addr, discard, sizeof(discard)).LastCount() == 0) return false;
+#endif
+        _ring.Dropped();
+        return true;
+    }
+
+#ifdef __LINUX__
+    struct mmsghdr msgs[CAPTURE_BATCH];
+    struct iovec iovecs[CAPTURE_BATCH];
+    memset(msgs, 0x00, sizeof(msgs));
+    for (int i = 0; i < available; i++)
     {
-    case wxSOCKET_INPUT:
+        iovecs[i].iov_base = slots[i]._data;
+        iovecs[i].iov_len = CAPTURE_SLOT_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int received = recvmmsg(socket->GetSocket(), msgs, available, MSG_DONTWAIT, nullptr);
+    if (received <= 0) return false;
+
+    wxLongLong now = wxGetUTCTimeMillis();
+    for (int i = 0; i < received; i++)
     {
-        _artNETSocket->Notify(false);
-        size_t n = _artNETSocket->RecvFrom(addr, buf, sizeof(buf)).LastCount();
-        if (!n) {
-            logger_base.error("ERROR: failed to receive ArtNET data");
-            return;
-        }
-        //logger_base.debug("ArtNet packet received.");
-        StashPacket(ID_ARTNETSOCKET, buf, n);
-        _artNETSocket->Notify(true);
+        slots[i]._type = type;
+        slots[i]._length = msgs[i].msg_len;
+        slots[i]._timeStamp = now;
     }
-        break;
-    default:
-        logger_base.warn("OnArtNETSocketEvent: Unexpected event !");
-        break;
+    _ring.Commit(received);
+#else
+    wxIPV4address addr;
+    size_t n = socket->RecvFrom(addr, slots[0]._data, CAPTURE_SLOT_SIZE).LastCount();
+    if (n == 0) return false;
+
+    slots[0]._type = type;
+    slots[0]._length = n;
+    slots[0]._timeStamp = wxGetUTCTimeMillis();
+    _ring.Commit(1);
+#endif
+
+    return true;
+}
+
+// GUI thread ... moves received packets from the ring into the collectors
+void xCaptureFrame::DrainRing()
+{
+    _drainPending = false;
+
+    CaptureRing::Slot* slot = _ring.Peek();
+    while (slot != nullptr)
+    {
+        StashPacket(slot->_type, slot->_data, slot->_length, slot->_timeStamp);
+        _ring.Pop();
+        slot = _ring.Peek();
     }
 }
+#pragma endregion Receive Thread
 
 void xCaptureFrame::OnButton_AddClick(wxCommandEvent& event)
 {
@@ -1345,22 +1525,25 @@ void xCaptureFrame::OnButton_DeleteClick(wxCommandEvent& event)
 
 void xCaptureFrame::OnUITimerTrigger(wxTimerEvent& event)
 {
-    StatusBar1->SetStatusText(wxString::Format("Universes: %d Total Packets: %ld %s", (int)_capturedData.size(), _capturedPackets, _capturedDesc));
+    long missing = 0;
+    for (auto it = _capturedData.begin(); it != _capturedData.end(); ++it)
+    {
+        missing += (*it)->_missing;
+    }
+    StatusBar1->SetStatusText(wxString::Format("Universes: %d Total Packets: %ld Dropped: %ld Missing: %ld %s", (int)_capturedData.size(), _capturedPackets, _ring.GetDropped(), missing, _capturedDesc));
 }
 
 void xCaptureFrame::SaveFSEQ(wxString file, int frameMS, long channelsPerFrame, int frames, wxString& log)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
+    // V2 uncompressed with no sparse ranges so frames can be written as they are assembled
     wxUint8 vMinor = 0;
-    wxUint8 vMajor = 1;
-    wxUint16 fixedHeaderLength = 28;
+    wxUint8 vMajor = 2;
+    wxUint16 fixedHeaderLength = 32;
     wxUint32 stepSize = channelsPerFrame;
     wxUint16 stepTime = frameMS;
-    wxUint16 numUniverses = 0;
-    wxUint16 universeSize = 0;
-    wxUint8 gamma = 1;
-    wxUint8 colorEncoding = 2;
+    wxUint64 uniqueId = wxGetUTCTimeMillis().GetValue();
 
     int overrideFrameMS = 0;
     if (Choice_Timing->GetStringSelection() == "Manual")
@@ -1408,24 +1591,25 @@ void xCaptureFrame::SaveFSEQ(wxString file, int frameMS, long channelsPerFrame,
         buf[16] = (wxUint8)((frames >> 16) & 0xFF);
         buf[17] = (wxUint8)((frames >> 24) & 0xFF);
         // Step time in ms
-        buf[18] = (wxUint8)(stepTime & 0xFF);
-        buf[19] = (wxUint8)((stepTime >> 8) & 0xFF);
-        // universe count
-        buf[20] = (wxUint8)(numUniverses & 0xFF);
-        buf[21] = (wxUint8)((numUniverses >> 8) & 0xFF);
-        // universe Size
-        buf[22] = (wxUint8)(universeSize & 0xFF);
-        buf[23] = (wxUint8)((universeSize >> 8) & 0xFF);
-        // universe Size
-        buf[24] = gamma;
-        // universe Size
-        buf[25] = colorEncoding;
-        buf[26] = 0;
-        buf[27] = 0;
+        buf[18] = (wxUint8)(stepTime > 255 ? 255 : stepTime);
+        // flags
+        buf[19] = 0;
+        // compression type (none) and compression block count
+        buf[20] = 0;
+        buf[21] = 0;
+        // sparse range count
+        buf[22] = 0;
+        buf[23] = 0;
+        // unique id
+        for (int i = 0; i < 8; i++)
+        {
+            buf[24 + i] = (wxUint8)((uniqueId >> (8 * i)) & 0xFF);
+        }
 
         buf[4] = (wxUint8)(fixedHeaderLength % 256);
         buf[5] = (wxUint8)(fixedHeaderLength / 256);
         f.Write(buf, fixedHeaderLength);
+        memset(buf, 0x00, fixedHeaderLength);
 
         for (int i = 0; i < frames; i++)
         {
@@ -1434,7 +1618,7 @@ void xCaptureFrame::SaveFSEQ(wxString file, int frameMS, long channelsPerFrame,
                 PacketData* p = (*it)->GetPacket(i * frameMS);
                 if (p != nullptr)
                 {
-                    memcpy(buf + (*it)->_startChannel - 1, p->_pdata, p->_length);
+                    ReadPacketData(*p, buf + (*it)->_startChannel - 1);
                 }
                 else
                 {
@@ -1464,6 +1648,7 @@ void xCaptureFrame::RestartInterfaces()
     {
         CreateArtNETListener();
     }
+    StartReceiver();
     ValidateWindow();
 }
 
@@ -1554,8 +1739,8 @@ void xCaptureFrame::SaveESEQ(wxString file, int frameMS, long channelsPerFrame,
                 PacketData* p = (*it)->GetPacket(i * frameMS);
                 if (p != nullptr)
                 {
-                    //logger_base.debug("   Adding data uni %d ch %ld time %dms len %d seq %d time %d.%03d", (*it)->_universe, (*it)->_startChannel, p->_frameTimeMS, p->_length, p->_seq, p->_timeStamp.GetSecond(), p->_timeStamp.GetMillisecond());
-                    memcpy(buf + (*it)->_startChannel - 1, p->_pdata, p->_length);
+                    //logger_base.debug("   Adding data uni %d ch %ld time %dms len %d seq %d time %d.%03d", (*it)->_universe, (*it)->_startChannel, p->_frameTimeMS, p->_length, p->_seq, (int)(p->_timeStamp / 1000).ToLong(), (int)(p->_timeStamp % 1000).ToLong());
+                    ReadPacketData(*p, buf + (*it)->_startChannel - 1);
                 }
                 else
                 {
@@ -1594,7 +1779,7 @@ void xCaptureFrame::OnButton_AnalyseClick(wxCommandEvent& event)
     long channelsPerFrame = RoundTo4(GetChannelsPerFrame());
     log += wxString::Format("Channels Per Frame: %ld\n", channelsPerFrame);
 
-    wxDateTime startTime = GetStartTime();
+    wxLongLong startTime = GetStartTime();
 
     int frames = GetFrames();
     log += wxString::Format("Frames: %d\n", frames);
@@ -1606,9 +1791,9 @@ void xCaptureFrame::OnButton_AnalyseClick(wxCommandEvent& event)
 
         log += wxString::Format("Channel %ld, Protocol %s, Universe %d, Size %d, Frames %d, StartFrameMS %dms, EndFrameMS %dms\n",
             (*it)->_startChannel, (*it)->_protocol == ID_E131SOCKET ? "E131" : "ArtNET",
-            (*it)->_universe, (*it)->_packets.size() > 0 ? (*it)->_packets.front()->_length : 0,
-            (int)(*it)->_packets.size(), (*it)->_packets.size() > 0 ? (*it)->_packets.front()->_frameTimeMS : -1,
-            (*it)->_packets.size() > 0 ? (*it)->_packets.back()->_frameTimeMS : -1);
+            (*it)->_universe, (*it)->_packets.size() > 0 ? (*it)->_packets.front()._length : 0,
+            (int)(*it)->_packets.size(), (*it)->_packets.size() > 0 ? (*it)->_packets.front()._frameTimeMS : -1,
+            (*it)->_packets.size() > 0 ? (*it)->_packets.back()._frameTimeMS : -1);
     }
     log += wxString::Format("Channel Structure End!\n");
 
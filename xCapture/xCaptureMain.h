@@ -38,21 +38,33 @@
 
 #include "../xLights/xLightsTimer.h"
 #include <list>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 #include <wx/socket.h>
+#include <wx/file.h>
 
 class wxDebugReportCompress;
 class wxDatagramSocket;
 
+// largest packet we capture is an E1.31 packet with 512 channels (638 bytes)
+#define CAPTURE_SLOT_SIZE 640
+#define CAPTURE_RING_SLOTS 32768
+#define CAPTURE_BATCH 32
+
+// Just the description of a captured packet ... the channel data lives in the capture spill file
 class PacketData
 {
 public:
-    wxDateTime _timeStamp;
-    int _seq;
-    int _length;
-    wxByte* _pdata;
+    wxLongLong _timeStamp; // ms
+    wxFileOffset _offset;
     int _frameTimeMS;
-    virtual ~PacketData() { if (_pdata != nullptr) free(_pdata); }
-    PacketData(long type, wxByte* packet, int len);
+    wxUint16 _length;
+    wxUint8 _seq;
+    PacketData(wxLongLong timeStamp, int seq, int length, wxFileOffset offset) :
+        _timeStamp(timeStamp), _offset(offset), _frameTimeMS(-1), _length(length), _seq(seq) {}
+    static bool Parse(long type, const wxByte* packet, int len, int& seq, int& length, const wxByte*& data);
 };
 
 class Collector
@@ -61,15 +73,63 @@ public:
     int _universe;
     long _protocol;
     long _startChannel; // 1 based start channel
-    std::list<PacketData*> _packets;
-    virtual ~Collector();
-    Collector(long type, int universe) { _startChannel = -1; _universe = universe; _protocol = type; }
-    void AddPacket(long type, wxByte* packet, int len) { _packets.push_back(new PacketData(type, packet, len)); }
-    void CalculateFrames(wxDateTime startTime, int frameMS);
+    long _missing; // gaps in the sequence numbers
+    std::vector<PacketData> _packets;
+    virtual ~Collector() {}
+    Collector(long type, int universe) { _startChannel = -1; _universe = universe; _protocol = type; _missing = 0; }
+    void AddPacket(const PacketData& packet);
+    void CalculateFrames(wxLongLong startTime, int frameMS);
     PacketData* GetPacket(long ms);
     bool operator<(const Collector& c) const;
 };
 
+// Single producer/single consumer ring of preallocated packet slots filled by the receive thread
+class CaptureRing
+{
+public:
+    struct Slot
+    {
+        long _type;
+        int _length;
+        wxLongLong _timeStamp;
+        wxByte _data[CAPTURE_SLOT_SIZE];
+    };
+
+    CaptureRing() : _slots(CAPTURE_RING_SLOTS), _head(0), _tail(0), _dropped(0) {}
+
+    // producer ... up to max contiguous free slots starting at first
+    int Reserve(Slot*& first, int max)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        size_t free = CAPTURE_RING_SLOTS - (head - tail);
+        size_t index = head % CAPTURE_RING_SLOTS;
+        size_t contiguous = std::min(free, (size_t)CAPTURE_RING_SLOTS - index);
+        first = &_slots[index];
+        return (int)std::min(contiguous, (size_t)max);
+    }
+    void Commit(int count) { _head.fetch_add(count, std::memory_order_release); }
+    void Dropped() { _dropped++; }
+
+    // consumer
+    Slot* Peek()
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return nullptr;
+        return &_slots[tail % CAPTURE_RING_SLOTS];
+    }
+    void Pop() { _tail.fetch_add(1, std::memory_order_release); }
+
+    long GetDropped() const { return _dropped; }
+    void ResetDropped() { _dropped = 0; }
+
+private:
+    std::vector<Slot> _slots;
+    std::atomic<size_t> _head;
+    std::atomic<size_t> _tail;
+    std::atomic<long> _dropped;
+};
+
 class xCaptureFrame : public wxFrame
 {
     void ValidateWindow();
@@ -83,17 +143,34 @@ class xCaptureFrame : public wxFrame
     wxString _localIP;
     wxString _defaultIP;
 
+    CaptureRing _ring;
+    std::thread* _receiver;
+    std::atomic<bool> _stopReceiver;
+    std::atomic<bool> _drainPending;
+    wxFile _spill;
+    wxString _spillFile;
+    wxFileOffset _spillSize;
+    std::vector<wxByte> _spillBuffer;
+
     void RestartInterfaces();
+    void StartReceiver();
+    void StopReceiver();
+    void Receive(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSocket);
+    bool ReceiveBatch(wxDatagramSocket* socket, long type);
+    void DrainRing();
+    void ResetSpill();
+    wxFileOffset SpillPacketData(const wxByte* data, int length);
+    bool ReadPacketData(const PacketData& p, wxByte* buffer);
     void CloseSockets(bool force = false);
     void CreateE131Listener();
     void CreateArtNETListener();
     void AddUniverseRange(int low, int high);
     void PurgeCollectedData();
-    void StashPacket(long type, wxByte* packet, int len);
+    void StashPacket(long type, wxByte* packet, int len, wxLongLong timeStamp);
     bool IsUniverseToBeCaptured(int universe, bool ignoreall = false);
     int GuessFrameMS();
     long GetChannelsPerFrame();
-    wxDateTime GetStartTime();
+    wxLongLong GetStartTime();
     void SaveFSEQ(wxString file, int frameMS, long channelsPerFrame, int frames, wxString& log);
     void SaveESEQ(wxString file, int frameMS, long channelsPerFrame, int frames, wxString& log);
     int GetFrames();
@@ -207,9 +284,6 @@ private:
         //*)
 
         DECLARE_EVENT_TABLE()
-
-        void OnE131SocketEvent(wxSocketEvent& event);
-        void OnArtNETSocketEvent(wxSocketEvent& event);
 };
 
 #endif // xCAPTUREMAIN_H
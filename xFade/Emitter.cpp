@@ -35,27 +35,31 @@ public:
         _stop = true;
     }
     
-    void Blend(wxByte* buffer, wxByte* blendBuffer, size_t channels, float pos, std::list<int> excludeChannels)
+    // straight fixed point lerp over the whole universe so it vectorises ... excluded channels are snapped
+    // to whichever side is closer afterwards
+    void Blend(wxByte* buffer, wxByte* blendBuffer, size_t channels, float pos, const std::list<int>& excludeChannels)
     {
-        float inv = 1.0 - pos;
-        for (size_t i = 0; i < channels; ++i)
+        std::vector<std::pair<size_t, wxByte>> excluded;
+        for (auto it = excludeChannels.begin(); it != excludeChannels.end(); ++it)
         {
-            if (std::find(excludeChannels.begin(), excludeChannels.end(), i+1) != excludeChannels.end())
-            {
-                if (pos < 0.5)
-                {
-                    // dont change anything
-                }
-                else
-                {
-                    *(buffer + i) = *(blendBuffer + i);
-                }
-            }
-            else
+            if (*it >= 1 && (size_t)*it <= channels)
             {
-                *(buffer + i) = (wxByte)((float)*(buffer + i) * inv + (float)*(blendBuffer + i) * pos);
+                size_t i = *it - 1;
+                excluded.push_back({ i, pos < 0.5 ? buffer[i] : blendBuffer[i] });
             }
         }
+
+        wxUint32 weight = (wxUint32)(pos * 256.0f + 0.5f);
+        wxUint32 inv = 256 - weight;
+        for (size_t i = 0; i < channels; ++i)
+        {
+            buffer[i] = (wxByte)((buffer[i] * inv + blendBuffer[i] * weight) >> 8);
+        }
+
+        for (auto it = excluded.begin(); it != excluded.end(); ++it)
+        {
+            buffer[it->first] = it->second;
+        }
     }
 
     void PrepareData(PacketData* target, PacketData* source, long protocol)
@@ -80,6 +84,10 @@ public:
         PacketData sendData;
         sendData.SetLocalIP(_emitter->GetLocalIP());
 
+        // reused every frame so the universes are copied straight out of the stores
+        PacketData l;
+        PacketData r;
+
         while (!_stop)
         {
             auto start = wxDateTime::UNow();
@@ -89,12 +97,17 @@ public:
                 // output the frames now
                 auto ips = _emitter->GetIps();
 
+                // the same fade position and brightness applies to every universe in the frame
+                float pos = _emitter->GetPos();
+                int leftBrightness = _emitter->GetLeftBrightness();
+                int rightBrightness = _emitter->GetRightBrightness();
+
                 for (auto it = ips.begin(); it != ips.end(); ++it)
                 {
                     std::list<int> excludeChannels = _emitter->GetSettings()->GetExcludeChannels(it->first);
 
-                    auto l = _emitter->GetLeft(it->first);
-                    auto r = _emitter->GetRight(it->first);
+                    _emitter->GetLeft(it->first, l);
+                    _emitter->GetRight(it->first, r);
 
                     if (l._length == 0 && r._length > 0)
                     {
@@ -107,24 +120,22 @@ public:
 
                     auto protocol = _emitter->GetProtocol(it->first);
 
-                    float pos = _emitter->GetPos();
-
                     if (pos == 0.0)
                     {
                         PrepareData(&sendData, &l, protocol);
-                        sendData.ApplyBrightness(_emitter->GetLeftBrightness(), excludeChannels);
+                        sendData.ApplyBrightness(leftBrightness, excludeChannels);
                     }
                     else if (pos == 1.0)
                     {
                         PrepareData(&sendData, &r, protocol);
-                        sendData.ApplyBrightness(_emitter->GetRightBrightness(), excludeChannels);
+                        sendData.ApplyBrightness(rightBrightness, excludeChannels);
                     }
                     else
                     {
                         int sz = std::min(l.GetDataLength(), r.GetDataLength());
 
-                        l.ApplyBrightness(_emitter->GetLeftBrightness(), excludeChannels);
-                        r.ApplyBrightness(_emitter->GetRightBrightness(), excludeChannels);
+                        l.ApplyBrightness(leftBrightness, excludeChannels);
+                        r.ApplyBrightness(rightBrightness, excludeChannels);
 
                         Blend(l.GetDataPtr(), r.GetDataPtr(), sz, pos, excludeChannels);
                         PrepareData(&sendData, &l, protocol);
@@ -148,7 +159,7 @@ public:
     }
 };
 
-Emitter::Emitter(std::map<int, std::string>* ip, std::map<int, PacketData>* left, std::map<int, PacketData>* right, std::map<int, std::string>* protocol, std::mutex* lock, std::string localIP, Settings* settings)
+Emitter::Emitter(std::map<int, std::string>* ip, UniverseStore* left, UniverseStore* right, std::map<int, std::string>* protocol, std::mutex* lock, std::string localIP, Settings* settings)
 {
     _settings = settings;
     _sent = 0;
@@ -220,38 +231,6 @@ std::map<int, std::string> Emitter::GetIps() const
     return res;
 }
 
-PacketData Emitter::GetLeft(int u) const
-{
-    std::unique_lock<std::mutex> mutLock(*_lock);
-
-    if (!_stop)
-    {
-        if (_leftData->find(u) != _leftData->end())
-        {
-            PacketData d((*_leftData)[u]);
-            return d;
-        }
-    }
-
-    return PacketData();
-}
-
-PacketData Emitter::GetRight(int u) const
-{
-    std::unique_lock<std::mutex> mutLock(*_lock);
-
-    if (!_stop)
-    {
-        if (_rightData->find(u) != _rightData->end())
-        {
-            PacketData d((*_rightData)[u]);
-            return d;
-        }
-    }
-
-    return PacketData();
-}
-
 long Emitter::GetProtocol(int u) const
 {
     std::unique_lock<std::mutex> mutLock(*_lock);
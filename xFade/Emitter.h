@@ -19,8 +19,8 @@ class Emitter
     EmitterThread* _emitterThread;
     std::map<int, std::string>* _targetIP;
     std::map<int, std::string>* _protocol;
-    std::map<int, PacketData>* _leftData;
-    std::map<int, PacketData>* _rightData;
+    UniverseStore* _leftData;
+    UniverseStore* _rightData;
     int _frameMS;
     float _pos;
     bool _stop;
@@ -32,7 +32,7 @@ class Emitter
 
     public:
 
-	Emitter(std::map<int, std::string>* ip, std::map<int, PacketData>* left, std::map<int, PacketData>* right, std::map<int, std::string>* protocol, std::mutex* mutex, std::string localIP, Settings* settings);
+	Emitter(std::map<int, std::string>* ip, UniverseStore* left, UniverseStore* right, std::map<int, std::string>* protocol, std::mutex* mutex, std::string localIP, Settings* settings);
 	virtual ~Emitter();
     void Stop();
     void Restart();
@@ -41,8 +41,8 @@ class Emitter
     void SetFrameMS(int ms) { std::unique_lock<std::mutex> mutLock(*_lock); _frameMS = ms; }
     void SetPos(float pos) { std::unique_lock<std::mutex> mutLock(*_lock); _pos = pos; }
     std::map<int, std::string> GetIps() const;
-    PacketData GetLeft(int u) const;
-    PacketData GetRight(int u) const;
+    bool GetLeft(int u, PacketData& target) const { return _leftData->Read(u, target); }
+    bool GetRight(int u, PacketData& target) const { return _rightData->Read(u, target); }
     long GetProtocol(int u) const;
     std::string GetLocalIP() const { return _localIP; }
     void SetLocalIP(std::string localIP) { _localIP = localIP; }
@@ -3,6 +3,8 @@
 
 #include <wx/wx.h>
 #include <map>
+#include <atomic>
+#include <vector>
 
 #define ARTNET_PACKET_HEADERLEN 18
 #define ARTNET_PACKET_LEN (ARTNET_PACKET_HEADERLEN + 512)
@@ -25,7 +27,6 @@ public:
     wxByte GetData(int c);
     wxByte* GetDataPtr();
     void SetData(int c, wxByte dd);
-    bool Update(long type, wxByte* packet, int len);
     void Send(std::string ip) const;
     int GetDataLength() const;
     wxByte UniverseHigh() const { return (_universe >> 8) & 0xFF; }
@@ -40,4 +41,42 @@ public:
     void ApplyBrightness(int brightness, std::list<int> excludeChannels);
 };
 
+#define MAX_UNIVERSES 65536
+
+// Latest packet received for each universe, indexed directly by universe number.
+// Written only by the socket handlers and read only by the emitter thread. Each universe is double buffered and
+// versioned so the writer never waits on the reader and the reader simply retries if it was overtaken mid copy.
+class UniverseStore
+{
+    struct Slot
+    {
+        struct Buffer
+        {
+            long _type;
+            int _length;
+            wxByte _data[E131_PACKET_LEN];
+        };
+        std::atomic<unsigned int> _started;
+        std::atomic<unsigned int> _version;
+        Buffer _buffers[2];
+        Slot() : _started(0), _version(0) { memset(_buffers, 0x00, sizeof(_buffers)); }
+    };
+
+    std::vector<std::atomic<Slot*>> _slots;
+    int _firstUniverse;
+
+public:
+
+    UniverseStore();
+    virtual ~UniverseStore();
+
+    // writer side
+    bool Write(long type, const wxByte* packet, int len, int universe);
+    int GetSequenceNum(int universe) const;
+    int GetFirstUniverse() const { return _firstUniverse; }
+
+    // reader side ... leaves target empty if nothing has been received for the universe
+    bool Read(int universe, PacketData& target) const;
+};
+
 #endif 
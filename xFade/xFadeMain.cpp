@@ -140,44 +140,41 @@ void xFadeFrame::StashPacket(long type, wxByte* packet, int len)
 
     if (!IsUniverseToBeCaptured(universe)) return;
 
+    // no lock needed ... the stores are safe to write while the emitter is reading
+    if (left)
     {
-        std::unique_lock<std::mutex> mutLock(_lock);
-
-        if (left)
+        if (!_leftData.Write(type, packet, len, universe))
         {
-            if (!_leftData[universe].Update(type, packet, len))
-            {
-                logger_base.debug("Invalid packet.");
-            }
-            else
+            logger_base.debug("Invalid packet.");
+        }
+        else
+        {
+            _leftReceived++;
+            // only flash the LED based on receipt of data for the first universe
+            if (universe == _leftData.GetFirstUniverse())
             {
-                _leftReceived++;
-                // only flash the LED based on receipt of data for the first universe
-                if (universe == _leftData.begin()->second._universe)
+                if (_leftData.GetSequenceNum(universe) % 10 == 0)
                 {
-                    if (_leftData[universe].GetSequenceNum() % 10 == 0)
-                    {
-                        Led_Left->Enable(!Led_Left->IsEnabled());
-                    }
+                    Led_Left->Enable(!Led_Left->IsEnabled());
                 }
             }
         }
-        else if (right)
+    }
+    else if (right)
+    {
+        if (!_rightData.Write(type, packet, len, universe))
         {
-            if (!_rightData[universe].Update(type, packet, len))
-            {
-                logger_base.debug("Invalid packet.");
-            }
-            else
+            logger_base.debug("Invalid packet.");
+        }
+        else
+        {
+            _rightReceived++;
+            // only flash the LED based on receipt of data for the first universe
+            if (universe == _rightData.GetFirstUniverse())
             {
-                _rightReceived++;
-                // only flash the LED based on receipt of data for the first universe
-                if (universe == _rightData.begin()->second._universe)
+                if (_rightData.GetSequenceNum(universe) % 10 == 0)
                 {
-                    if (_rightData[universe].GetSequenceNum() % 10 == 0)
-                    {
-                        Led_Right->Enable(!Led_Right->IsEnabled());
-                    }
+                    Led_Right->Enable(!Led_Right->IsEnabled());
                 }
             }
         }
@@ -692,49 +689,6 @@ void PacketData::SetData(int c, wxByte dd)
     }
 }
 
-bool PacketData::Update(long type, wxByte* packet, int len)
-{
-    if (type == xFadeFrame::ID_E131SOCKET)
-    {
-        // validate the packet
-        if (len < E131_PACKET_HEADERLEN) return false;
-        if (packet[4] != 0x41) return false;
-        if (packet[5] != 0x53) return false;
-        if (packet[6] != 0x43) return false;
-        if (packet[7] != 0x2d) return false;
-        if (packet[8] != 0x45) return false;
-        if (packet[9] != 0x31) return false;
-        if (packet[10] != 0x2e) return false;
-        if (packet[11] != 0x31) return false;
-        if (packet[12] != 0x37) return false;
-
-        _universe = ((int)_data[113] << 8) + (int)_data[114];
-        _type = type;
-        _length = len;
-        memcpy(_data, packet, len);
-    }
-    else if (type == xFadeFrame::ID_ARTNETSOCKET)
-    {
-        // validate the packet
-        if (len < ARTNET_PACKET_HEADERLEN) return false;
-        if (packet[0] != 'A') return false;
-        if (packet[1] != 'r') return false;
-        if (packet[2] != 't') return false;
-        if (packet[3] != '-') return false;
-        if (packet[4] != 'N') return false;
-        if (packet[5] != 'e') return false;
-        if (packet[6] != 't') return false;
-        if (packet[9] != 0x50) return true; // pretend success as otherwise I will log excessively
-
-        _universe = ((int)_data[15] << 8) + (int)_data[14];
-        _type = type;
-        _length = len;
-        memcpy(_data, packet, len);
-    }
-
-    return true;
-}
-
 void PacketData::Send(std::string ip) const
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -999,7 +953,7 @@ void PacketData::CopyFrom(PacketData* source, long targetType)
 
     if (source->_type == targetType)
     {
-        memcpy(_data, source->_data, sizeof(_data));
+        memcpy(_data, source->_data, source->_length);
         _length = source->_length;
 
         if (_type == xFadeFrame::ID_E131SOCKET)
@@ -1037,6 +991,136 @@ void PacketData::CopyFrom(PacketData* source, long targetType)
     }
 }
 
+#pragma region Universe Store
+UniverseStore::UniverseStore() : _slots(MAX_UNIVERSES), _firstUniverse(-1)
+{
+}
+
+UniverseStore::~UniverseStore()
+{
+    for (auto& it : _slots)
+    {
+        delete it.load();
+    }
+}
+
+bool UniverseStore::Write(long type, const wxByte* packet, int len, int universe)
+{
+    if (type == xFadeFrame::ID_E131SOCKET)
+    {
+        // validate the packet
+        if (len < E131_PACKET_HEADERLEN) return false;
+        if (packet[4] != 0x41) return false;
+        if (packet[5] != 0x53) return false;
+        if (packet[6] != 0x43) return false;
+        if (packet[7] != 0x2d) return false;
+        if (packet[8] != 0x45) return false;
+        if (packet[9] != 0x31) return false;
+        if (packet[10] != 0x2e) return false;
+        if (packet[11] != 0x31) return false;
+        if (packet[12] != 0x37) return false;
+    }
+    else if (type == xFadeFrame::ID_ARTNETSOCKET)
+    {
+        // validate the packet
+        if (len < ARTNET_PACKET_HEADERLEN) return false;
+        if (packet[0] != 'A') return false;
+        if (packet[1] != 'r') return false;
+        if (packet[2] != 't') return false;
+        if (packet[3] != '-') return false;
+        if (packet[4] != 'N') return false;
+        if (packet[5] != 'e') return false;
+        if (packet[6] != 't') return false;
+        if (packet[9] != 0x50) return true; // pretend success as otherwise I will log excessively
+    }
+    else
+    {
+        return true;
+    }
+
+    if (universe < 0 || universe >= MAX_UNIVERSES || len > E131_PACKET_LEN) return false;
+
+    Slot* slot = _slots[universe].load(std::memory_order_relaxed);
+    if (slot == nullptr)
+    {
+        slot = new Slot();
+        _slots[universe].store(slot, std::memory_order_release);
+        if (_firstUniverse == -1 || universe < _firstUniverse) _firstUniverse = universe;
+    }
+
+    // announce which buffer is about to be overwritten before touching it
+    unsigned int version = slot->_version.load(std::memory_order_relaxed) + 1;
+    slot->_started.store(version, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& buffer = slot->_buffers[version & 1];
+    buffer._type = type;
+    buffer._length = len;
+    memcpy(buffer._data, packet, len);
+
+    slot->_version.store(version, std::memory_order_release);
+    return true;
+}
+
+int UniverseStore::GetSequenceNum(int universe) const
+{
+    if (universe < 0 || universe >= MAX_UNIVERSES) return -1;
+    Slot* slot = _slots[universe].load(std::memory_order_relaxed);
+    if (slot == nullptr) return -1;
+
+    auto& buffer = slot->_buffers[slot->_version.load(std::memory_order_relaxed) & 1];
+    if (buffer._type == xFadeFrame::ID_E131SOCKET)
+    {
+        return (int)buffer._data[111];
+    }
+    else if (buffer._type == xFadeFrame::ID_ARTNETSOCKET)
+    {
+        return (int)buffer._data[12];
+    }
+    return -1;
+}
+
+bool UniverseStore::Read(int universe, PacketData& target) const
+{
+    Slot* slot = nullptr;
+    if (universe >= 0 && universe < MAX_UNIVERSES)
+    {
+        slot = _slots[universe].load(std::memory_order_acquire);
+    }
+    unsigned int version = slot == nullptr ? 0 : slot->_version.load(std::memory_order_acquire);
+
+    if (version == 0)
+    {
+        memset(target._data, 0x00, sizeof(target._data));
+        target._type = 0;
+        target._length = 0;
+        target._universe = 0;
+        return false;
+    }
+
+    for (;;)
+    {
+        auto& buffer = slot->_buffers[version & 1];
+        long type = buffer._type;
+        int length = std::max(0, std::min(buffer._length, (int)sizeof(buffer._data)));
+        memcpy(target._data, buffer._data, length);
+
+        // if the writer has not started on this buffer again the copy is good
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->_started.load(std::memory_order_relaxed) - version < 2)
+        {
+            target._type = type;
+            target._length = length;
+            break;
+        }
+        version = slot->_version.load(std::memory_order_acquire);
+    }
+
+    target._universe = universe;
+    return true;
+}
+#pragma endregion Universe Store
+
 void xFadeFrame::CreateE131Listener()
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -57,8 +57,8 @@ class xFadeFrame : public wxFrame
     void ValidateWindow();
     void AddFadeTimeButton(std::string label);
 
-    std::map<int, PacketData> _leftData;
-    std::map<int, PacketData> _rightData;
+    UniverseStore _leftData;
+    UniverseStore _rightData;
     unsigned long _leftReceived;
     unsigned long _rightReceived;
     bool _suspendListen;
@@ -2,9 +2,13 @@
 #include <wx/string.h>
 #include <wx/ffile.h>
 #include <wx/log.h>
+#include <wx/file.h>
+#include <wx/filename.h>
 
 #include <sstream>
 #include <algorithm>
+#include <memory>
+#include <chrono>
 
 #include <math.h>
 #include <stdlib.h>
@@ -1122,6 +1126,23 @@ void AudioManager::SetLoadedData(long pos)
 {
     std::unique_lock<std::shared_timed_mutex> locker(_mutexAudioLoad);
     _loadedData = pos;
+    _loadedDataSignal.notify_all();
+}
+
+// Block until the audio is loaded up to pos (or completely if pos is -1). Wakes as soon as the
+// loader publishes more data, the timeout covers loads that give up and shorten the track instead
+void AudioManager::WaitForDataLoaded(long pos)
+{
+    std::unique_lock<std::shared_timed_mutex> locker(_mutexAudioLoad);
+    auto loaded = [this, pos]() { return pos < 0 ? _loadedData == _trackSize : _loadedData >= std::min(pos, _trackSize); };
+    if (loaded()) return;
+
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    logger_base.debug("Waiting for audio data to be loaded to %ld.", pos);
+    while (!loaded())
+    {
+        _loadedDataSignal.wait_for(locker, std::chrono::milliseconds(100));
+    }
 }
 
 bool AudioManager::IsDataLoaded(long pos)
@@ -1150,6 +1171,7 @@ AudioManager::AudioManager(const std::string& audio_file, int step, int block)
 	_job = nullptr;
     _jobAudioLoad = nullptr;
     _loadedData = 0;
+    _leftMinMaxReady = false;
 	_audio_file = audio_file;
 	_state = -1; // state uninitialised. 0 is error. 1 is loaded ok
 	_resultMessage = "";
@@ -1259,6 +1281,286 @@ std::list<float> AudioManager::CalculateSpectrumAnalysis(const float* in, int n,
 	return res;
 }
 
+// VAMP results are cached on disk keyed by the audio, the plugin and everything that affects its output
+#define VAMP_CACHE_MAGIC 0x43564C58 // XLVC
+#define VAMP_CACHE_VERSION 1
+
+class VampPluginJob : Job
+{
+    AudioManager* _audio;
+    xLightsVamp::PluginRun& _run;
+    std::mutex& _lock;
+    std::condition_variable& _signal;
+    int& _running;
+
+public:
+    std::atomic<long> _processed;
+
+    VampPluginJob(AudioManager* audio, xLightsVamp::PluginRun& run, std::mutex& lock, std::condition_variable& signal, int& running) :
+        _audio(audio), _run(run), _lock(lock), _signal(signal), _running(running), _processed(0) {}
+    virtual ~VampPluginJob() {};
+    virtual void Process() override
+    {
+        Run();
+        std::unique_lock<std::mutex> locker(_lock);
+        _running--;
+        _signal.notify_all();
+    }
+    virtual const std::string GetName() const override { return "VampPlugin"; }
+
+    void Run()
+    {
+        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        Vamp::Plugin* p = _run.Plugin;
+        p->initialise(_run.Channels, _run.Step, _run.Block);
+
+        float *pdata[2];
+        long len = _audio->GetTrackSize();
+        long start = 0;
+        while (len)
+        {
+            pdata[0] = _audio->GetLeftDataPtr(start);
+            pdata[1] = _audio->GetRightDataPtr(start);
+
+            Vamp::RealTime timestamp = Vamp::RealTime::frame2RealTime(start, _audio->GetRate());
+            Vamp::Plugin::FeatureSet features = p->process(pdata, timestamp);
+            auto& output = features[_run.Output];
+            _run.Features.insert(_run.Features.end(), output.begin(), output.end());
+
+            if (len > (long)_run.Step)
+            {
+                len -= _run.Step;
+            }
+            else
+            {
+                len = 0;
+            }
+            start += _run.Step;
+            _processed = start;
+        }
+
+        try
+        {
+            Vamp::Plugin::FeatureSet features = p->getRemainingFeatures();
+            auto& output = features[_run.Output];
+            _run.Features.insert(_run.Features.end(), output.begin(), output.end());
+        }
+        catch (...)
+        {
+            logger_base.warn("VampPluginJob: %s threw an error getting the remaining features.", (const char*)p->getName().c_str());
+        }
+        _processed = _audio->GetTrackSize();
+    }
+};
+
+std::string AudioManager::VampCacheKey(const xLightsVamp::PluginRun& run)
+{
+    std::ostringstream key;
+    key << Hash() << "|" << _rate << "|" << run.Plugin->getIdentifier() << "|" << run.Plugin->getPluginVersion()
+        << "|" << run.Output << "|" << run.Step << "|" << run.Block << "|" << run.Channels;
+    for (const auto& it : run.Plugin->getParameterDescriptors())
+    {
+        key << "|" << it.identifier << "=" << run.Plugin->getParameter(it.identifier);
+    }
+    return key.str();
+}
+
+static wxString VampCacheFile(const std::string& key)
+{
+    MD5 md5;
+    md5.update((unsigned char *)key.c_str(), key.size());
+    md5.finalize();
+    return wxFileName(wxFileName::GetTempDir() + wxFileName::GetPathSeparator() + "xLightsVampCache", md5.hexdigest() + ".vamp").GetFullPath();
+}
+
+template<typename T> static bool VampCacheRead(wxFile& f, T& v)
+{
+    return f.Read(&v, sizeof(T)) == sizeof(T);
+}
+
+static bool VampCacheRead(wxFile& f, std::string& s)
+{
+    uint32_t len = 0;
+    if (!VampCacheRead(f, len) || len > 1024 * 1024) return false;
+    s.resize(len);
+    return len == 0 || f.Read(&s[0], len) == len;
+}
+
+bool AudioManager::LoadVampCache(const std::string& key, Vamp::Plugin::FeatureList& features) const
+{
+    wxString filename = VampCacheFile(key);
+    if (!wxFile::Exists(filename)) return false;
+
+    wxFile f;
+    if (!f.Open(filename)) return false;
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    std::string fileKey;
+    uint32_t count = 0;
+    if (!VampCacheRead(f, magic) || magic != VAMP_CACHE_MAGIC ||
+        !VampCacheRead(f, version) || version != VAMP_CACHE_VERSION ||
+        !VampCacheRead(f, fileKey) || fileKey != key ||
+        !VampCacheRead(f, count))
+    {
+        return false;
+    }
+
+    Vamp::Plugin::FeatureList res;
+    res.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Vamp::Plugin::Feature feature;
+        uint8_t hasTimestamp = 0;
+        uint8_t hasDuration = 0;
+        uint32_t values = 0;
+        if (!VampCacheRead(f, hasTimestamp) || !VampCacheRead(f, feature.timestamp.sec) || !VampCacheRead(f, feature.timestamp.nsec) ||
+            !VampCacheRead(f, hasDuration) || !VampCacheRead(f, feature.duration.sec) || !VampCacheRead(f, feature.duration.nsec) ||
+            !VampCacheRead(f, values) || values > 1024 * 1024)
+        {
+            return false;
+        }
+        feature.hasTimestamp = hasTimestamp != 0;
+        feature.hasDuration = hasDuration != 0;
+        feature.values.resize(values);
+        if ((values > 0 && f.Read(&feature.values[0], values * sizeof(float)) != values * sizeof(float)) || !VampCacheRead(f, feature.label))
+        {
+            return false;
+        }
+        res.push_back(feature);
+    }
+    features = res;
+    return true;
+}
+
+void AudioManager::SaveVampCache(const std::string& key, const Vamp::Plugin::FeatureList& features) const
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    wxString filename = VampCacheFile(key);
+    wxFileName dir(filename);
+    if (!wxDirExists(dir.GetPath()) && !wxMkdir(dir.GetPath()))
+    {
+        logger_base.warn("Unable to create VAMP cache folder %s.", (const char*)dir.GetPath().c_str());
+        return;
+    }
+
+    std::vector<uint8_t> buffer;
+    auto append = [&buffer](const void* data, size_t size) {
+        buffer.insert(buffer.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+    };
+    auto appendString = [&append](const std::string& s) {
+        uint32_t len = s.size();
+        append(&len, sizeof(len));
+        append(s.c_str(), len);
+    };
+    uint32_t magic = VAMP_CACHE_MAGIC;
+    uint32_t version = VAMP_CACHE_VERSION;
+    uint32_t count = features.size();
+    append(&magic, sizeof(magic));
+    append(&version, sizeof(version));
+    appendString(key);
+    append(&count, sizeof(count));
+    for (const auto& it : features)
+    {
+        uint8_t hasTimestamp = it.hasTimestamp ? 1 : 0;
+        uint8_t hasDuration = it.hasDuration ? 1 : 0;
+        uint32_t values = it.values.size();
+        append(&hasTimestamp, sizeof(hasTimestamp));
+        append(&it.timestamp.sec, sizeof(it.timestamp.sec));
+        append(&it.timestamp.nsec, sizeof(it.timestamp.nsec));
+        append(&hasDuration, sizeof(hasDuration));
+        append(&it.duration.sec, sizeof(it.duration.sec));
+        append(&it.duration.nsec, sizeof(it.duration.nsec));
+        append(&values, sizeof(values));
+        if (values > 0) append(&it.values[0], values * sizeof(float));
+        appendString(it.label);
+    }
+
+    // write it somewhere else first so a reader never sees a partial file
+    wxString tempFile = filename + ".tmp";
+    wxFile f;
+    if (!f.Create(tempFile, true) || f.Write(buffer.data(), buffer.size()) != buffer.size())
+    {
+        logger_base.warn("Unable to write VAMP cache file %s.", (const char*)tempFile.c_str());
+        return;
+    }
+    f.Close();
+    wxRenameFile(tempFile, filename, true);
+}
+
+// Run a set of plugins over the whole track. Results come from the disk cache where possible, the
+// remaining plugins each run on their own job in the pool reading the shared in memory audio and
+// progress is reported on the calling thread as the slowest of them.
+void AudioManager::RunVampPlugins(std::vector<xLightsVamp::PluginRun>& runs, std::function<void(int)> progress)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    WaitForDataLoaded();
+
+    std::mutex lock;
+    std::condition_variable signal;
+    int running = 0;
+    std::vector<std::unique_ptr<VampPluginJob>> jobs;
+    std::vector<xLightsVamp::PluginRun*> pending;
+    std::vector<std::string> keys;
+    for (auto& run : runs)
+    {
+        run.Features.clear();
+        std::string key = VampCacheKey(run);
+        if (LoadVampCache(key, run.Features))
+        {
+            logger_base.debug("RunVampPlugins: Using cached results for %s.", (const char*)run.Plugin->getName().c_str());
+            continue;
+        }
+        jobs.push_back(std::make_unique<VampPluginJob>(this, run, lock, signal, running));
+        pending.push_back(&run);
+        keys.push_back(key);
+    }
+    if (jobs.empty())
+    {
+        progress(100);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> locker(lock);
+        running = jobs.size();
+    }
+    for (auto& job : jobs)
+    {
+        _jobPool.PushJob((Job*)job.get());
+    }
+
+    long total = std::max(GetTrackSize(), 1L);
+    int lastProgress = -1;
+    std::unique_lock<std::mutex> locker(lock);
+    while (running > 0)
+    {
+        signal.wait_for(locker, std::chrono::milliseconds(100));
+        long done = total;
+        for (const auto& job : jobs)
+        {
+            done = std::min(done, (long)job->_processed);
+        }
+        int pct = (int)(((float)done * 100) / total);
+        if (pct != lastProgress && running > 0)
+        {
+            locker.unlock();
+            progress(pct);
+            locker.lock();
+            lastProgress = pct;
+        }
+    }
+    locker.unlock();
+
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        SaveVampCache(keys[i], pending[i]->Features);
+    }
+    progress(100);
+}
+
 void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManagerProgressCallback fn)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -1273,11 +1575,7 @@ void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManager
 
     logger_base.info("DoPolyphonicTranscription: Polyphonic transcription started on file " + _audio_file);
 
-    while (!IsDataLoaded())
-    {
-        logger_base.debug("DoPolyphonicTranscription: Waiting for audio data to load.");
-        wxMilliSleep(100);
-    }
+    WaitForDataLoaded();
 
     static log4cpp::Category &logger_pianodata = log4cpp::Category::getInstance(std::string("log_pianodata"));
     logger_pianodata.debug("Processing polyphonic transcription on file " + _audio_file);
@@ -1294,119 +1592,70 @@ void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManager
     }
     else
     {
-        float *pdata[2];
-        long frames = _lengthMS / _intervalMS;
-        while (frames * _intervalMS < _lengthMS)
-        {
-            frames++;
+        std::vector<xLightsVamp::PluginRun> runs(1);
+        xLightsVamp::PluginRun& run = runs[0];
+        run.Plugin = pt;
+        run.Step = pt->getPreferredStepSize();
+        run.Block = pt->getPreferredBlockSize();
+        run.Channels = GetChannels();
+        if (run.Channels > (int)pt->getMaxChannelCount()) {
+            run.Channels = 1;
         }
 
-        size_t pref_step = pt->getPreferredStepSize();
-        size_t pref_block = pt->getPreferredBlockSize();
+        logger_pianodata.debug("Channels %d.", GetChannels());
+        logger_pianodata.debug("Step %d.", run.Step);
+        logger_pianodata.debug("Block %d.", run.Block);
 
-        int channels = GetChannels();
-        if (channels > (int)pt->getMaxChannelCount()) {
-            channels = 1;
-        }
+        RunVampPlugins(runs, [dlg, fn](int pct) { fn(dlg, pct / 4); });
 
-        logger_pianodata.debug("Channels %d.", GetChannels());
-        logger_pianodata.debug("Step %d.", pref_step);
-        logger_pianodata.debug("Block %d.", pref_block);
-        pt->initialise(channels, pref_step, pref_block);
-
-        bool first = true;
-        int start = 0;
-        long len = GetTrackSize();
-        float totalLen = len;
-        int lastProgress = 0;
-        while (len)
+        // Process the Polyphonic Transcription
+        unsigned int total = 0;
+        Vamp::Plugin::FeatureList& features = run.Features;
+        logger_pianodata.debug("Polyphonic Transcription result retrieved.");
+        logger_pianodata.debug("Start,Duration,CalcStart,CalcEnd,midinote");
+        for (size_t j = 0; j < features.size(); j++)
         {
-            int progress = (((float)(totalLen - len) * 25) / totalLen);
-            if (lastProgress < progress)
+            if (j % 10 == 0)
             {
-                fn(dlg, progress);
-                lastProgress = progress;
+                fn(dlg, (int)(((float)j * 75.0) / (float)features.size()) + 25.0);
             }
-            pdata[0] = GetLeftDataPtr(start);
-            pdata[1] = GetRightDataPtr(start);
 
-            Vamp::RealTime timestamp = Vamp::RealTime::frame2RealTime(start, GetRate());
-            Vamp::Plugin::FeatureSet features = pt->process(pdata, timestamp);
+            long currentstart = features[j].timestamp.sec * 1000 + features[j].timestamp.msec();
+            long currentend = currentstart + features[j].duration.sec * 1000 + features[j].duration.msec();
 
-            if (first && features.size() > 0)
+            if (logger_pianodata.isDebugEnabled())
             {
-                logger_base.warn("DoPolyphonicTranscription: Polyphonic transcription data process oddly retrieved data.");
-                first = false;
+                logger_pianodata.debug("%d.%03d,%d.%03d,%d,%d,%f", features[j].timestamp.sec, features[j].timestamp.msec(), features[j].duration.sec, features[j].duration.msec(), currentstart, currentend, features[j].values[0]);
             }
-            if (len > pref_step)
-            {
-                len -= pref_step;
+            total += features[j].values.size();
+
+            int sframe = currentstart / _intervalMS;
+            if (currentstart - sframe * _intervalMS > _intervalMS / 2) {
+                sframe++;
             }
-            else
-            {
-                len = 0;
+            int eframe = currentend / _intervalMS;
+            while (sframe <= eframe && sframe < (int)_frameData.size()) {
+                _frameData[sframe][4].push_back(features[j].values[0]);
+                sframe++;
             }
-            start += pref_step;
         }
 
-        // Process the Polyphonic Transcription
-        try
-        {
-            unsigned int total = 0;
-            logger_pianodata.debug("About to extract Polyphonic Transcription result.");
-            Vamp::Plugin::FeatureSet features = pt->getRemainingFeatures();
-            logger_pianodata.debug("Polyphonic Transcription result retrieved.");
-            logger_pianodata.debug("Start,Duration,CalcStart,CalcEnd,midinote");
-            for (size_t j = 0; j < features[0].size(); j++)
-            {
-                if (j % 10 == 0)
-                {
-                    fn(dlg, (int)(((float)j * 75.0) / (float)features[0].size()) + 25.0);
-                }
-
-                long currentstart = features[0][j].timestamp.sec * 1000 + features[0][j].timestamp.msec();
-                long currentend = currentstart + features[0][j].duration.sec * 1000 + features[0][j].duration.msec();
-
-                //printf("%f\t%f\t%f\n",(float)currentstart/1000.0, (float)currentend/1000.0, features[0][j].values[0]);
-                if (logger_pianodata.isDebugEnabled())
-                {
-                    logger_pianodata.debug("%d.%03d,%d.%03d,%d,%d,%f", features[0][j].timestamp.sec, features[0][j].timestamp.msec(), features[0][j].duration.sec, features[0][j].duration.msec(), currentstart, currentend, features[0][j].values[0]);
-                }
-                total += features[0][j].values.size();
-
-                int sframe = currentstart / _intervalMS;
-                if (currentstart - sframe * _intervalMS > _intervalMS / 2) {
-                    sframe++;
-                }
-                int eframe = currentend / _intervalMS;
-                while (sframe <= eframe) {
-                    _frameData[sframe][4].push_back(features[0][j].values[0]);
-                    sframe++;
-                }
-            }
-
-            fn(dlg, 100);
+        fn(dlg, 100);
 
-            if (logger_pianodata.isDebugEnabled())
+        if (logger_pianodata.isDebugEnabled())
+        {
+            logger_pianodata.debug("Piano data calculated:");
+            logger_pianodata.debug("Time MS, Keys");
+            for (size_t i = 0; i < _frameData.size(); i++)
             {
-                logger_pianodata.debug("Piano data calculated:");
-                logger_pianodata.debug("Time MS, Keys");
-                for (size_t i = 0; i < _frameData.size(); i++)
+                long ms = i * _intervalMS;
+                std::string keys = "";
+                for (auto it2 = _frameData[i][4].begin(); it2 != _frameData[i][4].end(); ++it2)
                 {
-                    long ms = i * _intervalMS;
-                    std::string keys = "";
-                    for (auto it2 = _frameData[i][4].begin(); it2 != _frameData[i][4].end(); ++it2)
-                    {
-                        keys += " " + std::string(wxString::Format("%f", *it2).c_str());
-                    }
-                    logger_pianodata.debug("%ld,%s", ms, (const char *)keys.c_str());
+                    keys += " " + std::string(wxString::Format("%f", *it2).c_str());
                 }
+                logger_pianodata.debug("%ld,%s", ms, (const char *)keys.c_str());
             }
-            //printf("Total points: %u", total);
-        }
-        catch (...)
-        {
-            logger_base.warn("DoPolyphonicTranscription: Polyphonic Transcription threw an error getting the remaining features.");
         }
 
         //done with VAMP Polyphonic Transcriber
@@ -2122,6 +2371,8 @@ int AudioManager::OpenMediaFile()
     }
 
 	// Check if we have read this before ... if so dump the old data
+    _leftMinMaxReady = false;
+    _leftMinMax.clear();
 	if (_data[1] != nullptr && _data[1] != _data[0])
 	{
 		free(_data[1]);
@@ -2436,6 +2687,8 @@ void AudioManager::DoLoadAudioData(AVFormatContext* formatContext, AVCodecContex
 #endif
     wxASSERT(_trackSize == _loadedData);
 
+    BuildMinMaxPyramid();
+
 	// Clean up!
     logger_base.debug("DoLoadAudioData: Cleaning up");
     swr_free(&au_convert_ctx);
@@ -2564,12 +2817,7 @@ void AudioManager::ExtractMP3Tags(AVFormatContext* formatContext)
 // Access a single piece of track data
 float AudioManager::GetLeftData(long offset)
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    while (!IsDataLoaded(offset))
-    {
-        logger_base.debug("GetLeftData waiting for data to be loaded.");
-        wxMilliSleep(100);
-    }
+    WaitForDataLoaded(offset);
 
 	if (_data[0] == nullptr || offset > _trackSize)
 	{
@@ -2578,15 +2826,62 @@ float AudioManager::GetLeftData(long offset)
 	return _data[0][offset];
 }
 
-void AudioManager::GetLeftDataMinMax(long start, long end, float& minimum, float& maximum)
+// Builds a pyramid of left channel min/max values for power of two sized blocks so the min/max
+// of any range can be found by combining a handful of blocks rather than looking at every sample
+void AudioManager::BuildMinMaxPyramid()
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    while (!IsDataLoaded(end-1))
+
+    _leftMinMaxReady = false;
+    _leftMinMax.clear();
+
+    if (_data[0] == nullptr || _trackSize <= 0) return;
+
+    wxStopWatch sw;
+
+    const long size = 1 << AUDIO_MINMAX_SHIFT;
+    std::vector<MinMax> level((_trackSize + size - 1) / size);
+    for (size_t i = 0; i < level.size(); i++)
     {
-        logger_base.debug("GetLeftDataMinMax waiting for data to be loaded.");
-        wxMilliSleep(100);
+        long start = i * size;
+        long end = std::min(start + size, _trackSize);
+        MinMax mm = { _data[0][start], _data[0][start] };
+        for (long j = start + 1; j < end; j++)
+        {
+            float data = _data[0][j];
+            if (data < mm.min) mm.min = data;
+            if (data > mm.max) mm.max = data;
+        }
+        level[i] = mm;
+    }
+    _leftMinMax.push_back(std::move(level));
+
+    while (_leftMinMax.back().size() > 1)
+    {
+        const auto& prior = _leftMinMax.back();
+        std::vector<MinMax> next((prior.size() + 1) / 2);
+        for (size_t i = 0; i < next.size(); i++)
+        {
+            MinMax mm = prior[i * 2];
+            if (i * 2 + 1 < prior.size())
+            {
+                mm.min = std::min(mm.min, prior[i * 2 + 1].min);
+                mm.max = std::max(mm.max, prior[i * 2 + 1].max);
+            }
+            next[i] = mm;
+        }
+        _leftMinMax.push_back(std::move(next));
     }
 
+    _leftMinMaxReady = true;
+
+    logger_base.debug("AudioManager: Waveform min/max pyramid of %d levels built in %ldms.", (int)_leftMinMax.size(), sw.Time());
+}
+
+void AudioManager::GetLeftDataMinMax(long start, long end, float& minimum, float& maximum)
+{
+    WaitForDataLoaded(end-1);
+
     minimum = 0;
     maximum = 0;
 
@@ -2595,14 +2890,43 @@ void AudioManager::GetLeftDataMinMax(long start, long end, float& minimum, float
         return;
     }
 
-    for (int j = start; j < std::min(end, _trackSize); j++) {
+    end = std::min(end, _trackSize);
+    const long base = 1 << AUDIO_MINMAX_SHIFT;
+    bool usePyramid = _leftMinMaxReady;
 
-        float data = _data[0][j];
-        if (data < minimum) {
-            minimum = data;
+    long j = start;
+    while (j < end)
+    {
+        if (usePyramid && (j & (base - 1)) == 0 && j + base <= end)
+        {
+            // use the biggest block that starts here and fits in the range
+            int level = 0;
+            long size = base;
+            while (level + 1 < (int)_leftMinMax.size() && (j & (size * 2 - 1)) == 0 && j + size * 2 <= end)
+            {
+                level++;
+                size *= 2;
+            }
+
+            const MinMax& mm = _leftMinMax[level][j / size];
+            if (mm.min < minimum) {
+                minimum = mm.min;
+            }
+            if (mm.max > maximum) {
+                maximum = mm.max;
+            }
+            j += size;
         }
-        if (data > maximum) {
-            maximum = data;
+        else
+        {
+            float data = _data[0][j];
+            if (data < minimum) {
+                minimum = data;
+            }
+            if (data > maximum) {
+                maximum = data;
+            }
+            j++;
         }
     }
 }
@@ -2610,12 +2934,7 @@ void AudioManager::GetLeftDataMinMax(long start, long end, float& minimum, float
 // Access a single piece of track data
 float AudioManager::GetRightData(long offset)
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    while (!IsDataLoaded(offset))
-    {
-        logger_base.debug("GetRightData waiting for data to be loaded.");
-        wxMilliSleep(100);
-    }
+    WaitForDataLoaded(offset);
 
     if (_data[1] == nullptr || offset > _trackSize)
 	{
@@ -2627,12 +2946,7 @@ float AudioManager::GetRightData(long offset)
 // Access track data but get a pointer so you can then read a block directly
 float* AudioManager::GetLeftDataPtr(long offset)
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    while (!IsDataLoaded(offset))
-    {
-        logger_base.debug("GetLeftDataPtr waiting for data to be loaded.");
-        wxMilliSleep(100);
-    }
+    WaitForDataLoaded(offset);
 
     wxASSERT(_data[0] != nullptr);
 	if (offset > _trackSize)
@@ -2645,12 +2959,7 @@ float* AudioManager::GetLeftDataPtr(long offset)
 // Access track data but get a pointer so you can then read a block directly
 float* AudioManager::GetRightDataPtr(long offset)
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    while (!IsDataLoaded(offset))
-    {
-        logger_base.debug("GetRightDataPtr waiting for data to be loaded.");
-        wxMilliSleep(100);
-    }
+    WaitForDataLoaded(offset);
 
     wxASSERT(_data[1] != nullptr);
 	if (offset > _trackSize)
@@ -2710,12 +3019,7 @@ std::string AudioManager::Hash()
 {
     if (_hash == "")
     {
-        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-        while (!IsDataLoaded(_trackSize))
-        {
-            logger_base.debug("GetLeftDataPtr waiting for data to be loaded.");
-            wxMilliSleep(100);
-        }
+        WaitForDataLoaded(_trackSize);
 
         MD5 md5;
         md5.update((unsigned char *)_data[0], sizeof(float)*_trackSize);
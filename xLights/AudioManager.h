@@ -3,7 +3,11 @@
 
 #include <string>
 #include <list>
+#include <vector>
+#include <atomic>
 #include <shared_mutex>
+#include <condition_variable>
+#include <functional>
 
 extern "C"
 {
@@ -43,6 +47,19 @@ public:
 		std::string Description;
 	};
 
+	// One plugin output to run over the whole track with AudioManager::RunVampPlugins.
+	// The plugin must already have its parameters set and each run needs its own plugin.
+	struct PluginRun
+	{
+	public:
+		Vamp::Plugin* Plugin = nullptr;
+		int Output = 0;
+		size_t Step = 0;
+		size_t Block = 0;
+		int Channels = 1;
+		Vamp::Plugin::FeatureList Features;
+	};
+
 	xLightsVamp();
 	~xLightsVamp();
     static void ProcessFeatures(Vamp::Plugin::FeatureList &feature, std::vector<int> &starts, std::vector<int> &ends, std::vector<std::string> &labels);
@@ -156,13 +173,23 @@ public:
     void StopListening();
 };
 
+// the smallest bucket in the waveform min/max pyramid is 1 << AUDIO_MINMAX_SHIFT samples
+#define AUDIO_MINMAX_SHIFT 6
+
 class AudioManager
 {
+    struct MinMax
+    {
+        float min;
+        float max;
+    };
+
 	JobPool _jobPool;
 	Job* _job;
     std::shared_timed_mutex _mutex;
     Job* _jobAudioLoad;
     std::shared_timed_mutex _mutexAudioLoad;
+    std::condition_variable_any _loadedDataSignal;
     long _loadedData;
     std::vector<std::vector<std::list<float>>> _frameData;
 	std::string _audio_file;
@@ -192,6 +219,8 @@ class AudioManager
     int _sdlid;
     bool _ok;
     std::string _hash;
+    std::vector<std::vector<MinMax>> _leftMinMax; // level n holds the min/max of each block of 1 << (AUDIO_MINMAX_SHIFT + n) samples
+    std::atomic<bool> _leftMinMaxReady;
 
 	void GetTrackMetrics(AVFormatContext* formatContext, AVCodecContext* codecContext, AVStream* audioStream);
 	void LoadTrackData(AVFormatContext* formatContext, AVCodecContext* codecContext, AVStream* audioStream);
@@ -207,6 +236,11 @@ class AudioManager
 	std::list<float> CalculateSpectrumAnalysis(const float* in, int n, float& max, int id) const;
     void LoadAudioData(bool separateThread, AVFormatContext* formatContext, AVCodecContext* codecContext, AVStream* audioStream, AVFrame* frame);
     void SetLoadedData(long pos);
+    void WaitForDataLoaded(long pos = -1);
+    void BuildMinMaxPyramid();
+    std::string VampCacheKey(const xLightsVamp::PluginRun& run);
+    bool LoadVampCache(const std::string& key, Vamp::Plugin::FeatureList& features) const;
+    void SaveVampCache(const std::string& key, const Vamp::Plugin::FeatureList& features) const;
 
 public:
     bool IsOk() const { return _ok; }
@@ -254,6 +288,7 @@ public:
 	std::list<float>* GetFrameData(FRAMEDATATYPE fdt, std::string timing, long ms);
 	void DoPrepareFrameData();
 	void DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManagerProgressCallback progresscallback);
+    void RunVampPlugins(std::vector<xLightsVamp::PluginRun>& runs, std::function<void(int)> progress);
 	bool IsPolyphonicTranscriptionDone() const { return _polyphonicTranscriptionDone; };
     void DoLoadAudioData(AVFormatContext* formatContext, AVCodecContext* codecContext, AVStream* audioStream, AVFrame* frame);
     
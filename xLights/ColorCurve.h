@@ -11,6 +11,8 @@
 #include "Color.h"
 
 #define CC_X_POINTS 100.0
+// lookup tables sample a curve at this many steps, a multiple of CC_X_POINTS so every point lands exactly on an entry
+#define CC_LUT_POINTS 1000
 
 class ccSortableColorPoint
 {
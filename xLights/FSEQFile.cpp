@@ -6,6 +6,7 @@
 #include <vector>
 #include <cstring>
 #include <memory>
+#include <algorithm>
 
 #include <stdio.h>
 #include <inttypes.h>
@@ -599,6 +600,10 @@ static const int V2FSEQ_HEADER_SIZE = 32;
 #if !defined(NO_ZLIB) || !defined(NO_ZSTD)
 static const int V2FSEQ_OUT_BUFFER_SIZE = 1024*1024; //1M output buffer
 static const int V2FSEQ_OUT_BUFFER_FLUSH_SIZE = 900 * 1024; //90% full, flush it
+//number of partially decoded blocks kept around so seeking back into a
+//recently used block resumes the decoder instead of restarting it
+static const int V2FSEQ_DECODED_BLOCK_CACHE = 4;
+static const uint64_t V2FSEQ_DECODED_BLOCK_CACHE_SIZE = 64 * 1024 * 1024;
 #endif
 
 class V2Handler {
@@ -784,96 +789,189 @@ public:
 };
 
 #ifndef NO_ZSTD
+static inline void xorFrame(uint8_t *dst, const uint8_t *src, size_t len) {
+    size_t x = 0;
+    for (; x + 8 <= len; x += 8) {
+        uint64_t d, v;
+        memcpy(&d, &dst[x], 8);
+        memcpy(&v, &src[x], 8);
+        d ^= v;
+        memcpy(&dst[x], &d, 8);
+    }
+    for (; x < len; x++) {
+        dst[x] ^= src[x];
+    }
+}
+
+// With delta set (compression type 3) each stored frame is XOR'd against the
+// previous stored frame before it is handed to zstd.  The first frame of every
+// block is stored as is so blocks remain independently decodable.
 class V2ZSTDCompressionHandler : public V2CompressedHandler {
 public:
-    V2ZSTDCompressionHandler(V2FSEQFile *f) : V2CompressedHandler(f),
+    V2ZSTDCompressionHandler(V2FSEQFile *f, bool delta = false) : V2CompressedHandler(f),
     m_cctx(nullptr),
-    m_dctx(nullptr)
+    m_delta(delta),
+    m_useCount(0)
     {
+        m_decoded.reserve(V2FSEQ_DECODED_BLOCK_CACHE);
         m_outBuffer.pos = 0;
         m_outBuffer.size = V2FSEQ_OUT_BUFFER_SIZE;
         m_outBuffer.dst = malloc(m_outBuffer.size);
-        m_inBuffer.src = nullptr;
-        m_inBuffer.size = 0;
-        m_inBuffer.pos = 0;
         LogDebug(VB_SEQUENCE, "  Prepared to write a ZSTD compress fseq file.\n");
     }
     virtual ~V2ZSTDCompressionHandler() {
         free(m_outBuffer.dst);
-        if (m_inBuffer.src != nullptr) {
-            free((void*)m_inBuffer.src);
-        }
         if (m_cctx) {
             ZSTD_freeCStream(m_cctx);
         }
-        if (m_dctx) {
-            ZSTD_freeDStream(m_dctx);
+        for (auto &b : m_decoded) {
+            if (b.dctx) {
+                ZSTD_freeDStream(b.dctx);
+            }
+        }
+    }
+    virtual uint8_t getCompressionType() override { return m_delta ? 3 : 1;}
+    virtual std::string GetType() const override { return m_delta ? "Compressed ZSTD Delta" : "Compressed ZSTD"; }
+
+    // A compression block is a single zstd frame so it can only be decoded from
+    // its start.  Rather than discarding the decoder every time playback or
+    // scrubbing crosses a block boundary, keep the decoder, compressed input
+    // and decoded output for the most recently used blocks.  Each one is a
+    // checkpoint: frames already decoded are served from memory and later
+    // frames continue from wherever that block's decoder stopped.
+    struct DecodedBlock {
+        DecodedBlock() : block(0xFFFFFFFF), dctx(nullptr), framesInBlock(0), framesDecoded(0), lastUsed(0) {
+            in.src = nullptr;
+            in.size = 0;
+            in.pos = 0;
+            out.dst = nullptr;
+            out.size = 0;
+            out.pos = 0;
+        }
+        uint32_t block;
+        ZSTD_DStream *dctx;
+        std::vector<uint8_t> inData;
+        std::vector<uint8_t> outData;
+        ZSTD_inBuffer_s in;
+        ZSTD_outBuffer_s out;
+        uint32_t framesInBlock;
+        uint32_t framesDecoded;
+        uint64_t lastUsed;
+    };
+
+    uint32_t findBlock(uint32_t frame) const {
+        //m_frameOffsets is sorted by starting frame with a sentinel at the end
+        const auto &offsets = m_file->m_frameOffsets;
+        auto it = std::upper_bound(offsets.begin(), offsets.end() - 1, frame,
+                                   [](uint32_t f, const std::pair<uint32_t, uint64_t> &o) { return f < o.first; });
+        if (it == offsets.begin()) {
+            return 0;
         }
+        return (it - offsets.begin()) - 1;
     }
-    virtual uint8_t getCompressionType() override { return 1;}
-    virtual std::string GetType() const override { return "Compressed ZSTD"; }
 
-    virtual FrameData *getFrame(uint32_t frame) override {
-        if (m_curBlock > 256 || (frame < m_file->m_frameOffsets[m_curBlock].first) || (frame >= m_file->m_frameOffsets[m_curBlock + 1].first)) {
-            //frame is not in the current block
-            m_curBlock = 0;
-            while (frame >= m_file->m_frameOffsets[m_curBlock + 1].first) {
-                m_curBlock++;
+    DecodedBlock &getDecodedBlock(uint32_t block, uint32_t frame) {
+        DecodedBlock *victim = nullptr;
+        uint64_t cachedSize = 0;
+        for (auto &b : m_decoded) {
+            if (b.block == block) {
+                b.lastUsed = ++m_useCount;
+                return b;
             }
-            if (m_dctx == nullptr) {
-                m_dctx = ZSTD_createDStream();
+            cachedSize += b.outData.size();
+        }
+        if (m_decoded.size() < V2FSEQ_DECODED_BLOCK_CACHE && cachedSize < V2FSEQ_DECODED_BLOCK_CACHE_SIZE) {
+            m_decoded.emplace_back();
+            victim = &m_decoded.back();
+        } else {
+            for (auto &b : m_decoded) {
+                if (victim == nullptr || b.lastUsed < victim->lastUsed) {
+                    victim = &b;
+                }
             }
-            ZSTD_initDStream(m_dctx);
-            seek(m_file->m_frameOffsets[m_curBlock].second, SEEK_SET);
+        }
+        DecodedBlock &b = *victim;
+        b.block = block;
+        b.lastUsed = ++m_useCount;
+        if (b.dctx == nullptr) {
+            b.dctx = ZSTD_createDStream();
+        }
+        ZSTD_initDStream(b.dctx);
+        seek(m_file->m_frameOffsets[block].second, SEEK_SET);
+
+        uint64_t len = m_file->m_frameOffsets[block + 1].second;
+        len -= m_file->m_frameOffsets[block].second;
+        uint64_t max = m_file->getNumFrames();
+        max *= m_file->getChannelCount();
+        if (len > max) {
+            len = max;
+        }
+        //buffers are reused between blocks, they only ever grow to the largest block seen
+        b.inData.resize(len);
+        uint64_t bread = read(b.inData.data(), len);
+        if (bread != len) {
+            LogErr(VB_SEQUENCE, "Failed to read channel data for frame %d!   Needed to read %" PRIu64 " but read %d\n", frame, len, (int)bread);
+        }
+        b.in.src = b.inData.data();
+        b.in.size = bread;
+        b.in.pos = 0;
+
+        if (block < m_file->m_frameOffsets.size() - 2) {
+            //let the kernel know that we'll likely need the next block in the near future
+            uint64_t len2 = m_file->m_frameOffsets[block + 2].second;
+            len2 -= m_file->m_frameOffsets[block + 1].second;
+            preload(tell(), len2);
+        }
 
-            uint64_t len = m_file->m_frameOffsets[m_curBlock + 1].second;
-            len -= m_file->m_frameOffsets[m_curBlock].second;
-            int max = m_file->getNumFrames() * m_file->getChannelCount();
-            if (len > max) {
-                len = max;
-            }
-            if (m_inBuffer.src) {
-                free((void*)m_inBuffer.src);
-            }
-            m_inBuffer.src = malloc(len);
-            m_inBuffer.pos = 0;
-            m_inBuffer.size = len;
-            int bread = read((void*)m_inBuffer.src, len);
-            if (bread != len) {
-                LogErr(VB_SEQUENCE, "Failed to read channel data for frame %d!   Needed to read %" PRIu64 " but read %d\n", frame, len, (int)bread);
-            }
+        b.framesInBlock = (m_file->m_frameOffsets[block + 1].first > m_file->getNumFrames() ? m_file->getNumFrames() : m_file->m_frameOffsets[block + 1].first) - m_file->m_frameOffsets[block].first;
+        b.outData.resize((uint64_t)b.framesInBlock * m_file->getChannelCount());
+        b.out.dst = b.outData.data();
+        b.out.size = 0;
+        b.out.pos = 0;
+        b.framesDecoded = 0;
+        return b;
+    }
 
-            if (m_curBlock < m_file->m_frameOffsets.size() - 2) {
-                //let the kernel know that we'll likely need the next block in the near future
-                uint64_t len2 = m_file->m_frameOffsets[m_curBlock + 2].second;
-                len2 -= m_file->m_frameOffsets[m_curBlock+1].second;
-                preload(tell(), len2);
+    virtual FrameData *getFrame(uint32_t frame) override {
+        uint32_t block = findBlock(frame);
+        DecodedBlock &b = getDecodedBlock(block, frame);
+        int fidx = frame - m_file->m_frameOffsets[block].first;
+
+        if (fidx >= (int)b.framesDecoded && fidx < (int)b.framesInBlock) {
+            b.out.size = (fidx + 1) * m_file->getChannelCount();
+            //keep feeding the decoder until the frame is complete, a single call
+            //stops early at internal zstd frame boundaries
+            while (b.out.pos < b.out.size && b.in.pos < b.in.size) {
+                size_t before = b.out.pos;
+                size_t rc = ZSTD_decompressStream(b.dctx, &b.out, &b.in);
+                if (ZSTD_isError(rc)) {
+                    LogErr(VB_SEQUENCE, "Failed to decompress block %d for frame %d: %s\n", (int)block, (int)frame, ZSTD_getErrorName(rc));
+                    break;
+                }
+                if (rc == 0 && b.out.pos == before) {
+                    break;
+                }
             }
-
-            free(m_outBuffer.dst);
-            m_framesPerBlock = (m_file->m_frameOffsets[m_curBlock + 1].first > m_file->getNumFrames() ? m_file->getNumFrames() :  m_file->m_frameOffsets[m_curBlock + 1].first) - m_file->m_frameOffsets[m_curBlock].first;
-            m_outBuffer.size = m_framesPerBlock * m_file->getChannelCount();
-            m_outBuffer.dst = malloc(m_outBuffer.size);
-            m_outBuffer.pos = 0;
-            m_curFrameInBlock = 0;
-        }
-        int fidx = frame - m_file->m_frameOffsets[m_curBlock].first;
-
-        if (fidx >= m_curFrameInBlock) {
-            m_outBuffer.size = (fidx + 1) * m_file->getChannelCount();
-            ZSTD_decompressStream(m_dctx, &m_outBuffer, &m_inBuffer);
-            m_curFrameInBlock = fidx + 1;
+            uint32_t decoded = b.out.pos / m_file->getChannelCount();
+            if (m_delta) {
+                //rebuild the new frames from the deltas, each only needs the one before it
+                uint32_t cc = m_file->getChannelCount();
+                for (uint32_t x = std::max(b.framesDecoded, (uint32_t)1); x < decoded; x++) {
+                    xorFrame(&b.outData[(uint64_t)x * cc], &b.outData[(uint64_t)(x - 1) * cc], cc);
+                }
+            }
+            b.framesDecoded = decoded;
         }
         
         fidx *= m_file->getChannelCount();
-        uint8_t *fdata = (uint8_t*)m_outBuffer.dst;
+        uint8_t *fdata = b.outData.data();
         UncompressedFrameData *data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
 
         // This stops the crash on load ... but it is not the root cause.
         // But better to not load completely than crashing
-        if (fidx < 0) {
+        if (fidx < 0 || fidx + m_file->getChannelCount() > b.outData.size()) {
             // this is not going to end well ... best to give up here
-            LogErr(VB_SEQUENCE, "Frame index calculated as a negative number. Aborting frame %d load.\n", (int)frame);
+            LogErr(VB_SEQUENCE, "Frame index calculated outside the block. Aborting frame %d load.\n", (int)frame);
             return data;
         }
 
@@ -938,7 +1036,35 @@ public:
         }
 
         uint8_t *curData = (uint8_t *)data;
-        if (m_file->m_sparseRanges.empty()) {
+        if (m_delta) {
+            //gather the stored channels so the delta is taken in file order
+            uint32_t cc = m_file->getChannelCount();
+            m_deltaFrame.resize(cc);
+            if (m_file->m_sparseRanges.empty()) {
+                memcpy(m_deltaFrame.data(), curData, cc);
+            } else {
+                uint32_t sz = 0;
+                for (auto &a : m_file->m_sparseRanges) {
+                    memcpy(&m_deltaFrame[sz], &curData[a.first], a.second);
+                    sz += a.second;
+                }
+            }
+            if (m_curFrameInBlock == 0) {
+                m_prevFrame = m_deltaFrame;
+            } else {
+                for (uint32_t x = 0; x < cc; x++) {
+                    uint8_t v = m_deltaFrame[x];
+                    m_deltaFrame[x] ^= m_prevFrame[x];
+                    m_prevFrame[x] = v;
+                }
+            }
+            ZSTD_inBuffer_s input = {
+                m_deltaFrame.data(),
+                cc,
+                0
+            };
+            compressData(m_cctx, input, m_outBuffer);
+        } else if (m_file->m_sparseRanges.empty()) {
             ZSTD_inBuffer_s input = {
                 curData,
                 m_file->getChannelCount(),
@@ -995,9 +1121,12 @@ public:
     }
 
     ZSTD_CStream* m_cctx;
-    ZSTD_DStream* m_dctx;
     ZSTD_outBuffer_s m_outBuffer;
-    ZSTD_inBuffer_s m_inBuffer;
+    bool m_delta;
+    std::vector<uint8_t> m_prevFrame;
+    std::vector<uint8_t> m_deltaFrame;
+    std::vector<DecodedBlock> m_decoded;
+    uint64_t m_useCount;
 };
 #endif
 
@@ -1187,6 +1316,13 @@ void V2FSEQFile::createHandler() {
         LogErr(VB_ALL, "No support for zstd compression");
 #else
         m_handler = new V2ZSTDCompressionHandler(this);
+#endif
+        break;
+    case CompressionType::zstd_delta:
+#ifdef NO_ZSTD
+        LogErr(VB_ALL, "No support for zstd compression");
+#else
+        m_handler = new V2ZSTDCompressionHandler(this, true);
 #endif
         break;
     case CompressionType::zlib:
@@ -1338,6 +1474,9 @@ m_handler(nullptr)
             case 2:
             m_compressionType = CompressionType::zlib;
             break;
+            case 3:
+            m_compressionType = CompressionType::zstd_delta;
+            break;
             default:
             LogErr(VB_SEQUENCE, "Unknown compression type: %d", (int)header[32]);
         }
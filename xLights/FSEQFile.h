@@ -34,7 +34,8 @@ public:
     enum CompressionType {
         none,
         zstd,
-        zlib
+        zlib,
+        zstd_delta
     };
 
 protected:
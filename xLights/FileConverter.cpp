@@ -1675,13 +1675,29 @@ void FileConverter::WriteFalconPiFile(ConvertParameters& params)
 {
     static log4cpp::Category &logger_conversion = log4cpp::Category::getInstance(std::string("log_conversion"));
     logger_conversion.debug("Start fseq write");
-    
-    
+
+    FSEQFile *file = CreateFalconPiFile(params);
+    if (!file) {
+        return;
+    }
+    size_t size = params.seq_data.NumFrames();
+    for (int x = 0; x < size; x++) {
+        file->addFrame(x, &params.seq_data[x][0]);
+    }
+    file->finalize();
+    delete file;
+    logger_conversion.debug("End fseq write");
+}
+
+// Creates the fseq file and writes its header, the caller adds the frames and finalizes it
+FSEQFile* FileConverter::CreateFalconPiFile(ConvertParameters& params)
+{
     const wxUint8 vMajor = params.xLightsFrm->_fseqVersion;
-    FSEQFile *file = FSEQFile::createFSEQFile(params.out_filename, vMajor, FSEQFile::CompressionType::zstd, 2);
+    const FSEQFile::CompressionType ct = params.xLightsFrm->_fseqDelta ? FSEQFile::CompressionType::zstd_delta : FSEQFile::CompressionType::zstd;
+    FSEQFile *file = FSEQFile::createFSEQFile(params.out_filename, vMajor, ct, 2);
     if (!file) {
         params.ConversionError(wxString("Unable to create file: ") + params.out_filename);
-        return;
+        return nullptr;
     }
 
     size_t stepSize = roundTo4(params.seq_data.NumChannels());
@@ -1712,11 +1728,5 @@ void FileConverter::WriteFalconPiFile(ConvertParameters& params)
     file->addVariableHeader(header);
 
     file->writeHeader();
-    size_t size = params.seq_data.NumFrames();
-    for (int x = 0; x < size; x++) {
-        file->addFrame(x, &params.seq_data[x][0]);
-    }
-    file->finalize();
-    delete file;
-    logger_conversion.debug("End fseq write");
+    return file;
 }
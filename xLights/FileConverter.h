@@ -66,6 +66,8 @@ public:
 
 };
 
+class FSEQFile;
+
 class FileConverter
 {
     public:
@@ -79,6 +81,7 @@ class FileConverter
         static void ReadConductorFile(ConvertParameters& params);
         static void ReadFalconFile(ConvertParameters& params);
         static void WriteFalconPiFile(ConvertParameters& params);
+        static FSEQFile* CreateFalconPiFile(ConvertParameters& params);
 
     
         static bool LoadVixenProfile(ConvertParameters& params, const wxString& ProfileName,
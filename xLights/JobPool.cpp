@@ -250,13 +250,15 @@ void JobPoolWorker::ProcessJob(Job *job)
 		currentJob = job;
         
         std::string origName;
-        if (job->SetThreadName()) {
+        // a job may queue itself again from within Process so it must not be touched once that returns
+        bool setThreadName = job->SetThreadName();
+        if (setThreadName) {
             origName = OriginalThreadName();
             SetThreadName(job->GetName());
         }
         bool deleteWhenComplete = job->DeleteWhenComplete();
         job->Process();
-        if (job->SetThreadName()) {
+        if (setThreadName) {
             SetThreadName(origName);
         }
         currentJob = nullptr;
@@ -3,20 +3,58 @@
 #include <wx/filename.h>
 #include <wx/stdpaths.h>
 #include <wx/progdlg.h>
+#include <wx/file.h>
 
 #include "PhonemeDictionary.h"
 
+#include <algorithm>
+#include <cstring>
+
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <log4cpp/Category.hh>
 #include "UtilFunctions.h"
 
+#define COMPILED_DICTIONARY_MAGIC 0x44504C58 // XLPD
+#define COMPILED_DICTIONARY_VERSION 1
+#define COMPILED_DICTIONARY_HEADER (5 * sizeof(uint32_t))
+
+// identifies the source dictionaries a compiled file was built from
+static std::string DictionaryStamp(const wxString& path)
+{
+    if (path == "") return "|";
+    wxFileName fn(path);
+    return (path + "|" + fn.GetSize().ToString() + "|" + wxString::Format("%lld", (long long)fn.GetModificationTime().GetTicks()) + "|").ToStdString();
+}
+
 void PhonemeDictionary::LoadDictionaries(const wxString &showDir, wxWindow* parent)
 {
-	if (phoneme_dict.size() > 0)
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+	if (loaded)
 		return;
+    loaded = true;
 
     LoadDictionary("user_dictionary", showDir, parent);
-    LoadDictionary("standard_dictionary", showDir, parent, wxFONTENCODING_ISO8859_1);
-    LoadDictionary("extended_dictionary", showDir, parent, wxFONTENCODING_ISO8859_1);
+
+    std::string stamp = DictionaryStamp(FindDictionaryFile("standard_dictionary", showDir)) +
+                        DictionaryStamp(FindDictionaryFile("extended_dictionary", showDir));
+    wxString compiledFile = wxFileName(wxFileName::GetTempDir(), "xLightsPhonemeDictionary.bin").GetFullPath();
+    if (!MapCompiledDictionary(compiledFile, stamp)) {
+        std::map<wxString, wxArrayString> dict;
+        LoadDictionary("standard_dictionary", showDir, parent, wxFONTENCODING_ISO8859_1, dict);
+        LoadDictionary("extended_dictionary", showDir, parent, wxFONTENCODING_ISO8859_1, dict);
+        if (!CompileDictionaries(dict, compiledFile, stamp)) {
+            logger_base.warn("Unable to save compiled phoneme dictionary '%s'.", (const char *)compiledFile.c_str());
+        }
+    }
 
     wxFileName phonemeFile = wxFileName::FileName(wxStandardPaths::Get().GetExecutablePath());
     phonemeFile.SetFullName("phoneme_mapping");
@@ -47,10 +85,8 @@ void PhonemeDictionary::LoadDictionaries(const wxString &showDir, wxWindow* pare
     }
 }
 
-void PhonemeDictionary::LoadDictionary(const wxString &filename, const wxString &showDir, wxWindow* parent, wxFontEncoding defEnc)
+wxString PhonemeDictionary::FindDictionaryFile(const wxString &filename, const wxString &showDir)
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-
     // start looking for dictionary in the show folder
     wxFileName phonemeFile = wxFileName::DirName(showDir);
     phonemeFile.SetFullName(filename);
@@ -67,10 +103,27 @@ void PhonemeDictionary::LoadDictionary(const wxString &filename, const wxString
     }
 
     if (!wxFile::Exists(phonemeFile.GetFullPath())) {
+        return "";
+    }
+    return phonemeFile.GetFullPath();
+}
+
+void PhonemeDictionary::LoadDictionary(const wxString &filename, const wxString &showDir, wxWindow* parent, wxFontEncoding defEnc)
+{
+    LoadDictionary(filename, showDir, parent, defEnc, phoneme_dict);
+}
+
+void PhonemeDictionary::LoadDictionary(const wxString &filename, const wxString &showDir, wxWindow* parent, wxFontEncoding defEnc, std::map<wxString, wxArrayString>& dict)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    wxString path = FindDictionaryFile(filename, showDir);
+    if (path == "") {
         logger_base.warn("Failed to open phoneme dictionary. '%s'", (const char *)filename.c_str());
         DisplayError("Failed to open Phoneme dictionary!");
         return;
     }
+    wxFileName phonemeFile(path);
 
     logger_base.debug("Loading phoneme dictionary. '%s'", (const char *)phonemeFile.GetFullPath().c_str());
 
@@ -89,8 +142,8 @@ void PhonemeDictionary::LoadDictionary(const wxString &filename, const wxString
 
 		wxArrayString strList = wxSplit(line,' ');
 		if (strList.size() > 1) {
-			if (phoneme_dict.find(strList[0]) == phoneme_dict.end())
-				phoneme_dict.emplace(std::pair<wxString, wxArrayString>(strList[0], strList));
+			if (dict.find(strList[0]) == dict.end())
+				dict.emplace(std::pair<wxString, wxArrayString>(strList[0], strList));
 		}
         linenum++;
         if (linenum % 1000 == 0)
@@ -101,6 +154,218 @@ void PhonemeDictionary::LoadDictionary(const wxString &filename, const wxString
     dlg.Update(100);
 }
 
+#pragma region Compiled Dictionary
+struct CompiledDictionaryMapping
+{
+#ifdef __WXMSW__
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    void* data = nullptr;
+    size_t size = 0;
+};
+
+bool PhonemeDictionary::MapCompiledDictionary(const wxString& filename, const std::string& stamp)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (!wxFile::Exists(filename)) return false;
+
+    CompiledDictionaryMapping* m = new CompiledDictionaryMapping();
+#ifdef __WXMSW__
+    m->file = CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+    if (m->file != INVALID_HANDLE_VALUE && GetFileSizeEx(m->file, &size) && size.QuadPart > 0) {
+        m->size = (size_t)size.QuadPart;
+        m->mapping = CreateFileMappingW(m->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m->mapping != nullptr) {
+            m->data = MapViewOfFile(m->mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+#else
+    m->fd = open(filename.fn_str(), O_RDONLY);
+    struct stat st;
+    if (m->fd >= 0 && fstat(m->fd, &st) == 0 && st.st_size > 0) {
+        m->size = st.st_size;
+        m->data = mmap(nullptr, m->size, PROT_READ, MAP_SHARED, m->fd, 0);
+        if (m->data == MAP_FAILED) {
+            m->data = nullptr;
+        }
+    }
+#endif
+    compiled_mapping = m;
+
+    if (m->data == nullptr || !UseCompiledDictionary((const uint8_t*)m->data, m->size, stamp)) {
+        logger_base.debug("Compiled phoneme dictionary '%s' missing or out of date.", (const char *)filename.c_str());
+        UnmapCompiledDictionary();
+        return false;
+    }
+    logger_base.debug("Mapped compiled phoneme dictionary '%s' with %u words.", (const char *)filename.c_str(), compiled_count);
+    return true;
+}
+
+void PhonemeDictionary::UnmapCompiledDictionary()
+{
+    CompiledDictionaryMapping* m = (CompiledDictionaryMapping*)compiled_mapping;
+    if (m != nullptr) {
+#ifdef __WXMSW__
+        if (m->data != nullptr) UnmapViewOfFile(m->data);
+        if (m->mapping != nullptr) CloseHandle(m->mapping);
+        if (m->file != INVALID_HANDLE_VALUE) CloseHandle(m->file);
+#else
+        if (m->data != nullptr) munmap(m->data, m->size);
+        if (m->fd >= 0) close(m->fd);
+#endif
+        if (compiled_data == m->data) {
+            compiled_data = nullptr;
+            compiled_size = 0;
+            compiled_count = 0;
+            compiled_index = nullptr;
+            compiled_strings = nullptr;
+        }
+        delete m;
+        compiled_mapping = nullptr;
+    }
+}
+
+// Layout: header (magic, version, stamp length, word count, string pool size), the stamp
+// padded to 4 bytes, then 4 uint32 per word (key offset, key length, pronunciation offset,
+// pronunciation length) sorted by key, then the UTF-8 string pool
+bool PhonemeDictionary::UseCompiledDictionary(const uint8_t* data, size_t size, const std::string& stamp)
+{
+    if (size < COMPILED_DICTIONARY_HEADER) return false;
+    const uint32_t* header = (const uint32_t*)data;
+    if (header[0] != COMPILED_DICTIONARY_MAGIC || header[1] != COMPILED_DICTIONARY_VERSION) return false;
+
+    uint32_t stampLen = header[2];
+    uint32_t count = header[3];
+    uint32_t stringsSize = header[4];
+    uint64_t indexStart = COMPILED_DICTIONARY_HEADER + ((uint64_t)stampLen + 3) / 4 * 4;
+    uint64_t stringsStart = indexStart + (uint64_t)count * 4 * sizeof(uint32_t);
+    if (stringsStart + stringsSize != size) return false;
+    if (stampLen != stamp.size() || memcmp(data + COMPILED_DICTIONARY_HEADER, stamp.c_str(), stampLen) != 0) return false;
+
+    const uint32_t* index = (const uint32_t*)(data + indexStart);
+    for (uint32_t i = 0; i < count * 4; i += 2) {
+        if ((uint64_t)index[i] + index[i + 1] > stringsSize) return false;
+    }
+
+    compiled_data = data;
+    compiled_size = size;
+    compiled_count = count;
+    compiled_index = index;
+    compiled_strings = (const char*)(data + stringsStart);
+    return true;
+}
+
+bool PhonemeDictionary::CompileDictionaries(const std::map<wxString, wxArrayString>& dict, const wxString& filename, const std::string& stamp)
+{
+    std::vector<std::pair<std::string, std::string>> words;
+    words.reserve(dict.size());
+    for (const auto& it : dict) {
+        wxString pronunciation;
+        for (size_t i = 1; i < it.second.size(); i++) {
+            if (i > 1) pronunciation += " ";
+            pronunciation += it.second[i];
+        }
+        words.emplace_back(it.first.ToUTF8().data(), pronunciation.ToUTF8().data());
+    }
+    // lookups compare UTF-8 bytes so sort the same way
+    std::sort(words.begin(), words.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    uint32_t stampLen = stamp.size();
+    size_t indexStart = COMPILED_DICTIONARY_HEADER + (stampLen + 3) / 4 * 4;
+    size_t stringsStart = indexStart + words.size() * 4 * sizeof(uint32_t);
+    size_t stringsSize = 0;
+    for (const auto& it : words) {
+        stringsSize += it.first.size() + it.second.size();
+    }
+
+    compiled_buffer.assign(stringsStart + stringsSize, 0);
+    uint32_t* header = (uint32_t*)compiled_buffer.data();
+    header[0] = COMPILED_DICTIONARY_MAGIC;
+    header[1] = COMPILED_DICTIONARY_VERSION;
+    header[2] = stampLen;
+    header[3] = words.size();
+    header[4] = stringsSize;
+    memcpy(&compiled_buffer[COMPILED_DICTIONARY_HEADER], stamp.c_str(), stampLen);
+
+    uint32_t* index = (uint32_t*)&compiled_buffer[indexStart];
+    char* strings = (char*)&compiled_buffer[stringsStart];
+    uint32_t offset = 0;
+    for (const auto& it : words) {
+        *index++ = offset;
+        *index++ = it.first.size();
+        memcpy(strings + offset, it.first.c_str(), it.first.size());
+        offset += it.first.size();
+        *index++ = offset;
+        *index++ = it.second.size();
+        memcpy(strings + offset, it.second.c_str(), it.second.size());
+        offset += it.second.size();
+    }
+
+    // use it from memory this time, later runs will map the file
+    UseCompiledDictionary(compiled_buffer.data(), compiled_buffer.size(), stamp);
+
+    wxString tempFile = filename + ".tmp";
+    wxFile f;
+    if (!f.Create(tempFile, true) || f.Write(compiled_buffer.data(), compiled_buffer.size()) != compiled_buffer.size()) {
+        return false;
+    }
+    f.Close();
+    return wxRenameFile(tempFile, filename, true);
+}
+
+int PhonemeDictionary::FindCompiled(const wxString& word) const
+{
+    if (compiled_count == 0) return -1;
+
+    wxScopedCharBuffer key = word.ToUTF8();
+    size_t keyLen = key.length();
+    int low = 0;
+    int high = (int)compiled_count - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        const uint32_t* entry = &compiled_index[mid * 4];
+        int cmp = memcmp(compiled_strings + entry[0], key.data(), std::min((size_t)entry[1], keyLen));
+        if (cmp == 0) {
+            cmp = entry[1] < keyLen ? -1 : (entry[1] > keyLen ? 1 : 0);
+        }
+        if (cmp == 0) return mid;
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+wxArrayString PhonemeDictionary::GetCompiled(int index) const
+{
+    // same shape as the parsed dictionary line, the word followed by its phonemes
+    const uint32_t* entry = &compiled_index[index * 4];
+    wxString line = wxString::FromUTF8(compiled_strings + entry[0], entry[1]) + " " + wxString::FromUTF8(compiled_strings + entry[2], entry[3]);
+    return wxSplit(line, ' ');
+}
+#pragma endregion
+
+wxArrayString PhonemeDictionary::GetPhoneme(const wxString& word)
+{
+    wxString w = word.Upper();
+    auto it = phoneme_dict.find(w);
+    if (it != phoneme_dict.end()) {
+        return it->second;
+    }
+    int index = FindCompiled(w);
+    if (index >= 0) {
+        return GetCompiled(index);
+    }
+    return wxArrayString();
+}
+
 void PhonemeDictionary::BreakdownWord(const wxString& text, wxArrayString& phonemes)
 {
     wxString word = text;
@@ -136,9 +401,7 @@ void PhonemeDictionary::BreakdownWord(const wxString& text, wxArrayString& phone
 
     phonemes.Clear();
 
-    if (!phoneme_dict.count(word.Upper())) return;
-
-    wxArrayString pronunciation = phoneme_dict.at(word.Upper());
+    wxArrayString pronunciation = GetPhoneme(word);
     if (pronunciation.size() > 1) {
         for (int i = 1; i < pronunciation.size(); i++) {
 
@@ -213,5 +476,13 @@ wxArrayString PhonemeDictionary::GetPhonemeList()
     wxArrayString keys;
     std::transform(std::begin(phoneme_dict), std::end(phoneme_dict), std::back_inserter(keys),
         [](auto const& val) { return wxString(val.first); });
+    for (uint32_t i = 0; i < compiled_count; i++) {
+        const uint32_t* entry = &compiled_index[i * 4];
+        wxString key = wxString::FromUTF8(compiled_strings + entry[0], entry[1]);
+        if (phoneme_dict.find(key) == phoneme_dict.end()) {
+            keys.push_back(key);
+        }
+    }
+    keys.Sort();
     return keys;
 }
@@ -3,33 +3,58 @@
 
 #include <vector>
 #include <map>
+#include <string>
+#include <cstdint>
 #include <wx/string.h>
 #include <wx/arrstr.h>
 
 class wxWindow;
 
+// The standard and extended dictionaries are large and never change so they are
+// compiled once into a binary file (sorted index + string pool) in the temp
+// directory and memory mapped on later runs.  The user dictionary and any words
+// added at runtime live in phoneme_dict and take precedence.
 class PhonemeDictionary
 {
     public:
         PhonemeDictionary() {}
-        virtual ~PhonemeDictionary() {}
+        virtual ~PhonemeDictionary() { UnmapCompiledDictionary(); }
 
         void LoadDictionaries(const wxString &showDir, wxWindow* parent);
         void LoadDictionary(const wxString &filename, const wxString &showDir, wxWindow* parent, wxFontEncoding defEnc = wxFONTENCODING_UTF8);
+        void LoadDictionary(const wxString &filename, const wxString &showDir, wxWindow* parent, wxFontEncoding defEnc, std::map<wxString, wxArrayString>& dict);
         void BreakdownWord(const wxString& text, wxArrayString& phonemes);
         void InsertSpacesAfterPunctuation(wxString& text);
         void InsertPhoneme(const wxArrayString& phonemes);
         void RemovePhoneme(const wxString& text);
-        bool ContainsPhoneme(const wxString& text) { return phoneme_dict.count(text); }
+        bool ContainsPhoneme(const wxString& text) { return phoneme_dict.count(text) || FindCompiled(text) >= 0; }
         bool ContainsPhonemeMap(const wxString& text) { return phoneme_map.count(text); }
         wxArrayString GetPhonemeList();
-        wxArrayString GetPhoneme(const wxString& word) { return phoneme_dict[word.Upper()]; }
+        wxArrayString GetPhoneme(const wxString& word);
 
     protected:
     private:
+        static wxString FindDictionaryFile(const wxString &filename, const wxString &showDir);
+        bool MapCompiledDictionary(const wxString& filename, const std::string& stamp);
+        void UnmapCompiledDictionary();
+        bool UseCompiledDictionary(const uint8_t* data, size_t size, const std::string& stamp);
+        bool CompileDictionaries(const std::map<wxString, wxArrayString>& dict, const wxString& filename, const std::string& stamp);
+        int FindCompiled(const wxString& word) const;
+        wxArrayString GetCompiled(int index) const;
+
         std::vector<wxString> phonemes;
         std::map<wxString, wxString> phoneme_map;
         std::map<wxString, wxArrayString> phoneme_dict;
+        bool loaded = false;
+
+        // compiled standard/extended dictionaries, either mapped or in compiled_buffer
+        const uint8_t* compiled_data = nullptr;
+        size_t compiled_size = 0;
+        uint32_t compiled_count = 0;
+        const uint32_t* compiled_index = nullptr;
+        const char* compiled_strings = nullptr;
+        std::vector<uint8_t> compiled_buffer;
+        void* compiled_mapping = nullptr;
 };
 
 #endif // PHONEMEDICTIONARY_H
@@ -81,46 +81,72 @@ void PixelBufferClass::reset(int nlayers, int timing, bool isNode)
 
     for (int x = 0; x < numLayers; x++)
     {
-        layers[x] = new LayerInfo(frame);
-        layers[x]->buffer.SetFrameTimeInMs(frameTimeInMs);
-        model->InitRenderBufferNodes("Default", "2D", "None", layers[x]->buffer.Nodes, layers[x]->BufferWi, layers[x]->BufferHt);
-        layers[x]->bufferType = "Default";
-        layers[x]->camera = "2D";
-        layers[x]->bufferTransform = "None";
-        layers[x]->outTransitionType = "Fade";
-        layers[x]->inTransitionType = "Fade";
-        layers[x]->subBuffer = "";
-        layers[x]->brightnessValueCurve = "";
-        layers[x]->hueAdjustValueCurve = "";
-        layers[x]->saturationAdjustValueCurve = "";
-        layers[x]->valueAdjustValueCurve = "";
-        layers[x]->blurValueCurve = "";
-        layers[x]->sparklesValueCurve = "";
-        layers[x]->rotationValueCurve = "";
-        layers[x]->xrotationValueCurve = "";
-        layers[x]->yrotationValueCurve = "";
-        layers[x]->zoomValueCurve = "";
-        layers[x]->rotationsValueCurve = "";
-        layers[x]->pivotpointxValueCurve = "";
-        layers[x]->pivotpointyValueCurve = "";
-        layers[x]->xpivotValueCurve = "";
-        layers[x]->ypivotValueCurve = "";
-        layers[x]->ModelBufferHt = layers[x]->BufferHt;
-        layers[x]->ModelBufferWi = layers[x]->BufferWi;
-        layers[x]->buffer.InitBuffer(layers[x]->BufferHt, layers[x]->BufferWi, layers[x]->ModelBufferHt, layers[x]->ModelBufferWi, layers[x]->bufferTransform, isNode);
+        InitLayer(x, isNode);
     }
 }
 
+// creates the layer laid out for the current model
+void PixelBufferClass::InitLayer(int x, bool isNode)
+{
+    layers[x] = new LayerInfo(frame);
+    layers[x]->buffer.SetFrameTimeInMs(frameTimeInMs);
+    model->InitRenderBufferNodes("Default", "2D", "None", layers[x]->buffer.Nodes, layers[x]->BufferWi, layers[x]->BufferHt);
+    layers[x]->bufferType = "Default";
+    layers[x]->camera = "2D";
+    layers[x]->bufferTransform = "None";
+    layers[x]->outTransitionType = "Fade";
+    layers[x]->inTransitionType = "Fade";
+    layers[x]->subBuffer = "";
+    layers[x]->brightnessValueCurve = "";
+    layers[x]->hueAdjustValueCurve = "";
+    layers[x]->saturationAdjustValueCurve = "";
+    layers[x]->valueAdjustValueCurve = "";
+    layers[x]->blurValueCurve = "";
+    layers[x]->sparklesValueCurve = "";
+    layers[x]->rotationValueCurve = "";
+    layers[x]->xrotationValueCurve = "";
+    layers[x]->yrotationValueCurve = "";
+    layers[x]->zoomValueCurve = "";
+    layers[x]->rotationsValueCurve = "";
+    layers[x]->pivotpointxValueCurve = "";
+    layers[x]->pivotpointyValueCurve = "";
+    layers[x]->xpivotValueCurve = "";
+    layers[x]->ypivotValueCurve = "";
+    layers[x]->ModelBufferHt = layers[x]->BufferHt;
+    layers[x]->ModelBufferWi = layers[x]->BufferWi;
+    layers[x]->buffer.InitBuffer(layers[x]->BufferHt, layers[x]->BufferWi, layers[x]->ModelBufferHt, layers[x]->ModelBufferWi, layers[x]->bufferTransform, isNode);
+}
+
+// Model::InitRenderBufferNodes updates the models screen location so a model must never be set up on two
+// threads at once. A nested group can hold a model that is also a direct member so those groups run serially.
+static int PerModelInitStep(const ModelGroup *grp, int minStep) {
+    if (grp == nullptr) return 0;
+    for (auto it = grp->Models().begin(); it != grp->Models().end(); ++it) {
+        if ((*it)->GetDisplayAs() == "ModelGroup") {
+            return 0;
+        }
+    }
+    return minStep;
+}
+
 void PixelBufferClass::InitPerModelBuffers(const ModelGroup &model, int layer, int timing) {
-    for (auto it = model.Models().begin(); it != model.Models().end(); ++it) {
+    // a reused buffer already has them
+    if (layers[layer]->modelBuffers.size() == model.Models().size()) return;
 
-        Model *m = *it;
+    int first = layers[layer]->modelBuffers.size();
+    for (auto it = model.Models().begin(); it != model.Models().end(); ++it) {
         RenderBuffer *buf = new RenderBuffer(frame);
         buf->SetFrameTimeInMs(timing);
-        m->InitRenderBufferNodes("Default", "2D", "None", buf->Nodes, buf->BufferWi, buf->BufferHt);
-        buf->InitBuffer(buf->BufferHt, buf->BufferWi, buf->BufferHt, buf->BufferWi, "None");
         layers[layer]->modelBuffers.push_back(std::unique_ptr<RenderBuffer>(buf));
     }
+
+    // each model fills in its own buffer so large groups can be set up in parallel
+    parallel_for(0, model.Models().size(), [this, &model, layer, first](int i) {
+        Model *m = model.Models()[i];
+        RenderBuffer *buf = layers[layer]->modelBuffers[first + i].get();
+        m->InitRenderBufferNodes("Default", "2D", "None", buf->Nodes, buf->BufferWi, buf->BufferHt);
+        buf->InitBuffer(buf->BufferHt, buf->BufferWi, buf->BufferHt, buf->BufferWi, "None");
+    }, PerModelInitStep(&model, 10));
 }
 
 void PixelBufferClass::InitBuffer(const Model &pbc, int layers, int timing, bool zeroBased)
@@ -160,6 +186,23 @@ void PixelBufferClass::InitNodeBuffer(const Model &pbc, int strand, int node, in
     reset(2, timing, true);
 }
 
+// One layer per node layer of the strand, each a one pixel buffer holding its node
+void PixelBufferClass::InitNodeLayersBuffer(const Model &pbc, int strand, const std::vector<int> &nodes, int timing)
+{
+    modelName = pbc.GetFullName();
+    if (ssModel == nullptr) {
+        ssModel = new SingleLineModel(pbc.GetModelManager());
+    }
+    model = ssModel;
+    reset(0, timing);
+    numLayers = nodes.size();
+    layers.resize(numLayers);
+    for (int x = 0; x < numLayers; x++) {
+        ssModel->Reset(1, pbc, strand, nodes[x]);
+        InitLayer(x, true);
+    }
+}
+
 void PixelBufferClass::Clear(int which)
 {
     if (which != -1) {
@@ -171,6 +214,27 @@ void PixelBufferClass::Clear(int which)
     }
 }
 
+// Approximate bytes held by the buffers and cloned nodes of every layer
+size_t PixelBufferClass::GetMemoryUsage() const
+{
+    auto bufferBytes = [](const RenderBuffer &buffer) {
+        size_t bytes = sizeof(RenderBuffer) + (buffer.pixels.capacity() + buffer.tempbuf.capacity()) * sizeof(xlColor);
+        for (auto it = buffer.Nodes.begin(); it != buffer.Nodes.end(); ++it) {
+            bytes += sizeof(NodeBaseClass) + (*it)->Coords.capacity() * sizeof(NodeBaseClass::CoordStruct);
+        }
+        return bytes;
+    };
+
+    size_t bytes = sizeof(PixelBufferClass);
+    for (auto it = layers.begin(); it != layers.end(); ++it) {
+        bytes += sizeof(LayerInfo) + bufferBytes((*it)->buffer) + (*it)->mask.capacity();
+        for (auto mb = (*it)->modelBuffers.begin(); mb != (*it)->modelBuffers.end(); ++mb) {
+            bytes += bufferBytes(**mb);
+        }
+    }
+    return bytes;
+}
+
 void PixelBufferClass::GetNodeChannelValues(size_t nodenum, unsigned char *buf)
 {
     layers[0]->buffer.Nodes[nodenum]->GetForChannels(buf);
@@ -487,6 +551,155 @@ void PixelBufferClass::mixColors(const wxCoord &x, const wxCoord &y, xlColor &fg
     }
 }
 
+// The colour of one pixel of a layer after masks, hsv adjustments, sparkles, brightness and contrast
+void PixelBufferClass::GetLayerColor(LayerInfo *thelayer, int x, int y, int EffectPeriod, unsigned short &sparkle, xlColor &color)
+{
+    int effStartPer, effEndPer;
+    thelayer->buffer.GetEffectPeriods(effStartPer, effEndPer);
+    float offset = ((float)(EffectPeriod - effStartPer)) / ((float)(effEndPer - effStartPer));
+    offset = std::min(offset, 1.0f);
+
+    if (thelayer->isMasked(x, y)
+        || x < 0
+        || y < 0
+        || x >= thelayer->BufferWi
+        || y >= thelayer->BufferHt
+        ) {
+        color.Set(0, 0, 0, 0);
+    } else {
+        thelayer->buffer.GetPixel(x, y, color);
+    }
+
+    float ha;
+    if (thelayer->HueAdjustValueCurve.IsActive()) {
+        ha = thelayer->HueAdjustValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS()) / 100.0;
+    } else {
+        ha = (float)thelayer->hueadjust / 100.0;
+    }
+    float sa;
+    if (thelayer->SaturationAdjustValueCurve.IsActive()) {
+        sa = thelayer->SaturationAdjustValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS()) / 100.0;
+    } else {
+        sa = (float)thelayer->saturationadjust / 100.0;
+    }
+        
+    float va;
+    if (thelayer->ValueAdjustValueCurve.IsActive()) {
+        va = thelayer->ValueAdjustValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS()) / 100.0;
+    } else {
+        va = (float)thelayer->valueadjust / 100.0;
+    }
+        
+    // adjust for HSV adjustments
+    if (ha != 0 || sa != 0 || va != 0) {
+        HSVValue hsv = color.asHSV();
+
+        if (ha != 0) {
+            hsv.hue += ha;
+            if (hsv.hue < 0) {
+                hsv.hue += 1.0;
+            } else if (hsv.hue > 1) {
+                hsv.hue -= 1.0;
+            }
+        }
+
+        if (sa != 0) {
+            hsv.saturation += sa;
+            if (hsv.saturation < 0) {
+                hsv.saturation = 0.0;
+            } else if (hsv.saturation > 1) {
+                hsv.saturation = 1.0;
+            }
+        }
+
+        if (va != 0) {
+            hsv.value += va;
+            if (hsv.value < 0) {
+                hsv.value = 0.0;
+            } else if (hsv.value > 1) {
+                hsv.value = 1.0;
+            }
+        }
+
+        unsigned char alpha = color.Alpha();
+        color = hsv;
+        color.alpha = alpha;
+    }
+
+    // add sparkles
+    if (color != xlBLACK &&
+        (thelayer->use_music_sparkle_count ||
+            thelayer->sparkle_count > 0 ||
+            thelayer->SparklesValueCurve.IsActive())) {
+        
+        int sc = thelayer->sparkle_count;
+        if (thelayer->SparklesValueCurve.IsActive()) {
+            sc = (int)thelayer->SparklesValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS());
+        }
+        if (thelayer->use_music_sparkle_count) {
+            sc = (int)(thelayer->music_sparkle_count_factor * (float)sc);
+        }
+
+        switch (sparkle % (208 - sc))
+        {
+        case 1:
+        case 7:
+            // too dim
+            //color.Set("#444444");
+            break;
+        case 2:
+        case 6:
+            color.Set(0x88, 0x88, 0x88);
+            break;
+        case 3:
+        case 5:
+            color.Set(0xbb, 0xbb, 0xbb);
+            break;
+        case 4:
+            color.Set(255, 255, 255);
+            break;
+        default:
+            break;
+        }
+        sparkle++;
+    }
+    int b;
+    if (thelayer->BrightnessValueCurve.IsActive()) {
+        b = (int)thelayer->BrightnessValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS());
+    } else {
+        b = thelayer->brightness;
+    }
+    if (thelayer->contrast != 0) {
+        //contrast is not 0, can handle brightness change at same time
+        HSVValue hsv = color.asHSV();
+        hsv.value = hsv.value * ((double)b / 100.0);
+
+        // Apply Contrast
+        if (hsv.value < 0.5) {
+            // reduce brightness when below 0.5 in the V value or increase if > 0.5
+            hsv.value = hsv.value - (hsv.value* ((double)thelayer->contrast / 100.0));
+        } else {
+            hsv.value = hsv.value + (hsv.value* ((double)thelayer->contrast / 100.0));
+        }
+
+        if (hsv.value < 0.0) hsv.value = 0.0;
+        if (hsv.value > 1.0) hsv.value = 1.0;
+        unsigned char alpha = color.Alpha();
+        color = hsv;
+        color.alpha = alpha;
+    } else if (b != 100) {
+        //just brightness
+        float ba = b;
+        ba /= 100.0f;
+        float f = color.red * ba;
+        color.red = std::min((int)f, 255);
+        f = color.green * ba;
+        color.green = std::min((int)f, 255);
+        f = color.blue * ba;
+        color.blue = std::min((int)f, 255);
+    }
+}
+
 void PixelBufferClass::GetMixedColor(int node, xlColor& c, const std::vector<bool> & validLayers, int EffectPeriod)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -508,154 +721,10 @@ void PixelBufferClass::GetMixedColor(int node, xlColor& c, const std::vector<boo
             if (node >= thelayer->buffer.Nodes.size()) {
                 //logger_base.crit("PixelBufferClass::GetMixedColor thelayer->buffer.Nodes does not contain node %d as it is only %d in size ... this was going to crash.", node, thelayer->buffer.Nodes.size());
             } else {
-                int effStartPer, effEndPer;
-                thelayer->buffer.GetEffectPeriods(effStartPer, effEndPer);
-                float offset = ((float)(EffectPeriod - effStartPer)) / ((float)(effEndPer - effStartPer));
-                offset = std::min(offset, 1.0f);
-
                 auto &coord = thelayer->buffer.Nodes[node]->Coords[0];
                 int x = coord.bufX;
                 int y = coord.bufY;
-
-                if (thelayer->isMasked(x, y)
-                    || x < 0
-                    || y < 0
-                    || x >= thelayer->BufferWi
-                    || y >= thelayer->BufferHt
-                    ) {
-                    color.Set(0, 0, 0, 0);
-                } else {
-                    thelayer->buffer.GetPixel(x, y, color);
-                }
-
-                float ha;
-                if (thelayer->HueAdjustValueCurve.IsActive()) {
-                    ha = thelayer->HueAdjustValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS()) / 100.0;
-                } else {
-                    ha = (float)thelayer->hueadjust / 100.0;
-                }
-                float sa;
-                if (thelayer->SaturationAdjustValueCurve.IsActive()) {
-                    sa = thelayer->SaturationAdjustValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS()) / 100.0;
-                } else {
-                    sa = (float)thelayer->saturationadjust / 100.0;
-                }
-                
-                float va;
-                if (thelayer->ValueAdjustValueCurve.IsActive()) {
-                    va = thelayer->ValueAdjustValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS()) / 100.0;
-                } else {
-                    va = (float)thelayer->valueadjust / 100.0;
-                }
-                
-                // adjust for HSV adjustments
-                if (ha != 0 || sa != 0 || va != 0) {
-                    HSVValue hsv = color.asHSV();
-
-                    if (ha != 0) {
-                        hsv.hue += ha;
-                        if (hsv.hue < 0) {
-                            hsv.hue += 1.0;
-                        } else if (hsv.hue > 1) {
-                            hsv.hue -= 1.0;
-                        }
-                    }
-
-                    if (sa != 0) {
-                        hsv.saturation += sa;
-                        if (hsv.saturation < 0) {
-                            hsv.saturation = 0.0;
-                        } else if (hsv.saturation > 1) {
-                            hsv.saturation = 1.0;
-                        }
-                    }
-
-                    if (va != 0) {
-                        hsv.value += va;
-                        if (hsv.value < 0) {
-                            hsv.value = 0.0;
-                        } else if (hsv.value > 1) {
-                            hsv.value = 1.0;
-                        }
-                    }
-
-                    unsigned char alpha = color.Alpha();
-                    color = hsv;
-                    color.alpha = alpha;
-                }
-
-                // add sparkles
-                if (color != xlBLACK &&
-                    (thelayer->use_music_sparkle_count ||
-                        thelayer->sparkle_count > 0 ||
-                        thelayer->SparklesValueCurve.IsActive())) {
-                        
-                    int sc = thelayer->sparkle_count;
-                    if (thelayer->SparklesValueCurve.IsActive()) {
-                        sc = (int)thelayer->SparklesValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS());
-                    }
-                    if (thelayer->use_music_sparkle_count) {
-                        sc = (int)(thelayer->music_sparkle_count_factor * (float)sc);
-                    }
-
-                    switch (sparkle % (208 - sc))
-                    {
-                    case 1:
-                    case 7:
-                        // too dim
-                        //color.Set("#444444");
-                        break;
-                    case 2:
-                    case 6:
-                        color.Set(0x88, 0x88, 0x88);
-                        break;
-                    case 3:
-                    case 5:
-                        color.Set(0xbb, 0xbb, 0xbb);
-                        break;
-                    case 4:
-                        color.Set(255, 255, 255);
-                        break;
-                    default:
-                        break;
-                    }
-                    sparkle++;
-                }
-                int b;
-                if (thelayer->BrightnessValueCurve.IsActive()) {
-                    b = (int)thelayer->BrightnessValueCurve.GetOutputValueAt(offset, thelayer->buffer.GetStartTimeMS(), thelayer->buffer.GetEndTimeMS());
-                } else {
-                    b = thelayer->brightness;
-                }
-                if (thelayer->contrast != 0) {
-                    //contrast is not 0, can handle brightness change at same time
-                    HSVValue hsv = color.asHSV();
-                    hsv.value = hsv.value * ((double)b / 100.0);
-
-                    // Apply Contrast
-                    if (hsv.value < 0.5) {
-                        // reduce brightness when below 0.5 in the V value or increase if > 0.5
-                        hsv.value = hsv.value - (hsv.value* ((double)thelayer->contrast / 100.0));
-                    } else {
-                        hsv.value = hsv.value + (hsv.value* ((double)thelayer->contrast / 100.0));
-                    }
-
-                    if (hsv.value < 0.0) hsv.value = 0.0;
-                    if (hsv.value > 1.0) hsv.value = 1.0;
-                    unsigned char alpha = color.Alpha();
-                    color = hsv;
-                    color.alpha = alpha;
-                } else if (b != 100) {
-                    //just brightness
-                    float ba = b;
-                    ba /= 100.0f;
-                    float f = color.red * ba;
-                    color.red = std::min((int)f, 255);
-                    f = color.green * ba;
-                    color.green = std::min((int)f, 255);
-                    f = color.blue * ba;
-                    color.blue = std::min((int)f, 255);
-                }
+                GetLayerColor(thelayer, x, y, EffectPeriod, sparkle, color);
 
                 if (cnt > 0) {
                     mixColors(x, y, color, c, layer);
@@ -1622,17 +1691,18 @@ void PixelBufferClass::SetLayerSettings(int layer, const SettingsMap &settingsMa
         if (type.compare(0, 9, "Per Model") == 0) {
             inf->usingModelBuffers = true;
             const ModelGroup *gp = dynamic_cast<const ModelGroup*>(model);
-            int cnt = 0;
-            for (auto it = inf->modelBuffers.begin(); it != inf->modelBuffers.end(); ++it, ++cnt) {
-                std::string ntype = type.substr(10, type.length() - 10);
+            std::string ntype = type.substr(10, type.length() - 10);
+            bool allowAlpha = inf->buffer.allowAlpha;
+            parallel_for(0, inf->modelBuffers.size(), [inf, gp, &ntype, &camera, &transform, allowAlpha](int cnt) {
+                RenderBuffer *buf = inf->modelBuffers[cnt].get();
                 int bw, bh;
-                (*it)->Nodes.clear();
-                gp->Models()[cnt]->InitRenderBufferNodes(ntype, camera, transform, (*it)->Nodes, bw, bh);
+                buf->Nodes.clear();
+                gp->Models()[cnt]->InitRenderBufferNodes(ntype, camera, transform, buf->Nodes, bw, bh);
                 if (bw == 0) bw = 1; // zero sized buffers are a problem
                 if (bh == 0) bh = 1;
-                (*it)->InitBuffer(bh, bw, bh, bw, transform);
-                (*it)->SetAllowAlphaChannel(inf->buffer.allowAlpha);
-            }
+                buf->InitBuffer(bh, bw, bh, bw, transform);
+                buf->SetAllowAlphaChannel(allowAlpha);
+            }, PerModelInitStep(gp, camera == "2D" ? 10 : 0)); // 3D cameras share their view matrices so those stay on this thread
         } else {
             inf->usingModelBuffers = false;
         }
@@ -1713,38 +1783,77 @@ static inline bool IsInRange(const std::vector<bool> &restrictRange, size_t star
     return restrictRange[start];
 }
 
+static inline void NodeToChannels(NodeBaseClassPtr &n, unsigned char *fdata) {
+    if (n->model != nullptr) { // I dont like this ... it should never be null
+        DimmingCurve *curve = n->model->modelDimmingCurve;
+        if (curve != nullptr) {
+            if (n->GetChanCount() == 1) {
+                uint8_t buf[3];
+                n->GetForChannels(buf);
+                xlColor color(buf[0], buf[0], buf[0]);
+                curve->apply(color);
+                
+                n->SetColor(color);
+            } else {
+                xlColor color;
+                n->GetColor(color);
+                curve->apply(color);
+                n->SetColor(color);
+            }
+        }
+    }
+    n->GetForChannels(&fdata[n->ActChan]);
+}
+
 void PixelBufferClass::GetColors(unsigned char *fdata, const std::vector<bool> &restrictRange) {
 
     // KW ... I think this needs to be optimised
 
     if (layers[0] != nullptr) { // I dont like this ... it should never be null
         for (auto &n : layers[0]->buffer.Nodes) {
-            size_t start = n->ActChan;
-            if (IsInRange(restrictRange, start)) {
-                if (n->model != nullptr) { // nor this
-                    DimmingCurve *curve = n->model->modelDimmingCurve;
-                    if (curve != nullptr) {
-                        if (n->GetChanCount() == 1) {
-                            uint8_t buf[3];
-                            n->GetForChannels(buf);
-                            xlColor color(buf[0], buf[0], buf[0]);
-                            curve->apply(color);
-                            
-                            n->SetColor(color);
-                        } else {
-                            xlColor color;
-                            n->GetColor(color);
-                            curve->apply(color);
-                            n->SetColor(color);
-                        }
-                    }
-                }
-                n->GetForChannels(&fdata[start]);
+            if (IsInRange(restrictRange, n->ActChan)) {
+                NodeToChannels(n, fdata);
             }
         }
     }
 }
 
+// Each node layer only covers its own node so rather than mixing whole buffers every valid layer mixes
+// its one pixel over what is already in that nodes channels and writes it straight back
+void PixelBufferClass::CalcNodeLayersOutput(int EffectPeriod, const std::vector<bool> &validLayers, unsigned char *fdata, const std::vector<bool> &restrictRange)
+{
+    xlColor color;
+    xlColor bg;
+    for (int layer = 0; layer < numLayers; layer++) {
+        if (!validLayers[layer] || layers[layer]->buffer.Nodes.empty()) {
+            continue;
+        }
+        auto &n = layers[layer]->buffer.Nodes[0];
+        size_t start = n->ActChan;
+        if (!IsInRange(restrictRange, start)) {
+            continue;
+        }
+        PrepareLayerOutput(layer, EffectPeriod);
+
+        if (!n->IsVisible()) {
+            // unmapped pixel - set to black
+            bg = xlBLACK;
+        } else {
+            n->SetFromChannels(&fdata[start]);
+            n->GetColor(bg);
+            DimmingCurve *curve = n->model != nullptr ? n->model->modelDimmingCurve : nullptr;
+            if (curve != nullptr) {
+                curve->reverse(bg);
+            }
+            auto &coord = n->Coords[0];
+            GetLayerColor(layers[layer], coord.bufX, coord.bufY, EffectPeriod, n->sparkle, color);
+            mixColors(coord.bufX, coord.bufY, color, bg, layer);
+        }
+        n->SetColor(bg);
+        NodeToChannels(n, fdata);
+    }
+}
+
 void PixelBufferClass::SetColors(int layer, const unsigned char *fdata)
 {
     xlColor color;
@@ -2006,88 +2115,88 @@ void PixelBufferClass::PrepareVariableSubBuffer(int EffectPeriod, int layer)
     if (layers[layer]->buffer.BufferHt == 0) layers[layer]->buffer.BufferHt = 1;
 }
 
-void PixelBufferClass::CalcOutput(int EffectPeriod, const std::vector<bool> & validLayers, int saveLayer)
+// Blur, rotozoom, fades and transition masks for one layer ready for its pixels to be mixed
+void PixelBufferClass::PrepareLayerOutput(int ii, int EffectPeriod)
 {
     int curStep;
 
-    // blur all the layers if necessary ... before the merge?
-    for (int layer = 0; layer < numLayers; layer++)
+    int effStartPer, effEndPer;
+    layers[ii]->buffer.GetEffectPeriods(effStartPer, effEndPer);
+    float offset = 0.0f;
+    if (effEndPer != effStartPer) {
+        offset = ((float)EffectPeriod - (float)effStartPer) / ((float)effEndPer - (float)effStartPer);
+    }
+    offset = std::min(offset, 1.0f);
+
+    // do gausian blur
+    if (layers[ii]->BlurValueCurve.IsActive() || layers[ii]->blur > 1)
     {
-        int effStartPer, effEndPer;
-        layers[layer]->buffer.GetEffectPeriods(effStartPer, effEndPer);
-        float offset = 0.0f;
-        if (effEndPer != effStartPer) {
-            offset = ((float)EffectPeriod - (float)effStartPer) / ((float)effEndPer - (float)effStartPer);
-        }
-        offset = std::min(offset, 1.0f);
+        Blur(layers[ii], offset);
+    }
+    RotoZoom(layers[ii], offset);
 
-        // do gausian blur
-        if (layers[layer]->BlurValueCurve.IsActive() || layers[layer]->blur > 1)
-        {
-            Blur(layers[layer], offset);
+    if (layers[ii]->use_music_sparkle_count &&
+        layers[ii]->buffer.GetMedia() != nullptr) {
+        float f = 0.0;
+        std::list<float>* pf = layers[ii]->buffer.GetMedia()->GetFrameData(layers[ii]->buffer.curPeriod, FRAMEDATA_HIGH, "");
+        if (pf != nullptr) {
+            f = *pf->begin();
         }
-        RotoZoom(layers[layer], offset);
+        layers[ii]->music_sparkle_count_factor = f;
+    } else {
+        layers[ii]->use_music_sparkle_count = false;
     }
-
-    for(int ii=0; ii < numLayers; ii++)
+    
+    
+    double fadeInFactor=1, fadeOutFactor=1;
+    layers[ii]->fadeFactor = 1.0;
+    layers[ii]->inMaskFactor = 1.0;
+    layers[ii]->outMaskFactor = 1.0;
+    if( layers[ii]->fadeInSteps > 0 || layers[ii]->fadeOutSteps > 0)
     {
-        if (layers[ii]->use_music_sparkle_count &&
-            layers[ii]->buffer.GetMedia() != nullptr) {
-            float f = 0.0;
-            std::list<float>* pf = layers[ii]->buffer.GetMedia()->GetFrameData(layers[ii]->buffer.curPeriod, FRAMEDATA_HIGH, "");
-            if (pf != nullptr) {
-                f = *pf->begin();
-            }
-            layers[ii]->music_sparkle_count_factor = f;
-        } else {
-            layers[ii]->use_music_sparkle_count = false;
+        bool isFirstFrame = (effStartPer == EffectPeriod);
+
+        if (EffectPeriod < (effStartPer)+layers[ii]->fadeInSteps && layers[ii]->fadeInSteps != 0)
+        {
+            curStep = EffectPeriod - effStartPer + 1;
+            fadeInFactor = (double)curStep/(double)layers[ii]->fadeInSteps;
         }
-        
-        
-        double fadeInFactor=1, fadeOutFactor=1;
-        layers[ii]->fadeFactor = 1.0;
-        layers[ii]->inMaskFactor = 1.0;
-        layers[ii]->outMaskFactor = 1.0;
-        if( layers[ii]->fadeInSteps > 0 || layers[ii]->fadeOutSteps > 0)
+        if (EffectPeriod > (effEndPer)-layers[ii]->fadeOutSteps && layers[ii]->fadeOutSteps != 0)
         {
-            int effStartPer, effEndPer;
-            layers[ii]->buffer.GetEffectPeriods(effStartPer, effEndPer);
-            bool isFirstFrame = (effStartPer == EffectPeriod);
-
-            if (EffectPeriod < (effStartPer)+layers[ii]->fadeInSteps && layers[ii]->fadeInSteps != 0)
-            {
-                curStep = EffectPeriod - effStartPer + 1;
-                fadeInFactor = (double)curStep/(double)layers[ii]->fadeInSteps;
-            }
-            if (EffectPeriod > (effEndPer)-layers[ii]->fadeOutSteps && layers[ii]->fadeOutSteps != 0)
-            {
-                curStep = EffectPeriod - (effEndPer-layers[ii]->fadeOutSteps);
-                fadeOutFactor = 1-(double)curStep/(double)layers[ii]->fadeOutSteps;
-            }
-            //calc fades
-            if (STR_FADE == layers[ii]->inTransitionType) {
-                if (fadeInFactor<1) {
-                    layers[ii]->fadeFactor = fadeInFactor;
-                }
-            } else {
-                layers[ii]->inMaskFactor = fadeInFactor;
+            curStep = EffectPeriod - (effEndPer-layers[ii]->fadeOutSteps);
+            fadeOutFactor = 1-(double)curStep/(double)layers[ii]->fadeOutSteps;
+        }
+        //calc fades
+        if (STR_FADE == layers[ii]->inTransitionType) {
+            if (fadeInFactor<1) {
+                layers[ii]->fadeFactor = fadeInFactor;
             }
-            if (STR_FADE == layers[ii]->outTransitionType) {
-                if (fadeOutFactor<1) {
-                    if (STR_FADE == layers[ii]->inTransitionType
-                        && fadeInFactor<1) {
-                        layers[ii]->fadeFactor = (fadeInFactor+fadeOutFactor)/(double)2.0;
-                    } else {
-                        layers[ii]->fadeFactor = fadeOutFactor;
-                    }
+        } else {
+            layers[ii]->inMaskFactor = fadeInFactor;
+        }
+        if (STR_FADE == layers[ii]->outTransitionType) {
+            if (fadeOutFactor<1) {
+                if (STR_FADE == layers[ii]->inTransitionType
+                    && fadeInFactor<1) {
+                    layers[ii]->fadeFactor = (fadeInFactor+fadeOutFactor)/(double)2.0;
+                } else {
+                    layers[ii]->fadeFactor = fadeOutFactor;
                 }
-            } else {
-                layers[ii]->outMaskFactor = fadeOutFactor;
             }
-            layers[ii]->calculateMask(isFirstFrame);
         } else {
-            layers[ii]->mask.clear();
+            layers[ii]->outMaskFactor = fadeOutFactor;
         }
+        layers[ii]->calculateMask(isFirstFrame);
+    } else {
+        layers[ii]->mask.clear();
+    }
+}
+
+void PixelBufferClass::CalcOutput(int EffectPeriod, const std::vector<bool> & validLayers, int saveLayer)
+{
+    for (int layer = 0; layer < numLayers; layer++)
+    {
+        PrepareLayerOutput(layer, EffectPeriod);
     }
 
     // layer calculation and map to output
@@ -242,12 +242,15 @@ private:
     //both fg and bg may be modified, bg will contain the new, mixed color to be the bg for the next mix
     void mixColors(const wxCoord &x, const wxCoord &y, xlColor &fg, xlColor &bg, int layer);
     void reset(int layers, int timing, bool isNode = false);
+    void InitLayer(int layer, bool isNode);
 	void Blur(LayerInfo* layer, float offset);
     void RotoZoom(LayerInfo* layer, float offset);
     void RotateX(LayerInfo* layer, float offset);
     void RotateY(LayerInfo* layer, float offset);
     void RotateZAndZoom(LayerInfo* layer, float offset);
     void GetMixedColor(int node, xlColor& c, const std::vector<bool> & validLayers, int EffectPeriod);
+    void GetLayerColor(LayerInfo *layer, int x, int y, int EffectPeriod, unsigned short &sparkle, xlColor &c);
+    void PrepareLayerOutput(int layer, int EffectPeriod);
 
     std::string modelName;
     std::string lastBufferType;
@@ -287,9 +290,11 @@ public:
     void InitBuffer(const Model &pbc, int layers, int timing, bool zeroBased=false);
     void InitStrandBuffer(const Model &pbc, int strand, int timing, int layers);
     void InitNodeBuffer(const Model &pbc, int strand, int node, int timing);
+    void InitNodeLayersBuffer(const Model &pbc, int strand, const std::vector<int> &nodes, int timing);
     void InitPerModelBuffers(const ModelGroup& model, int layer, int timing);
 
     void Clear(int which);
+    size_t GetMemoryUsage() const;
     
     void SetLayerSettings(int layer, const SettingsMap &settings);
     bool IsPersistent(int layer);
@@ -302,6 +307,7 @@ public:
     void CalcOutput(int EffectPeriod, const std::vector<bool> &validLayers, int saveLayer = 0);
     void SetColors(int layer, const unsigned char *fdata);    
     void GetColors(unsigned char *fdata, const std::vector<bool> &restrictRange);
+    void CalcNodeLayersOutput(int EffectPeriod, const std::vector<bool> &validLayers, unsigned char *fdata, const std::vector<bool> &restrictRange);
 };
 typedef std::unique_ptr<PixelBufferClass> PixelBufferClassPtr;
 
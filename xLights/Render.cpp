@@ -2,6 +2,11 @@
 #include <condition_variable>
 #include <map>
 #include <memory>
+#include <list>
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
 
 #include "xLightsMain.h"
 #include "xLightsXmlFile.h"
@@ -15,10 +20,15 @@
 #include "UtilFunctions.h"
 #include "PixelBuffer.h"
 #include "Parallel.h"
+#include "FSEQFile.h"
 
 #include <log4cpp/Category.hh>
 
 #define END_OF_RENDER_FRAME INT_MAX
+//frames a render job does before going to the back of the queue, matches how often the aggregators pass frames on
+#define RENDER_CHUNK_FRAMES 10
+//how long a job waits for the UI to release a model's layers before going to the back of the queue
+#define RENDER_LOCK_WAIT_MS 5
 
 //other common strings
 static const std::string STR_EMPTY("");
@@ -41,6 +51,7 @@ public:
     void resize(int l) {
         numLayers = l;
         currentEffects.resize(l);
+        currentEffectKeys.resize(l, std::make_pair(-1, -1));
         currentEffectIdxs.resize(l);
         settingsMaps.resize(l);
         effectStates.resize(l);
@@ -51,11 +62,25 @@ public:
     int strand;
     Element *element;
     PixelBufferClassPtr buffer;
+    std::string bufferKey;
     std::vector<Effect*> currentEffects;
+    std::vector<std::pair<int, int>> currentEffectKeys; // id and start time of each current effect so it can be found again after an edit
     std::vector<int> currentEffectIdxs;
     std::vector<SettingsMap> settingsMaps;
     std::vector<bool> effectStates;
     std::vector<bool> validLayers;
+
+    void SetCurrentEffect(int layer, Effect *ef) {
+        currentEffects[layer] = ef;
+        currentEffectKeys[layer] = EffectKey(ef);
+    }
+
+    static std::pair<int, int> EffectKey(const Effect *ef) {
+        if (ef == nullptr) {
+            return std::make_pair(-1, -1);
+        }
+        return std::make_pair(ef->GetID(), ef->GetStartTimeMS());
+    }
 };
 
 class RenderEvent {
@@ -184,46 +209,319 @@ private:
     const int finalFrame;
 };
 
-class SNPair {
+// Tracks the last frame each job of a render has completed.  The watermark is the last frame every
+// job has finished so everything up to it can be consumed while later frames are still rendering.
+class RenderWatermark {
+public:
+    RenderWatermark(int numJobs, int startFrame) : frames(numJobs) {
+        for (auto &f : frames) {
+            f = startFrame - 1;
+        }
+    }
+
+    void FrameDone(int job, int frame) {
+        frames[job] = frame;
+    }
+
+    void JobDone(int job) {
+        frames[job] = END_OF_RENDER_FRAME;
+    }
+
+    int GetWatermark() const {
+        int wm = END_OF_RENDER_FRAME;
+        for (const auto &f : frames) {
+            wm = std::min(wm, f.load());
+        }
+        return wm;
+    }
+
+private:
+    std::vector<std::atomic<int>> frames;
+};
+
+// Appends frames to the fseq as the render watermark passes them so the file is complete
+// shortly after the last frame renders rather than written in one go once the render is done.
+class FSEQStreamWriter {
+public:
+    FSEQStreamWriter(FSEQFile *f, SequenceData &data, std::shared_ptr<RenderWatermark> wm)
+        : file(f), seqData(data), watermark(wm), thread(nullptr), nextFrame(0), framesAfterRender(0), renderDone(false) {
+        thread = new std::thread(&FSEQStreamWriter::WriteFrames, this);
+    }
+
+    ~FSEQStreamWriter() {
+        Finish();
+    }
+
+    // called once the render and anything else changing the data is done, writes the remaining frames
+    void Finish() {
+        if (thread == nullptr) {
+            return;
+        }
+        renderDone = true;
+        thread->join();
+        delete thread;
+        thread = nullptr;
+        file->finalize();
+        delete file;
+        file = nullptr;
+        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        logger_base.debug("Streamed fseq finished, %d frames written after the render completed.", framesAfterRender);
+    }
+
+private:
+    void WriteFrames() {
+        const int numFrames = seqData.NumFrames();
+        while (nextFrame < numFrames) {
+            bool done = renderDone;
+            int wm = done ? numFrames - 1 : std::min(watermark->GetWatermark(), numFrames - 1);
+            if (nextFrame > wm) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+            for (; nextFrame <= wm; ++nextFrame) {
+                file->addFrame(nextFrame, &seqData[nextFrame][0]);
+                if (done) {
+                    ++framesAfterRender;
+                }
+            }
+        }
+    }
+
+    FSEQFile *file;
+    SequenceData &seqData;
+    std::shared_ptr<RenderWatermark> watermark;
+    std::thread *thread;
+    int nextFrame;
+    int framesAfterRender;
+    std::atomic<bool> renderDone;
+};
+
+// Records which thread rendered which frames of each model and when so the scheduling of a render
+// can be looked at after the fact.  Only collected when the render log is at debug level.
+class RenderTrace {
 public:
-    SNPair(int s, int n) : strand(s), node(n) {}
+    static long long Now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
 
-    SNPair(const SNPair &p) : strand(p.strand), node(p.node) {}
+    static bool IsEnabled() {
+        static log4cpp::Category &logger_render = log4cpp::Category::getInstance(std::string("log_render"));
+        return logger_render.isPriorityEnabled(log4cpp::Priority::DEBUG);
+    }
 
-    bool operator>(const SNPair &p) const {
-        return strand > p.strand
-               || (strand == p.strand && node > p.node);
+    static void Clear() {
+        std::unique_lock<std::mutex> lock(traceLock);
+        entries.clear();
+        origin = std::chrono::steady_clock::now();
     }
 
-    bool operator<(const SNPair &p) const {
-        return strand < p.strand
-               || (strand == p.strand && node < p.node);
+    static void Add(const std::string &model, int startFrame, int endFrame, long long start, long long end) {
+        if (!IsEnabled()) return;
+        std::unique_lock<std::mutex> lock(traceLock);
+        if (entries.size() < MAX_ENTRIES) {
+            entries.push_back({ std::this_thread::get_id(), model, startFrame, endFrame, start, end });
+        }
     }
 
-    bool operator==(const SNPair &p) const {
-        return strand == p.strand && node == p.node;
+    static void Dump() {
+        static log4cpp::Category &logger_render = log4cpp::Category::getInstance(std::string("log_render"));
+        std::unique_lock<std::mutex> lock(traceLock);
+        logger_render.debug("Render trace %d tasks: thread, model, start frame, end frame, start us, end us", (int)entries.size());
+        for (const auto &e : entries) {
+            std::ostringstream thread;
+            thread << std::hex << e.thread;
+            logger_render.debug("    %s, %s, %d, %d, %lld, %lld", (const char *)thread.str().c_str(), (const char *)e.model.c_str(), e.startFrame, e.endFrame, e.start, e.end);
+        }
     }
 
-    const int strand;
-    const int node;
+private:
+    struct Entry {
+        std::thread::id thread;
+        std::string model;
+        int startFrame;
+        int endFrame;
+        long long start;
+        long long end;
+    };
+    static const size_t MAX_ENTRIES = 200000;
+    static std::mutex traceLock;
+    static std::vector<Entry> entries;
+    static std::chrono::steady_clock::time_point origin;
 };
 
+std::mutex RenderTrace::traceLock;
+std::vector<RenderTrace::Entry> RenderTrace::entries;
+std::chrono::steady_clock::time_point RenderTrace::origin = std::chrono::steady_clock::now();
+
+// The node layers of one strand render into a single buffer with a one pixel layer per node layer. Each
+// layer keeps the node layers own settings (mix, brightness, transitions) so it is mixed over its node alone.
+class NodeLayersInfo : public EffectLayerInfo {
+public:
+    NodeLayersInfo(int s, const std::vector<int> &n) : EffectLayerInfo(n.size()), nodes(n), effectValidTo(n.size(), -1) {
+        strand = s;
+    }
+
+    std::vector<int> nodes;         // the node each layer renders
+    std::vector<int> effectValidTo; // last frame the current effect of each layer is known to be right for
+};
+
+// Setting up a pixel buffer clones and lays out every node of the model. Interactive editing renders the
+// same models over and over so finished jobs hand their buffers back here for the next job to reuse.
+// The key includes the model and layout change counts so a buffer is never reused for a changed model.
+// Each slot (kind, model, strand, node) only keeps buffers for its latest key and the pool is bounded
+// by the memory the buffers hold, dropping the least recently returned first.
+class PixelBufferPool {
+public:
+    static std::string Key(const char *kind, const Model *model, int strand, int node, int layers, int frameTime, unsigned int modelsChangeCount, const std::string &nodes = "") {
+        // the slot goes before the # and the numbers that make up the rest can never contain one
+        return wxString::Format("%s|%s|%d|%d#%d|%d|%lu|%d|%u|%s", kind, (const char *)model->GetFullName().c_str(), strand, node, layers, frameTime,
+                                model->GetChangeCount(), (int)model->GetNodeCount(), modelsChangeCount, (const char *)nodes.c_str()).ToStdString();
+    }
+
+    // returns nullptr if there is no buffer to reuse
+    static PixelBufferClass *Acquire(const std::string &key) {
+        std::unique_lock<std::mutex> lock(poolLock);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        auto entry = it->second;
+        PixelBufferClass *buffer = entry->buffer.release();
+        poolBytes -= entry->bytes;
+        index.erase(it);
+        entries.erase(entry);
+        // start from a blank canvas just like a new buffer
+        buffer->Clear(-1);
+        return buffer;
+    }
+
+    static void Release(const std::string &key, PixelBufferClass *buffer, unsigned int modelsChangeCount) {
+        if (buffer == nullptr) return;
+        if (key == "") {
+            delete buffer;
+            return;
+        }
+        size_t bytes = buffer->GetMemoryUsage();
+        if (bytes > MAX_POOL_BYTES / 4) {
+            // one buffer this big would push out everything else
+            delete buffer;
+            return;
+        }
+
+        std::string slot = key.substr(0, key.rfind('#'));
+        std::unique_lock<std::mutex> lock(poolLock);
+        if (modelsChangeCount != poolModelsChangeCount) {
+            // the models have been reloaded ... none of the pooled buffers can be used again
+            DoClear();
+            poolModelsChangeCount = modelsChangeCount;
+        }
+
+        // anything in this slot under another key is for an older version of the model or layers
+        int sameKey = 0;
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->slot != slot) {
+                ++it;
+            } else if (it->key != key || ++sameKey >= MAX_PER_KEY) {
+                it = Remove(it);
+            } else {
+                ++it;
+            }
+        }
+
+        entries.push_back(Entry(key, slot, buffer, bytes));
+        index.emplace(key, std::prev(entries.end()));
+        poolBytes += bytes;
+        while (poolBytes > MAX_POOL_BYTES && !entries.empty()) {
+            Remove(entries.begin());
+        }
+    }
+
+    static void Clear() {
+        std::unique_lock<std::mutex> lock(poolLock);
+        DoClear();
+    }
+
+private:
+    class Entry {
+    public:
+        Entry(const std::string &k, const std::string &s, PixelBufferClass *b, size_t by) : key(k), slot(s), buffer(b), bytes(by) {}
+
+        std::string key;
+        std::string slot;
+        PixelBufferClassPtr buffer;
+        size_t bytes;
+    };
+    typedef std::list<Entry>::iterator EntryIt;
+
+    // must hold poolLock
+    static EntryIt Remove(EntryIt it) {
+        auto range = index.equal_range(it->key);
+        for (auto i = range.first; i != range.second; ++i) {
+            if (i->second == it) {
+                index.erase(i);
+                break;
+            }
+        }
+        poolBytes -= it->bytes;
+        return entries.erase(it);
+    }
+    static void DoClear() {
+        index.clear();
+        entries.clear();
+        poolBytes = 0;
+    }
+
+    static const size_t MAX_POOL_BYTES = 512 * 1024 * 1024;
+    static const int MAX_PER_KEY = 2;
+    static std::mutex poolLock;
+    static std::list<Entry> entries; // least recently returned first
+    static std::multimap<std::string, EntryIt> index;
+    static size_t poolBytes;
+    static unsigned int poolModelsChangeCount;
+};
+
+std::mutex PixelBufferPool::poolLock;
+std::list<PixelBufferPool::Entry> PixelBufferPool::entries;
+std::multimap<std::string, PixelBufferPool::EntryIt> PixelBufferPool::index;
+size_t PixelBufferPool::poolBytes = 0;
+unsigned int PixelBufferPool::poolModelsChangeCount = 0;
+
+// Nothing pooled for the closed sequence is worth the memory it holds
+void xLightsFrame::ClearRenderBufferPool()
+{
+    PixelBufferPool::Clear();
+}
+
 
 class RenderJob: public Job, public NextRenderer {
 public:
     RenderJob(ModelElement *row, SequenceData &data, xLightsFrame *xframe, bool zeroBased = false)
         : Job(), NextRenderer(), rowToRender(row), seqData(&data), xLights(xframe),
             gauge(nullptr), currentFrame(0), renderLog(log4cpp::Category::getInstance(std::string("log_render"))),
-            supportsModelBlending(false), abort(false), statusMap(nullptr)
+            supportsModelBlending(false), abort(false), statusMap(nullptr),
+            pool(nullptr), started(false), renderDone(false), waitCounted(false), parked(false),
+            nextFrame(0), origChangeCount(0), watermark(nullptr), watermarkSlot(0)
     {
+        parkedTimer.Pause();
         name = "";
         if (row != nullptr) {
             name = row->GetModelName();
-            mainBuffer = new PixelBufferClass(xframe);
             Model *model = xframe->GetModel(name);
             numLayers = rowToRender->GetEffectLayerCount();
 
-            if (xframe->InitPixelBuffer(name, *mainBuffer, numLayers, zeroBased)) {
+            // zero based buffers are only used for exports so they are not worth keeping
+            mainBuffer = nullptr;
+            if (model != nullptr && !zeroBased) {
+                mainBufferKey = PixelBufferPool::Key("M", model, -1, -1, numLayers, data.FrameTime(), xframe->modelsChangeCount);
+                mainBuffer = PixelBufferPool::Acquire(mainBufferKey);
+            }
+            bool initialised = mainBuffer != nullptr;
+            if (mainBuffer == nullptr) {
+                mainBuffer = new PixelBufferClass(xframe);
+                initialised = xframe->InitPixelBuffer(name, *mainBuffer, numLayers, zeroBased);
+            }
+
+            if (initialised) {
                 if ("ModelGroup" == model->GetDisplayAs()) {
                     //for (int l = 0; l < numLayers; ++l) {
                     for (int l = numLayers - 1; l >= 0; --l) {
@@ -252,30 +550,54 @@ public:
                             if (ste->GetStrand() < model->GetNumStrands()) {
                                 subModelInfos.push_back(new EffectLayerInfo(se->GetEffectLayerCount() + 1));
                                 subModelInfos.back()->element = se;
-                                subModelInfos.back()->buffer.reset(new PixelBufferClass(xframe));
                                 subModelInfos.back()->strand = ste->GetStrand();
-                                subModelInfos.back()->buffer->InitStrandBuffer(*model, ste->GetStrand(), data.FrameTime(), se->GetEffectLayerCount());
+                                if (!zeroBased) {
+                                    subModelInfos.back()->bufferKey = PixelBufferPool::Key("S", model, ste->GetStrand(), -1, se->GetEffectLayerCount(), data.FrameTime(), xframe->modelsChangeCount);
+                                    subModelInfos.back()->buffer.reset(PixelBufferPool::Acquire(subModelInfos.back()->bufferKey));
+                                }
+                                if (subModelInfos.back()->buffer == nullptr) {
+                                    subModelInfos.back()->buffer.reset(new PixelBufferClass(xframe));
+                                    subModelInfos.back()->buffer->InitStrandBuffer(*model, ste->GetStrand(), data.FrameTime(), se->GetEffectLayerCount());
+                                }
                             }
                         } else {
                             Model *subModel = model->GetSubModel(se->GetName());
                             if (subModel != nullptr) {
                                 subModelInfos.push_back(new EffectLayerInfo(se->GetEffectLayerCount() + 1));
                                 subModelInfos.back()->element = se;
-                                subModelInfos.back()->buffer.reset(new PixelBufferClass(xframe));
-                                subModelInfos.back()->buffer->InitBuffer(*subModel, se->GetEffectLayerCount() + 1, data.FrameTime(), false);
+                                if (!zeroBased) {
+                                    subModelInfos.back()->bufferKey = PixelBufferPool::Key("B", subModel, -1, -1, se->GetEffectLayerCount(), data.FrameTime(), xframe->modelsChangeCount);
+                                    subModelInfos.back()->buffer.reset(PixelBufferPool::Acquire(subModelInfos.back()->bufferKey));
+                                }
+                                if (subModelInfos.back()->buffer == nullptr) {
+                                    subModelInfos.back()->buffer.reset(new PixelBufferClass(xframe));
+                                    subModelInfos.back()->buffer->InitBuffer(*subModel, se->GetEffectLayerCount() + 1, data.FrameTime(), false);
+                                }
                             }
                         }
                     }
                     if (se->GetType() == ELEMENT_TYPE_STRAND) {
                         StrandElement *ste = (StrandElement*)se;
                         if (ste->GetStrand() < model->GetNumStrands()) {
-                            for (int n = 0; n < ste->GetNodeLayerCount(); ++n) {
-                                if (n < model->GetStrandLength(ste->GetStrand())) {
-                                    EffectLayer *nl = ste->GetNodeLayer(n);
-                                    if (nl -> GetEffectCount() > 0) {
-                                        nodeBuffers[SNPair(ste->GetStrand(), n)].reset(new PixelBufferClass(xframe));
-                                        nodeBuffers[SNPair(ste->GetStrand(), n)]->InitNodeBuffer(*model, ste->GetStrand(), n, data.FrameTime());
-                                    }
+                            std::vector<int> nodes;
+                            std::string nodeList;
+                            for (int n = 0; n < ste->GetNodeLayerCount() && n < model->GetStrandLength(ste->GetStrand()); ++n) {
+                                if (ste->GetNodeLayer(n)->GetEffectCount() > 0) {
+                                    nodes.push_back(n);
+                                    nodeList += std::to_string(n) + ",";
+                                }
+                            }
+                            if (!nodes.empty()) {
+                                nodeInfos.push_back(std::unique_ptr<NodeLayersInfo>(new NodeLayersInfo(ste->GetStrand(), nodes)));
+                                NodeLayersInfo *info = nodeInfos.back().get();
+                                info->element = se;
+                                if (!zeroBased) {
+                                    info->bufferKey = PixelBufferPool::Key("N", model, ste->GetStrand(), -1, nodes.size(), data.FrameTime(), xframe->modelsChangeCount, nodeList);
+                                    info->buffer.reset(PixelBufferPool::Acquire(info->bufferKey));
+                                }
+                                if (info->buffer == nullptr) {
+                                    info->buffer.reset(new PixelBufferClass(xframe));
+                                    info->buffer->InitNodeLayersBuffer(*model, ste->GetStrand(), nodes, data.FrameTime());
                                 }
                             }
                         }
@@ -293,13 +615,17 @@ public:
     }
 
     virtual ~RenderJob() {
-        if (mainBuffer != nullptr) {
-            delete mainBuffer;
-        }
+        // hand the buffers back so the next render of this model can skip setting them up
+        unsigned int mcc = xLights->modelsChangeCount;
+        PixelBufferPool::Release(mainBufferKey, mainBuffer, mcc);
         for (auto a = subModelInfos.begin(); a != subModelInfos.end(); ++a) {
             EffectLayerInfo *info = *a;
+            PixelBufferPool::Release(info->bufferKey, info->buffer.release(), mcc);
             delete info;
         }
+        for (auto it = nodeInfos.begin(); it != nodeInfos.end(); ++it) {
+            PixelBufferPool::Release((*it)->bufferKey, (*it)->buffer.release(), mcc);
+        }
     }
 
     wxGauge *GetGauge() const { return gauge;}
@@ -511,7 +837,7 @@ public:
             std::unique_lock<std::recursive_mutex> elayerLock(elayer->GetLock());
             Effect *ef = findEffectForFrame(elayer, frame, info.currentEffectIdxs[layer]);
             if (ef != info.currentEffects[layer]) {
-                info.currentEffects[layer] = ef;
+                info.SetCurrentEffect(layer, ef);
                 SetInializingStatus(frame, layer, strand);
                 initialize(layer, frame, ef, info.settingsMaps[layer], buffer);
                 info.effectStates[layer] = true;
@@ -601,27 +927,125 @@ public:
         return effectsToUpdate;
     }
 
+    void Schedule(JobPool &p) {
+        pool = &p;
+        pool->PushJob(this);
+    }
+
+    void SetWatermark(RenderWatermark *wm, int slot) {
+        watermark = wm;
+        watermarkSlot = slot;
+    }
+
+    virtual void setPreviousFrameDone(int frame) override {
+        std::unique_lock<std::mutex> lock(nextLock);
+        previousFrameDone = frame;
+        nextSignal.notify_all();
+        if (parked && frame >= nextFrame) {
+            //the frames we were waiting on are now available, put us back on the queue
+            parked = false;
+            lock.unlock();
+            pool->PushJob(this);
+        }
+    }
+
+    // Each call renders at most RENDER_CHUNK_FRAMES frames and then puts the job back on the queue.  If
+    // the frames from the models before us are not ready yet the job is parked rather than blocking the
+    // thread and setPreviousFrameDone will queue it again once they are.
     virtual void Process() override {
-        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        if (!started) {
+            SetGenericStatus("Initializing rendering thread for %s", 0);
+            if (!ClaimRow()) {
+                //another render of this model is running, it will queue us again when it is done
+                return;
+            }
+            SetGenericStatus("Got lock on rendering thread for %s", 0);
+            StartRender();
+        }
+
+        //RenderChunk queues or parks the job itself when there is more to do, at which point another
+        //thread may already be running it so nothing here can touch the job afterwards
+        if (renderDone || RenderChunk()) {
+            FinishRender();
+        }
+    }
+
+    void AbortRender() {
+        abort = true;
+    }
+
+    ModelElement* GetModelElement() const { return rowToRender; }
+
+private:
+
+    bool ClaimRow() {
+        std::unique_lock<std::mutex> lock(renderOwnersLock);
+        if (!waitCounted) {
+            rowToRender->IncWaitCount();
+            waitCounted = true;
+        }
+        auto it = renderOwners.find(rowToRender);
+        if (it != renderOwners.end() && it->second != this) {
+            renderWaiters[rowToRender].push_back(this);
+            return false;
+        }
+        renderOwners[rowToRender] = this;
+        return true;
+    }
+
+    //another render of this row is queued which covers some of the frames we have left so it will redo them,
+    //renders queued for other intervals of the row don't stop us
+    bool IsSupersededByWaiter(int frame) {
+        if (rowToRender->GetWaitCount() <= 1) {
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(renderOwnersLock);
+        auto it = renderWaiters.find(rowToRender);
+        if (it == renderWaiters.end()) {
+            return false;
+        }
+        for (auto job : it->second) {
+            if (job->startFrame <= endFrame && job->endFrame >= frame) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ReleaseRow() {
+        std::list<RenderJob*> waiting;
+        {
+            std::unique_lock<std::mutex> lock(renderOwnersLock);
+            renderOwners.erase(rowToRender);
+            auto it = renderWaiters.find(rowToRender);
+            if (it != renderWaiters.end()) {
+                waiting.swap(it->second);
+                renderWaiters.erase(it);
+            }
+        }
+        for (auto job : waiting) {
+            job->pool->PushJob(job);
+        }
+    }
 
-        SetGenericStatus("Initializing rendering thread for %s", 0);
-        int maxFrameBeforeCheck = -1;
-        int origChangeCount;
-        int ss, es;
+    void StartRender() {
+        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
-        rowToRender->IncWaitCount();
+        started = true;
         std::unique_lock<std::recursive_timed_mutex> lock(rowToRender->GetRenderLock());
-        rowToRender->DecWaitCount();
-        SetGenericStatus("Got lock on rendering thread for %s", 0);
+        GetLayerStructure(layerStructure);
 
-        rowToRender->GetAndResetDirtyRange(origChangeCount, ss, es);
-        if (ss != -1) {
+        //only pick up the dirty intervals this job touches, ones elsewhere in the sequence are left
+        //for the render that covers them rather than stretching this job over everything between
+        std::list<std::pair<int, int>> dirty;
+        rowToRender->GetAndResetDirtyRanges(origChangeCount, startFrame * seqData->FrameTime(), (endFrame + 1) * seqData->FrameTime() - 1, dirty);
+        for (const auto &r : dirty) {
             //expand to cover the whole dirty range
-            ss = ss / seqData->FrameTime();
+            int ss = r.first / seqData->FrameTime();
             if (ss < 0) {
                 ss = 0;
             }
-            es = es / seqData->FrameTime();
+            int es = r.second / seqData->FrameTime();
             if (es > seqData->NumFrames()) {
                 es = seqData->NumFrames();
             }
@@ -634,149 +1058,303 @@ public:
         }
         if (startFrame < 0) startFrame = 0;
         if (endFrame > seqData->NumFrames()) endFrame = seqData->NumFrames() - 1;
+        nextFrame = startFrame;
 
-        EffectLayerInfo mainModelInfo(numLayers);
-        std::map<SNPair, Effect*> nodeEffects;
-        std::map<SNPair, SettingsMap> nodeSettingsMaps;
-        std::map<SNPair, bool> nodeEffectStates;
-        std::map<SNPair, int> nodeEffectIdxs;
-
+        mainModelInfo.resize(numLayers);
         try {
             //for (int layer = 0; layer < numLayers; ++layer) {
             for (int layer = numLayers - 1; layer >= 0; --layer) {
                 wxString msg = wxString::Format("Finding starting effect for %s, layer %d and startFrame %d", name, layer, startFrame) + PrintStatusMap();
                 SetStatus(msg);
-                
+
                 EffectLayer *elayer = rowToRender->GetEffectLayer(layer);
                 std::unique_lock<std::recursive_mutex> elock(elayer->GetLock());
-                mainModelInfo.currentEffects[layer] = findEffectForFrame(elayer, startFrame, mainModelInfo.currentEffectIdxs[layer]);
+                mainModelInfo.SetCurrentEffect(layer, findEffectForFrame(elayer, startFrame, mainModelInfo.currentEffectIdxs[layer]));
                 msg = wxString::Format("Initializing starting effect for %s, layer %d and startFrame %d", name, layer, startFrame) + PrintStatusMap();
                 SetStatus(msg);
                 initialize(layer, startFrame, mainModelInfo.currentEffects[layer], mainModelInfo.settingsMaps[layer], mainBuffer);
                 mainModelInfo.effectStates[layer] = true;
             }
+        } catch ( std::exception &ex) {
+            wxASSERT(false); // so when we debug we catch them
+            renderLog.error("Caught an exception on rendering thread: " + std::string(ex.what()));
+            logger_base.error("Caught an exception on rendering thread: %s", ex.what());
+            renderDone = true;
+        } catch ( ... ) {
+            wxASSERT(false); // so when we debug we catch them
+            renderLog.error("Caught an unknown exception on rendering thread.");
+            logger_base.error("Caught an unknown exception on rendering thread.");
+            renderDone = true;
+        }
+    }
 
-            for (int frame = startFrame; frame <= endFrame; ++frame) {
-                currentFrame = frame;
-                SetGenericStatus("%s: Starting frame %d " + PrintStatusMap(), frame, true);
-
-                if (abort) {
-                    break;
-                }
-
-                if (!HasNext() &&
-                        (origChangeCount != rowToRender->getChangeCount()
-                         || rowToRender->GetWaitCount())) {
-                    //we're bailing out but make sure this range is reconsidered
-                    rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
-                    break;
-                }
-                //make sure we can do this frame
-                if (frame >= maxFrameBeforeCheck) {
-                    wxStopWatch sw;
-                    maxFrameBeforeCheck = waitForFrame(frame);
+    bool RenderChunk() {
+        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
-                    if (sw.Time() > 500)
-                    {
-                        renderLog.info("Model %s rendering frame %d waited %dms waiting for other models to finish.", (const char *)(mainModelInfo.element != nullptr) ? mainModelInfo.element->GetName().c_str() : "", frame, sw.Time());
-                    }
-                }
-                bool cleared = ProcessFrame(frame, rowToRender, mainModelInfo, mainBuffer, -1, supportsModelBlending);
-                if (!subModelInfos.empty()) {
-                    for (auto a = subModelInfos.begin(); a != subModelInfos.end(); ++a) {
-                        EffectLayerInfo *info = *a;
-                        cleared |= ProcessFrame(frame, info->element, *info, info->buffer.get(), info->strand, supportsModelBlending ? true : cleared);
-                    }
-                }
-                if (!nodeBuffers.empty()) {
-                    for (std::map<SNPair, PixelBufferClassPtr>::iterator it = nodeBuffers.begin(); it != nodeBuffers.end(); ++it) {
-                        SNPair node = it->first;
-                        PixelBufferClass *buffer = it->second.get();
+        int frame = nextFrame;
+        int lastFrame = std::min(frame + RENDER_CHUNK_FRAMES - 1, endFrame);
+        if (abort || frame > endFrame) {
+            renderDone = true;
+            return true;
+        }
 
-                        if (buffer == nullptr)
-                        {
-                            logger_base.crit("RenderJob::Process PixelBufferPointer is null ... this is going to crash.");
-                        }
+        {
+            //make sure we can do these frames
+            std::unique_lock<std::mutex> lock(nextLock);
+            if (previousFrameDone < frame) {
+                SetGenericStatus("%s: Waiting on previous renderer for frame %d", frame, true);
+                parkedTimer.Start();
+                parked = true;
+                return false;
+            }
+            if (previousFrameDone < lastFrame) {
+                lastFrame = previousFrameDone;
+            }
+        }
+        if (parkedTimer.Time() > 500) {
+            renderLog.info("Model %s rendering frame %d waited %dms waiting for other models to finish.", (const char *)name.c_str(), frame, parkedTimer.Time());
+        }
+        parkedTimer.Start();
+        parkedTimer.Pause();
 
-                        int strand = node.strand;
-                        int inode = node.node;
-                        StrandElement *slayer = rowToRender->GetStrand(strand);
-                        if (slayer == nullptr) {
-                            //deleted strand
-                            continue;
-                        }
-                        EffectLayer *nlayer = slayer->GetNodeLayer(inode, false);
-                        if (nlayer == nullptr) {
-                            //deleted node
-                            continue;
-                        }
-                        std::unique_lock<std::recursive_mutex> nlayerLock(nlayer->GetLock());
-                        Effect *el = findEffectForFrame(nlayer, frame, nodeEffectIdxs[node]);
-                        if (el != nodeEffects[node] || frame == startFrame) {
-                            nodeEffects[node] = el;
-                            SetInializingStatus(frame, -1, strand, inode);
-                            initialize(0, frame, el, nodeSettingsMaps[node], buffer);
-                            nodeEffectStates[node] = true;
-                        }
-                        bool persist=buffer->IsPersistent(0);
-                        if (!persist || nodeEffects[node] == nullptr || nodeEffects[node]->GetEffectIndex() == -1) {
-                            buffer->Clear(0);
-                        }
+        //the row lock stops the layers being changed while we are in the middle of a frame,
+        //if the UI has it give it a moment and then go to the back of the queue rather than hold the thread
+        std::unique_lock<std::recursive_timed_mutex> lock(rowToRender->GetRenderLock(), std::defer_lock);
+        if (!lock.try_lock_for(std::chrono::milliseconds(RENDER_LOCK_WAIT_MS))) {
+            pool->PushJob(this);
+            return false;
+        }
 
-                        SetRenderingStatus(frame, &nodeSettingsMaps[node], -1, strand, inode, cleared);
-                        if (xLights->RenderEffectFromMap(el, 0, frame, nodeSettingsMaps[node], *buffer, nodeEffectStates[node], true, &renderEvent)) {
-                            SetCalOutputStatus(frame, strand, inode);
-                            //copy to output
-                            std::vector<bool> valid(2, true);
-                            buffer->SetColors(1, &((*seqData)[frame][0]));
-                            buffer->CalcOutput(frame, valid);
-                            buffer->GetColors(&((*seqData)[frame][0]), rangeRestriction);
-                        }
-                    }
-                }
-                //mainBuffer->ApplyDimmingCurves(&((*seqData)[frame][0]));
-                if (HasNext()) {
-                    SetGenericStatus("%s: Notifying next renderer of frame %d done", frame);
-                    FrameDone(frame);
+        if (origChangeCount != rowToRender->getChangeCount() || IsSupersededByWaiter(frame)) {
+            std::vector<EffectLayer*> layers;
+            GetLayerStructure(layers);
+            if (!HasNext() || layers != layerStructure) {
+                //we're bailing out but make sure this range is reconsidered
+                rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                renderDone = true;
+                return true;
+            }
+            if (origChangeCount != rowToRender->getChangeCount()) {
+                //effects were changed between chunks, find them again from the start of each layer
+                if (!ResetEffectIndexes(frame)) {
+                    //an effect we were part way through has changed, carrying on would restart it part way
+                    //through so leave the rest of the range to a new render
+                    rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                    renderDone = true;
+                    return true;
                 }
+                origChangeCount = rowToRender->getChangeCount();
+            }
+        }
+
+        auto traceStart = RenderTrace::Now();
+        try {
+            for (; frame <= lastFrame; ++frame) {
+                currentFrame = frame;
+                SetGenericStatus("%s: Starting frame %d " + PrintStatusMap(), frame, true);
+                RenderFrame(frame);
             }
         } catch ( std::exception &ex) {
             wxASSERT(false); // so when we debug we catch them
             printf("Caught an exception %s", ex.what());
-			renderLog.error("Caught an exception on rendering thread: " + std::string(ex.what()));
+            renderLog.error("Caught an exception on rendering thread: " + std::string(ex.what()));
             logger_base.error("Caught an exception on rendering thread: %s", ex.what());
-		} catch ( ... ) {
+            renderDone = true;
+        } catch ( ... ) {
             wxASSERT(false); // so when we debug we catch them
             printf("Caught an unknown exception");
-			renderLog.error("Caught an unknown exception on rendering thread.");
+            renderLog.error("Caught an unknown exception on rendering thread.");
             logger_base.error("Caught an unknown exception on rendering thread.");
+            renderDone = true;
+        }
+        RenderTrace::Add(name, nextFrame, frame - 1, traceStart, RenderTrace::Now());
+        nextFrame = frame;
+        if (watermark != nullptr) {
+            watermark->FrameDone(watermarkSlot, frame - 1);
+        }
+
+        if (frame > endFrame) {
+            renderDone = true;
+        }
+        if (renderDone) {
+            return true;
         }
+        lock.unlock();
+        pool->PushJob(this);
+        return false;
+    }
+
+    void RenderFrame(int frame) {
+        bool cleared = ProcessFrame(frame, rowToRender, mainModelInfo, mainBuffer, -1, supportsModelBlending);
+        if (!subModelInfos.empty()) {
+            for (auto a = subModelInfos.begin(); a != subModelInfos.end(); ++a) {
+                EffectLayerInfo *info = *a;
+                cleared |= ProcessFrame(frame, info->element, *info, info->buffer.get(), info->strand, supportsModelBlending ? true : cleared);
+            }
+        }
+        for (auto &info : nodeInfos) {
+            RenderNodeLayers(frame, info.get());
+        }
+        //mainBuffer->ApplyDimmingCurves(&((*seqData)[frame][0]));
         if (HasNext()) {
-            //make sure the previous has told us we're at the end.  If we return before waiting, the previous
+            SetGenericStatus("%s: Notifying next renderer of frame %d done", frame);
+            FrameDone(frame);
+        }
+    }
+
+    // Renders each node layer of the strand into its layer of the strand buffer and then mixes them all over
+    // the nodes in one pass
+    void RenderNodeLayers(int frame, NodeLayersInfo *info) {
+        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+        StrandElement *slayer = rowToRender->GetStrand(info->strand);
+        if (slayer == nullptr) {
+            //deleted strand
+            return;
+        }
+        PixelBufferClass *buffer = info->buffer.get();
+        if (buffer == nullptr) {
+            logger_base.crit("RenderJob::Process PixelBufferPointer is null ... this is going to crash.");
+        }
+
+        bool effectsToUpdate = false;
+        for (int layer = 0; layer < info->numLayers; ++layer) {
+            info->validLayers[layer] = false;
+            EffectLayer *nlayer = slayer->GetNodeLayer(info->nodes[layer], false);
+            if (nlayer == nullptr) {
+                //deleted node
+                continue;
+            }
+            Effect *el = info->currentEffects[layer];
+            if (frame > info->effectValidTo[layer]) {
+                el = findNodeEffectForFrame(nlayer, frame, info->effectValidTo[layer]);
+            }
+            if (el == nullptr && info->currentEffects[layer] == nullptr && frame != startFrame) {
+                // nothing on this node and the layer was cleared when the last effect ended
+                continue;
+            }
+            if (el != info->currentEffects[layer] || frame == startFrame) {
+                info->SetCurrentEffect(layer, el);
+                SetInializingStatus(frame, layer, info->strand, info->nodes[layer]);
+                initialize(layer, frame, el, info->settingsMaps[layer], buffer);
+                info->effectStates[layer] = true;
+            }
+            bool persist = buffer->IsPersistent(layer);
+            if (!persist || el == nullptr || el->GetEffectIndex() == -1) {
+                buffer->Clear(layer);
+            }
+            if (el == nullptr) {
+                continue;
+            }
+
+            SetRenderingStatus(frame, &info->settingsMaps[layer], layer, info->strand, info->nodes[layer]);
+            bool b = info->effectStates[layer];
+            info->validLayers[layer] = xLights->RenderEffectFromMap(el, layer, frame, info->settingsMaps[layer], *buffer, b, true, &renderEvent);
+            info->effectStates[layer] = b;
+            effectsToUpdate |= info->validLayers[layer];
+        }
+
+        if (effectsToUpdate) {
+            SetCalOutputStatus(frame, info->strand);
+            buffer->CalcNodeLayersOutput(frame, info->validLayers, &((*seqData)[frame][0]), rangeRestriction);
+        }
+    }
+
+    void FinishRender() {
+        if (HasNext()) {
+            //make sure the previous has told us we're at the end.  If we finish before that, the previous
             //may try sending the END_OF_RENDER_FRAME to us and we'll have been deleted
-            SetGenericStatus("%s: Waiting on previous renderer for final frame", 0);
-            waitForFrame(END_OF_RENDER_FRAME);
+            std::unique_lock<std::mutex> lock(nextLock);
+            if (previousFrameDone != END_OF_RENDER_FRAME) {
+                SetGenericStatus("%s: Waiting on previous renderer for final frame", 0);
+                nextFrame = END_OF_RENDER_FRAME;
+                parked = true;
+                return;
+            }
+        }
+
+        {
+            std::unique_lock<std::recursive_timed_mutex> lock(rowToRender->GetRenderLock());
+            rowToRender->CleanupAfterRender();
+        }
+        ReleaseRow();
+        rowToRender->DecWaitCount();
+        if (watermark != nullptr) {
+            watermark->JobDone(watermarkSlot);
+        }
+        //printf("Done rendering %lx (next %lx)\n", (unsigned long)this, (unsigned long)next);
+        renderLog.debug("Rendering thread exiting.");
 
+        if (HasNext()) {
             //let the next know we're done
             SetGenericStatus("%s: Notifying next renderer of final frame", 0);
-            FrameDone(END_OF_RENDER_FRAME);
             xLights->CallAfter(&xLightsFrame::SetStatusText, wxString("Done Rendering " + rowToRender->GetModelName()), 0);
+            FrameDone(END_OF_RENDER_FRAME);
         } else {
             xLights->CallAfter(&xLightsFrame::RenderDone);
         }
-        rowToRender->CleanupAfterRender();
         currentFrame = END_OF_RENDER_FRAME;
-        //printf("Done rendering %lx (next %lx)\n", (unsigned long)this, (unsigned long)next);
-		renderLog.debug("Rendering thread exiting.");
-	}
+    }
 
-    void AbortRender() {
-        abort = true;
+    //the effects may have been deleted so forget where they were and find the ones rendered on the last frame
+    //again. When they are the same effects they carry on with their state, false if any of them has gone or
+    //changed as it can't carry on without restarting
+    bool ResetEffectIndexes(int frame) {
+        bool same = true;
+        for (size_t l = 0; l < mainModelInfo.currentEffects.size(); ++l) {
+            same &= FindCurrentEffect(l < rowToRender->GetEffectLayerCount() ? rowToRender->GetEffectLayer(l) : nullptr, frame, mainModelInfo, l);
+        }
+        for (auto info : subModelInfos) {
+            for (size_t l = 0; l < info->currentEffects.size(); ++l) {
+                same &= FindCurrentEffect(l < info->element->GetEffectLayerCount() ? info->element->GetEffectLayer(l) : nullptr, frame, *info, l);
+            }
+        }
+        for (auto &info : nodeInfos) {
+            StrandElement *slayer = rowToRender->GetStrand(info->strand);
+            for (size_t l = 0; l < info->currentEffects.size(); ++l) {
+                same &= FindCurrentEffect(slayer == nullptr ? nullptr : slayer->GetNodeLayer(info->nodes[l], false), frame, *info, l);
+                info->effectValidTo[l] = -1;
+            }
+        }
+        return same;
     }
 
-    ModelElement* GetModelElement() const { return rowToRender; }
+    bool FindCurrentEffect(EffectLayer *layer, int frame, EffectLayerInfo &info, int l) {
+        info.currentEffectIdxs[l] = 0;
+        Effect *ef = nullptr;
+        if (layer != nullptr && frame > startFrame) {
+            std::unique_lock<std::recursive_mutex> lock(layer->GetLock());
+            ef = findEffectForFrame(layer, frame - 1, info.currentEffectIdxs[l]);
+        }
+        bool same = frame == startFrame || EffectLayerInfo::EffectKey(ef) == info.currentEffectKeys[l];
+        info.SetCurrentEffect(l, ef);
+        return same;
+    }
 
-private:
+    //the layers the buffers were set up for, any layer added, removed or gaining its first effect means
+    //they no longer match. Each submodel/strand is separated by a nullptr so layers can't shift between them
+    void GetLayerStructure(std::vector<EffectLayer*> &layers) const {
+        layers.clear();
+        for (size_t l = 0; l < rowToRender->GetEffectLayerCount(); ++l) {
+            layers.push_back(rowToRender->GetEffectLayer(l));
+        }
+        for (int x = 0; x < rowToRender->GetSubModelAndStrandCount(); ++x) {
+            SubModelElement *se = rowToRender->GetSubModel(x);
+            layers.push_back(nullptr);
+            if (se->HasEffects()) {
+                for (size_t l = 0; l < se->GetEffectLayerCount(); ++l) {
+                    layers.push_back(se->GetEffectLayer(l));
+                }
+            }
+            if (se->GetType() == ELEMENT_TYPE_STRAND) {
+                StrandElement *ste = (StrandElement*)se;
+                for (int n = 0; n < ste->GetNodeLayerCount(); ++n) {
+                    NodeLayer *nl = ste->GetNodeLayer(n);
+                    layers.push_back(nl->GetEffectCount() > 0 ? nl : nullptr);
+                }
+            }
+        }
+    }
 
     void initialize(int layer, int frame, Effect *el, SettingsMap &settingsMap, PixelBufferClass *buffer) {
         if (el == nullptr || el->GetEffectIndex() == -1) {
@@ -812,6 +1390,27 @@ private:
         return nullptr;
     }
 
+    // Node layers only look up their effect when the last answer runs out, so the layer lock is taken as
+    // a node moves on to or off an effect rather than for every node every frame
+    Effect *findNodeEffectForFrame(EffectLayer* layer, int frame, int &validTo) {
+        std::unique_lock<std::recursive_mutex> lock(layer->GetLock());
+        int frameTime = seqData->FrameTime();
+        int time = frame * frameTime;
+        validTo = endFrame;
+        for (int e = 0; e < layer->GetEffectCount(); ++e) {
+            Effect *effect = layer->GetEffect(e);
+            int st = effect->GetStartTimeMS();
+            int et = effect->GetEndTimeMS();
+            if (et > time && st <= time) {
+                validTo = (et - 1) / frameTime;
+                return effect;
+            } else if (st > time) {
+                validTo = std::min(validTo, (st - 1) / frameTime);
+            }
+        }
+        return nullptr;
+    }
+
     Effect *findEffectForFrame(int layer, int frame, int &lastIdx) {
         return findEffectForFrame(rowToRender->GetEffectLayer(layer), frame, lastIdx);
     }
@@ -828,6 +1427,7 @@ private:
     int startFrame;
     int endFrame;
     PixelBufferClass *mainBuffer;
+    std::string mainBufferKey;
     int numLayers;
     xLightsFrame *xLights;
     SequenceData *seqData;
@@ -852,9 +1452,32 @@ private:
 
     std::vector<EffectLayerInfo *> subModelInfos;
 
-    std::map<SNPair, PixelBufferClassPtr> nodeBuffers;
+    std::vector<std::unique_ptr<NodeLayersInfo>> nodeInfos;
+
+    //render state carried between chunks
+    JobPool *pool;
+    bool started;
+    bool renderDone;
+    bool waitCounted;
+    bool parked;
+    int nextFrame;
+    int origChangeCount;
+    std::vector<EffectLayer*> layerStructure;
+    RenderWatermark *watermark;
+    int watermarkSlot;
+    wxStopWatch parkedTimer;
+    EffectLayerInfo mainModelInfo;
+
+    //only one job may render a given model at a time
+    static std::mutex renderOwnersLock;
+    static std::map<ModelElement*, RenderJob*> renderOwners;
+    static std::map<ModelElement*, std::list<RenderJob*>> renderWaiters;
 };
 
+std::mutex RenderJob::renderOwnersLock;
+std::map<ModelElement*, RenderJob*> RenderJob::renderOwners;
+std::map<ModelElement*, std::list<RenderJob*>> RenderJob::renderWaiters;
+
 
 IMPLEMENT_DYNAMIC_CLASS(RenderCommandEvent, wxCommandEvent)
 IMPLEMENT_DYNAMIC_CLASS(SelectedEffectChangedEvent, wxCommandEvent)
@@ -904,6 +1527,7 @@ public:
         numRows = 0;
         startFrame = 0;
         endFrame = 0;
+        renderedFrame = -1;
         jobs = nullptr;
         aggregators = nullptr;
         renderProgressDialog = nullptr;
@@ -912,8 +1536,10 @@ public:
     int numRows;
     int startFrame;
     int endFrame;
+    int renderedFrame; // every job has finished the frames before this one
     RenderJob **jobs;
     AggregatorRenderer **aggregators;
+    std::shared_ptr<RenderWatermark> watermark;
     RenderProgressDialog *renderProgressDialog;
     std::list<Model *> restriction;
 };
@@ -955,6 +1581,7 @@ void xLightsFrame::LogRenderStatus()
         }
     }
     logger_base.debug("*************************************");
+    RenderTrace::Dump();
 }
 
 static bool HasEffects(ModelElement *me) {
@@ -1007,6 +1634,9 @@ void xLightsFrame::UpdateRenderStatus() {
 
         int frames = rpi->endFrame - rpi->startFrame + 1;
         if( frames <= 0 ) frames = 1;
+        int firstJobFrame = INT_MAX;
+        int lastJobFrame = -1;
+        int completeTo = INT_MAX;
         for (size_t row = 0; row < rpi->numRows; ++row) {
 
             if (rpi->jobs[row]) {
@@ -1014,6 +1644,9 @@ void xLightsFrame::UpdateRenderStatus() {
                 if (i > rpi->jobs[row]->GetEndFrame()) {
                     i = END_OF_RENDER_FRAME;
                 }
+                firstJobFrame = std::min(firstJobFrame, rpi->jobs[row]->GetStartFrame());
+                lastJobFrame = std::max(lastJobFrame, rpi->jobs[row]->GetEndFrame());
+                completeTo = std::min(completeTo, i == END_OF_RENDER_FRAME ? rpi->jobs[row]->GetEndFrame() + 1 : i);
                 if (i != END_OF_RENDER_FRAME) {
                     done = false;
                 }
@@ -1057,6 +1690,20 @@ void xLightsFrame::UpdateRenderStatus() {
             }
         }
 
+        // let the grid pick up node values for the frames that are now fully rendered
+        if (lastJobFrame >= 0) {
+            if (rpi->renderedFrame < 0) {
+                rpi->renderedFrame = firstJobFrame;
+            }
+            if (done) {
+                completeTo = lastJobFrame + 1;
+            }
+            if (completeTo > rpi->renderedFrame) {
+                mainSequencer->PanelEffectGrid->NodeValuesChanged(rpi->renderedFrame, completeTo - 1);
+                rpi->renderedFrame = completeTo;
+            }
+        }
+
         if (done) {
             for (size_t row = 0; row < rpi->numRows; ++row) {
                 if (rpi->jobs[row]) {
@@ -1115,17 +1762,6 @@ public:
         ranges.push_back(NodeRange(start, end));
     }
 
-    bool Overlaps(RenderTreeData &e) {
-        for (auto it = ranges.begin(); it != ranges.end(); ++it) {
-            for (auto it2 = e.ranges.begin(); it2 != e.ranges.end(); ++it2) {
-                if (it->Overlaps(*it2)) {
-                    return true;
-                }
-            }
-        }
-        return false;
-    }
-
     static void sortRanges(std::list<NodeRange> &ranges) {
         ranges.sort();
         auto it = ranges.begin();
@@ -1160,6 +1796,44 @@ public:
     Model *model;
 };
 
+// Finds every pair of entries whose channel ranges overlap.  All the ranges are swept in start channel
+// order keeping the ones still open keyed by their end channel, so each range only needs comparing with
+// ranges it actually overlaps rather than with every range of every other entry.
+// Returns the overlapping pairs as (lower index, higher index) sorted with no duplicates.
+static std::vector<std::pair<int, int>> FindOverlappingRanges(const std::vector<const std::list<NodeRange>*> &entries) {
+    struct Interval {
+        unsigned int start;
+        unsigned int end;
+        int entry;
+    };
+    std::vector<Interval> intervals;
+    for (int i = 0; i < (int)entries.size(); ++i) {
+        for (const auto &r : *entries[i]) {
+            intervals.push_back({ r.start, r.end, i });
+        }
+    }
+    std::sort(intervals.begin(), intervals.end(), [](const Interval &a, const Interval &b) {
+        return a.start < b.start;
+    });
+
+    std::vector<std::pair<int, int>> pairs;
+    std::multimap<unsigned int, int> open;
+    for (const auto &i : intervals) {
+        while (!open.empty() && open.begin()->first < i.start) {
+            open.erase(open.begin());
+        }
+        for (const auto &o : open) {
+            if (o.second != i.entry) {
+                pairs.push_back(std::make_pair(std::min(o.second, i.entry), std::max(o.second, i.entry)));
+            }
+        }
+        open.insert(std::make_pair(i.end, i.entry));
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    return pairs;
+}
+
 void xLightsFrame::RenderTree::Clear() {
     for (auto it = data.begin(); it != data.end(); ++it) {
         delete *it;
@@ -1167,17 +1841,31 @@ void xLightsFrame::RenderTree::Clear() {
     data.clear();
 }
 
-void xLightsFrame::RenderTree::Add(Model *el) {
-    RenderTreeData *elData = new RenderTreeData(el);
-    for (auto it = data.begin(); it != data.end(); ++it) {
-        RenderTreeData *elData2 = *it;
-        if (elData2->Overlaps(*elData)) {
-            elData->Add(elData2->model);
-            elData2->Add(el);
+void xLightsFrame::RenderTree::Build(const std::list<Model*> &models) {
+    std::vector<RenderTreeData*> elData;
+    std::vector<const std::list<NodeRange>*> ranges;
+    for (auto it = models.begin(); it != models.end(); ++it) {
+        elData.push_back(new RenderTreeData(*it));
+        ranges.push_back(&elData.back()->ranges);
+    }
+
+    // each model renders after the earlier models it overlaps and before the later ones
+    std::vector<std::vector<int>> before(elData.size());
+    std::vector<std::vector<int>> after(elData.size());
+    for (const auto &p : FindOverlappingRanges(ranges)) {
+        before[p.second].push_back(p.first);
+        after[p.first].push_back(p.second);
+    }
+    for (size_t x = 0; x < elData.size(); ++x) {
+        for (auto i : before[x]) {
+            elData[x]->Add(elData[i]->model);
+        }
+        elData[x]->Add(elData[x]->model);
+        for (auto i : after[x]) {
+            elData[x]->Add(elData[i]->model);
         }
+        data.push_back(elData[x]);
     }
-    elData->Add(el);
-    data.push_back(elData);
 }
 
 void xLightsFrame::RenderTree::Print() {
@@ -1203,15 +1891,20 @@ void xLightsFrame::BuildRenderTree() {
             //nothing to do....
             return;
         }
+        wxStopWatch sw;
+        std::list<Model*> models;
         for (size_t row = 0; row < numEls; ++row) {
             Element *rowEl = mSequenceElements.GetElement(row, MASTER_VIEW);
             if (rowEl != nullptr && rowEl->GetType() == ELEMENT_TYPE_MODEL) {
                 Model *model = GetModel(rowEl->GetModelName());
                 if (model != nullptr) {
-                    renderTree.Add(model);
+                    models.push_back(model);
                 }
             }
         }
+        renderTree.Build(models);
+        static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        logger_base.debug("Render tree of %d models built in %ldms.", (int)models.size(), sw.Time());
         renderTree.Print();
         renderTree.renderTreeChangeCount = curChangeCount;
     }
@@ -1221,7 +1914,8 @@ void xLightsFrame::Render(const std::list<Model*> models,
                           const std::list<Model *> &restrictToModels,
                           int startFrame, int endFrame,
                           bool progressDialog, bool clear,
-                          std::function<void()>&& callback) {
+                          std::function<void()>&& callback,
+                          std::shared_ptr<RenderWatermark> watermark) {
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     static log4cpp::Category &logger_render = log4cpp::Category::getInstance(std::string("log_render"));
@@ -1232,6 +1926,9 @@ void xLightsFrame::Render(const std::list<Model*> models,
     if (endFrame >= SeqData.NumFrames()) {
         endFrame = SeqData.NumFrames() - 1;
     }
+    if (renderProgressInfo.empty()) {
+        RenderTrace::Clear();
+    }
     std::list<NodeRange> ranges;
     if (restrictToModels.empty()) {
         ranges.push_back(NodeRange(0, SeqData.NumChannels()));
@@ -1245,7 +1942,8 @@ void xLightsFrame::Render(const std::list<Model*> models,
     int numRows = models.size();
     RenderJob **jobs = new RenderJob*[numRows];
     AggregatorRenderer **aggregators = new AggregatorRenderer*[numRows];
-    std::vector<std::set<int>> channelMaps(SeqData.NumChannels());
+    std::vector<std::list<NodeRange>> jobRanges(numRows);
+    wxStopWatch sw;
 
     size_t row = 0;
     for (auto it = models.begin(); it != models.end(); ++it, ++row) {
@@ -1291,32 +1989,43 @@ void xLightsFrame::Render(const std::list<Model*> models,
 
                     jobs[row] = job;
                     aggregators[row]->addNext(job);
+                    if (watermark) {
+                        job->SetWatermark(watermark.get(), row);
+                    }
                     size_t cn = buffer->GetChanCountPerNode();
+                    std::list<NodeRange> &nodeRanges = jobRanges[row];
                     for (int node = 0; node < buffer->GetNodeCount(); ++node) {
-                        int start = buffer->NodeStartChannel(node);
-                        for (int c = 0; c < cn; ++c) {
-                            int cnum = start + c;
-                            if (cnum < SeqData.NumChannels()) {
-                                for (auto i = channelMaps[cnum].begin(); i != channelMaps[cnum].end(); ++i) {
-                                    int idx = *i;
-                                    if (idx != row) {
-                                        if (jobs[idx]->addNext(aggregators[row])) {
-                                            aggregators[row]->incNumAggregated();
-                                        }
-                                    }
-                                }
-                                channelMaps[cnum].insert(row);
+                        unsigned int start = buffer->NodeStartChannel(node);
+                        unsigned int end = std::min(start + (unsigned int)cn, (unsigned int)SeqData.NumChannels());
+                        if (start < end) {
+                            if (!nodeRanges.empty() && nodeRanges.back().end + 1 == start) {
+                                nodeRanges.back().end = end - 1;
+                            } else {
+                                nodeRanges.push_back(NodeRange(start, end - 1));
                             }
                         }
                     }
+                    RenderTreeData::sortRanges(nodeRanges);
                 }
             }
         }
     }
 
+    //each model waits on the earlier models that share any of its channels
+    std::vector<const std::list<NodeRange>*> rangePtrs;
+    for (auto &r : jobRanges) {
+        rangePtrs.push_back(&r);
+    }
+    for (const auto &p : FindOverlappingRanges(rangePtrs)) {
+        if (jobs[p.first]->addNext(aggregators[p.second])) {
+            aggregators[p.second]->incNumAggregated();
+        }
+    }
+    jobRanges.clear();
+
     logger_render.debug("Aggregators created.");
+    logger_base.debug("Render dependencies for %d models built in %ldms.", numRows, sw.Time());
 
-    channelMaps.clear();
     RenderProgressDialog *renderProgressDialog = nullptr;
     if (progressDialog) {
         renderProgressDialog = new RenderProgressDialog(this);
@@ -1337,12 +2046,16 @@ void xLightsFrame::Render(const std::list<Model*> models,
     logger_render.debug("Data cleared.");
 
     for (row = 0; row < numRows; ++row) {
+        if (!jobs[row] && watermark) {
+            //nothing to render for this row so it never holds back the watermark
+            watermark->JobDone(row);
+        }
         if (jobs[row]) {
             if (aggregators[row]->getNumAggregated() == 0) {
                 //start all the jobs that don't depend on anything above them
                 //get them rendering while we setup the rest
                 jobs[row]->setPreviousFrameDone(END_OF_RENDER_FRAME);
-                jobPool.PushJob(jobs[row]);
+                jobs[row]->Schedule(jobPool);
                 ++count;
             }
             if (progressDialog) {
@@ -1360,7 +2073,7 @@ void xLightsFrame::Render(const std::list<Model*> models,
     for (row = 0; row < numRows; ++row) {
         if (jobs[row] && aggregators[row]->getNumAggregated() != 0) {
             //now start the rest
-            jobPool.PushJob(jobs[row]);
+            jobs[row]->Schedule(jobPool);
             ++count;
         }
     }
@@ -1383,6 +2096,7 @@ void xLightsFrame::Render(const std::list<Model*> models,
         pi->renderProgressDialog = renderProgressDialog;
         pi->restriction = restrictToModels;
         pi->aggregators = aggregators;
+        pi->watermark = watermark;
 
         renderProgressInfo.push_back(pi);
     } else {
@@ -1429,65 +2143,149 @@ static void addModelsFrom(std::list<Model*> &models, const std::list<Model *> &t
     }
 }
 
+// Effects which cannot render part of their time (each frame builds on the ones before it) have to be
+// rendered from their start, moves startFrame back to the start of any such effect running across it
+static int GetElementWarmupStartFrame(Element *el, EffectManager &effectManager, int startFrame, int frameTime) {
+    int time = startFrame * frameTime;
+    for (size_t l = 0; l < el->GetEffectLayerCount(); ++l) {
+        EffectLayer *layer = el->GetEffectLayer(l);
+        std::unique_lock<std::recursive_mutex> elock(layer->GetLock());
+        for (int e = 0; e < layer->GetEffectCount(); ++e) {
+            Effect *effect = layer->GetEffect(e);
+            if (effect->GetStartTimeMS() < time && effect->GetEndTimeMS() > time) {
+                RenderableEffect *reff = effectManager.GetEffect(effect->GetEffectIndex());
+                if (reff != nullptr && !reff->CanRenderPartialTimeInterval()) {
+                    startFrame = std::min(startFrame, effect->GetStartTimeMS() / frameTime);
+                }
+            }
+        }
+    }
+    return startFrame;
+}
+
+// A span of frames which needs re-rendering, the dirty models in it and every model they overlap
+struct DirtyRenderSpan {
+    int startFrame;
+    int endFrame;
+    std::list<Model *> restricts;
+    std::list<Model *> models;
+};
+
+int xLightsFrame::GetWarmupStartFrame(const std::list<Model *> &models, int startFrame) {
+    //keep going until no effect reaches back past the start as moving it may land in another effect
+    int last = -1;
+    while (last != startFrame) {
+        last = startFrame;
+        for (auto it = models.begin(); it != models.end(); ++it) {
+            Element *el = mSequenceElements.GetElement((*it)->GetName());
+            if (el == nullptr || el->GetType() != ELEMENT_TYPE_MODEL) {
+                continue;
+            }
+            startFrame = GetElementWarmupStartFrame(el, effectManager, startFrame, SeqData.FrameTime());
+            ModelElement *me = dynamic_cast<ModelElement *>(el);
+            for (int x = 0; x < me->GetSubModelAndStrandCount(); ++x) {
+                startFrame = GetElementWarmupStartFrame(me->GetSubModel(x), effectManager, startFrame, SeqData.FrameTime());
+            }
+        }
+    }
+    return startFrame;
+}
+
 void xLightsFrame::RenderDirtyModels() {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
     BuildRenderTree();
     if (renderTree.data.empty()) {
         //nothing to do....
         return;
     }
     const int numRows = mSequenceElements.GetElementCount();
-    if (numRows == 0) {
+    if (numRows == 0 || SeqData.NumFrames() == 0) {
         return;
     }
-    int startms = 9999999;
-    int endms = -1;
-    std::list<Model *> models;
-    std::list<Model *> restricts;
+
+    //each dirty interval of each model becomes its own span, rendered with just the models whose
+    //channels overlap that model rather than everything after it
+    std::list<DirtyRenderSpan> spans;
+    int firstFrame = SeqData.NumFrames();
+    int lastFrame = -1;
     for (int x = 0; x < numRows; x++) {
         Element *el = mSequenceElements.GetElement(x);
-        if (el->GetType() != ELEMENT_TYPE_TIMING) {
-            int st, ed;
-            el->GetDirtyRange(st, ed);
-            if (st != -1) {
-                startms = std::min(startms, st);
-                endms = std::max(endms, ed);
-                for (auto it = renderTree.data.begin(); it != renderTree.data.end(); ++it) {
-                    if ((*it)->model->GetName() == el->GetModelName()) {
-                        restricts.push_back((*it)->model);
-                        addModelsUpTo(models, (*it)->renderOrder, (*it)->model);
-                    }
+        if (el->GetType() == ELEMENT_TYPE_TIMING) {
+            continue;
+        }
+        std::list<std::pair<int, int>> dirty;
+        el->GetDirtyRanges(dirty);
+        if (dirty.empty()) {
+            continue;
+        }
+        for (auto it = renderTree.data.begin(); it != renderTree.data.end(); ++it) {
+            if ((*it)->model->GetName() != el->GetModelName()) {
+                continue;
+            }
+            for (const auto &r : dirty) {
+                DirtyRenderSpan span;
+                span.startFrame = std::max(0, r.first / SeqData.FrameTime() - 1);
+                span.endFrame = std::min(SeqData.NumFrames() - 1, r.second / SeqData.FrameTime() + 1);
+                if (span.endFrame < span.startFrame) {
+                    //entirely past the end of the sequence, no job will ever pick it up so drop it
+                    int changes;
+                    std::list<std::pair<int, int>> dropped;
+                    el->GetAndResetDirtyRanges(changes, r.first, r.second, dropped);
+                    continue;
                 }
+                firstFrame = std::min(firstFrame, span.startFrame);
+                lastFrame = std::max(lastFrame, span.endFrame);
+                span.restricts.push_back((*it)->model);
+                addModelsUpTo(span.models, (*it)->renderOrder, (*it)->model);
+                addModelsFrom(span.models, (*it)->renderOrder, (*it)->model);
+                span.startFrame = GetWarmupStartFrame(span.models, span.startFrame);
+                spans.push_back(span);
             }
         }
     }
-    if (restricts.empty()) {
+    if (spans.empty()) {
         return;
     }
-    for (auto x = models.begin(); x != models.end(); ++x) {
-        for (auto it = renderTree.data.begin(); it != renderTree.data.end(); ++it) {
-            if ((*it)->model == *x) {
-                addModelsFrom(models, (*it)->renderOrder, (*it)->model);
+
+    //merge the spans which overlap or touch, the merged span may need more warm up for the models it picked up
+    spans.sort([](const DirtyRenderSpan &a, const DirtyRenderSpan &b) { return a.startFrame < b.startFrame; });
+    std::vector<DirtyRenderSpan> merged;
+    for (auto &span : spans) {
+        merged.push_back(span);
+        while (merged.size() > 1) {
+            DirtyRenderSpan &last = merged.back();
+            DirtyRenderSpan &prev = merged[merged.size() - 2];
+            if (last.startFrame > prev.endFrame + 1) {
+                break;
             }
+            prev.startFrame = std::min(prev.startFrame, last.startFrame);
+            prev.endFrame = std::max(prev.endFrame, last.endFrame);
+            addModelsUpTo(prev.restricts, last.restricts, nullptr);
+            addModelsUpTo(prev.models, last.models, nullptr);
+            merged.pop_back();
+            merged.back().startFrame = GetWarmupStartFrame(merged.back().models, merged.back().startFrame);
         }
     }
-    if (startms < 0) {
-        startms = 0;
-    }
-    if (endms < 0) {
-        endms = 0;
-    }
-    int startframe = startms / SeqData.FrameTime() - 1;
-    if (startframe < 0) {
-        startframe = 0;
+
+    int renderedFrames = 0;
+    for (const auto &span : merged) {
+        renderedFrames += span.endFrame - span.startFrame + 1;
     }
-    int endframe = endms / SeqData.FrameTime() + 1;
-    if (endframe >= SeqData.NumFrames()) {
-        endframe = SeqData.NumFrames() - 1;
+    firstFrame = std::min(firstFrame, merged.front().startFrame);
+    logger_base.debug("Rendering %d dirty spans, %d frames, skipping %d of the %d frames between the first and last change.",
+                      (int)merged.size(), renderedFrames, std::max(0, lastFrame - firstFrame + 1 - renderedFrames), lastFrame - firstFrame + 1);
+
+    //models picked up from several spans have to go back in render order so each waits on the right models
+    std::map<Model *, int> order;
+    int idx = 0;
+    for (auto it = renderTree.data.begin(); it != renderTree.data.end(); ++it) {
+        order[(*it)->model] = idx++;
     }
-    if (endframe < startframe) {
-        return;
+    for (auto &span : merged) {
+        span.models.sort([&order](Model *a, Model *b) { return order[a] < order[b]; });
+        Render(span.models, span.restricts, span.startFrame, span.endFrame, false, true, [] {});
     }
-    Render(models, restricts, startframe, endframe, false, true, [] {});
 }
 
 bool xLightsFrame::AbortRender()
@@ -1516,13 +2314,17 @@ bool xLightsFrame::AbortRender()
     return abortCount != 0;
 }
 
-void xLightsFrame::RenderGridToSeqData(std::function<void()>&& callback) {
+// If streamFseqFile is given the fseq is written as frames complete and is finalized before the callback is called
+void xLightsFrame::RenderGridToSeqData(std::function<void()>&& callback, const wxString& streamFseqFile) {
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     BuildRenderTree();
     if (renderTree.data.empty()) {
         //nothing to do....
+        if (!streamFseqFile.IsEmpty()) {
+            WriteFalconPiFile(streamFseqFile);
+        }
         callback();
         return;
     }
@@ -1531,6 +2333,9 @@ void xLightsFrame::RenderGridToSeqData(std::function<void()>&& callback) {
 
     const int numRows = mSequenceElements.GetElementCount();
     if (numRows == 0) {
+        if (!streamFseqFile.IsEmpty()) {
+            WriteFalconPiFile(streamFseqFile);
+        }
         callback();
         return;
     }
@@ -1554,20 +2359,39 @@ void xLightsFrame::RenderGridToSeqData(std::function<void()>&& callback) {
     
 #ifdef DOTIMING
     wxStopWatch sw;
-    Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw, callback] {
+    Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw, callback, streamFseqFile] {
         printf("%s  Render 1:  %ld ms\n", (const char *)xlightsFilename.c_str(), sw.Time());
         wxStopWatch sw2;
-        Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw2, callback] {
+        Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw2, callback, streamFseqFile] {
             printf("%s  Render 2:  %ld ms\n", (const char *)xlightsFilename.c_str(), sw2.Time());
             wxStopWatch sw3;
-            Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, [sw3, callback] {
+            Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, sw3, callback, streamFseqFile] {
                 printf("%s  Render 3:  %ld ms\n", (const char *)xlightsFilename.c_str(), sw3.Time());
+                if (!streamFseqFile.IsEmpty()) {
+                    WriteFalconPiFile(streamFseqFile);
+                }
                 callback();
             } );
         });
     });
 #else
-    Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, std::move(callback));
+    std::shared_ptr<RenderWatermark> watermark;
+    FSEQStreamWriter *writer = nullptr;
+    if (!streamFseqFile.IsEmpty()) {
+        FSEQFile *file = CreateFalconPiFile(streamFseqFile);
+        if (file != nullptr) {
+            logger_base.debug("Streaming fseq to %s as frames render.", (const char *)streamFseqFile.c_str());
+            watermark = std::make_shared<RenderWatermark>(models.size(), 0);
+            writer = new FSEQStreamWriter(file, SeqData, watermark);
+        }
+    }
+    Render(models, restricts, 0, SeqData.NumFrames() - 1, true, false, [writer, callback] {
+        if (writer != nullptr) {
+            writer->Finish();
+            delete writer;
+        }
+        callback();
+    }, watermark);
 #endif
 }
 
@@ -1595,9 +2419,12 @@ void xLightsFrame::RenderEffectForModel(const std::string &model, int startms, i
         if ((*it)->model->GetName() == model) {
 
             for (auto it2 = renderProgressInfo.begin(); it2 != renderProgressInfo.end(); ++it2) {
-                //we're going to render this model, abort whatever is rendering and accumulate the frames
+                //we're going to render these frames of this model, abort whatever is rendering over them and
+                //accumulate the frames. Renders of other intervals are left alone so they don't get collapsed
+                //into one span covering everything between them
                 RenderProgressInfo *rpi = (*it2);
-                if (std::find(rpi->restriction.begin(), rpi->restriction.end(), (*it)->model) != rpi->restriction.end()) {
+                if (rpi->startFrame <= endframe + 1 && rpi->endFrame + 1 >= startframe
+                    && std::find(rpi->restriction.begin(), rpi->restriction.end(), (*it)->model) != rpi->restriction.end()) {
                     if (startframe > rpi->startFrame) {
                         startframe = rpi->startFrame;
                     }
@@ -1734,7 +2561,7 @@ void xLightsFrame::ExportModel(wxCommandEvent &command) {
             job->setRenderRange(0, SeqData.NumFrames());
             job->setPreviousFrameDone(END_OF_RENDER_FRAME);
             job->addNext(&wait);
-            jobPool.PushJob(job);
+            job->Schedule(jobPool);
             //wait to complete
             while (!wait.checkIfDone(SeqData.NumFrames())) {
                 wxYield();
@@ -1878,6 +2705,7 @@ bool xLightsFrame::RenderEffectFromMap(Effect *effectObj, int layer, int period,
                     logger_render.info("Frame #%d render on model %s (%dx%d) layer %d effect %s from %dms (#%d) to %dms (#%d) took more than 150 ms => %dms.", b.curPeriod, (const char *)buffer.GetModelName().c_str(),b.BufferWi, b.BufferHt, layer, (const char *)reff->Name().c_str(), effectObj->GetStartTimeMS(), b.curEffStartPer, effectObj->GetEndTimeMS(), b.curEffEndPer, sw.Time());
                 }
             } else {
+                event->buffer = &buffer;
                 event->effect = effectObj;
                 event->layer = layer;
                 event->period = period;
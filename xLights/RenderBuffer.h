@@ -153,6 +153,37 @@ private:
     hsvVector hsv;
     xlColorCurveVector cc;
     const ColorCurve nilcc;
+    std::vector<std::vector<xlColor>> ccLUT; // each active colour curve sampled at CC_LUT_POINTS + 1 offsets, empty if not active or random
+
+    // the colour curve lookup tables are rebuilt whenever the palette is set so per pixel lookups are just an index
+    void BuildCurveLUTs()
+    {
+        ccLUT.resize(cc.size());
+        for (size_t i = 0; i < cc.size(); i++)
+        {
+            ccLUT[i].clear();
+            if (cc[i].IsActive() && cc[i].GetType() != "Random")
+            {
+                ccLUT[i].resize(CC_LUT_POINTS + 1);
+                for (int j = 0; j <= CC_LUT_POINTS; j++)
+                {
+                    ccLUT[i][j] = cc[i].GetValueAt((float)j / (float)CC_LUT_POINTS);
+                }
+            }
+        }
+    }
+
+    xlColor CurveValueAt(size_t idx, float offset) const
+    {
+        const std::vector<xlColor>& lut = ccLUT[idx];
+        if (lut.empty())
+        {
+            return cc[idx].GetValueAt(offset);
+        }
+        if (!(offset > 0.0f)) return lut.front();
+        if (offset >= 1.0f) return lut.back();
+        return lut[(int)(offset * CC_LUT_POINTS + 0.5f)];
+    }
 
 public:
 
@@ -163,7 +194,7 @@ public:
         {
             if (it->IsActive())
             {
-                color[i] = xlColor(it->GetValueAt(progress));
+                color[i] = CurveValueAt(i, progress);
                 hsv[i] = color[i].asHSV();
             }
             i++;
@@ -175,6 +206,7 @@ public:
         wxASSERT(newcolors.size() == newcc.size());
 
         cc = newcc;
+        BuildCurveLUTs();
         color=newcolors;
         hsv.clear();
         for(size_t i=0; i<newcolors.size(); i++)
@@ -211,7 +243,7 @@ public:
 
         if (cc[idx].IsActive())
         {
-            return cc[idx].GetValueAt(progress);
+            return CurveValueAt(idx, progress);
         }
         return color[idx];
     }
@@ -238,11 +270,11 @@ public:
     {
         if (type == TC_CW)
         {
-            return cc[idx].GetValueAt(round);
+            return CurveValueAt(idx, round);
         }
         else
         {
-            return cc[idx].GetValueAt(1.0 - round);
+            return CurveValueAt(idx, 1.0 - round);
         }
     }
 
@@ -250,9 +282,9 @@ public:
     {
         double len = sqrt((x - centrex) * (x - centrex) + (y - centrey) * (y - centrey));
         if (type == TC_RADIALIN)
-            return cc[idx].GetValueAt(1.0 - len / maxradius);
+            return CurveValueAt(idx, 1.0 - len / maxradius);
         else
-            return cc[idx].GetValueAt(len / maxradius);
+            return CurveValueAt(idx, len / maxradius);
     }
 
     void GetSpatialColor(size_t idx, float xcentre, float ycentre, float x, float y, float round, float maxradius, xlColor& c) const
@@ -304,16 +336,16 @@ public:
                 switch (cc[idx].GetTimeCurve())
                 {
                 case TC_RIGHT:
-                    c = cc[idx].GetValueAt(x);
+                    c = CurveValueAt(idx, x);
                     break;
                 case TC_LEFT:
-                    c = cc[idx].GetValueAt(1.0 - x);
+                    c = CurveValueAt(idx, 1.0 - x);
                     break;
                 case TC_UP:
-                    c = cc[idx].GetValueAt(y);
+                    c = CurveValueAt(idx, y);
                     break;
                 case TC_DOWN:
-                    c = cc[idx].GetValueAt(1.0 - y);
+                    c = CurveValueAt(idx, 1.0 - y);
                     break;
                 default:
                     c = color[idx];
@@ -336,7 +368,7 @@ public:
         {
             if (cc[idx].IsActive())
             {
-                c = cc[idx].GetValueAt(progress);
+                c = CurveValueAt(idx, progress);
             }
             else
             {
@@ -373,7 +405,7 @@ public:
         {
             if (cc[idx].IsActive())
             {
-                c = xlColor(cc[idx].GetValueAt(progress)).asHSV();
+                c = xlColor(CurveValueAt(idx, progress)).asHSV();
             }
             else
             {
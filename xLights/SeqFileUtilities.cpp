@@ -232,6 +232,8 @@ void xLightsFrame::OpenSequence(const wxString passed_filename, ConvertLogDialog
         }
 
         // check if there is a autosave backup file which is newer than the file we have been asked to open
+        bool backupNewer = false;
+        bool backupTaken = false;
         if (!_renderMode)
         {
             wxFileName fn(filename);
@@ -249,8 +251,11 @@ void xLightsFrame::OpenSequence(const wxString passed_filename, ConvertLogDialog
                 if (xbkptime > xmltime)
                 {
                     // autosave file is newer
+                    backupNewer = true;
                     if (wxMessageBox("Autosaved file found which seems to be newer than your sequence file ... would you like to open that instead and replace your xml file?", "Newer file found", wxYES_NO) == wxYES)
                     {
+                        backupTaken = true;
+
                         // run a backup ... equivalent of a F10
                         DoBackup(false, false, true);
 
@@ -534,6 +539,7 @@ void xLightsFrame::OpenSequence(const wxString passed_filename, ConvertLogDialog
 
         if( loaded_fseq )
         {
+            mainSequencer->PanelEffectGrid->ClearNodeColourSummaries();
             UpdatePreview();
         }
         else if( !loaded_xml )
@@ -542,6 +548,30 @@ void xLightsFrame::OpenSequence(const wxString passed_filename, ConvertLogDialog
             return;
         }
 
+        // replay any journalled changes left behind since the last full save if xLights did not close cleanly
+        if (!_renderMode)
+        {
+            std::string journal = GetSequenceJournalFile();
+            bool journalOnBackup = false;
+            bool replayed = false;
+            if (SequenceJournal::HasRecoverableChanges(journal, journalOnBackup) &&
+                journalOnBackup == backupNewer && backupTaken == backupNewer)
+            {
+                if (wxMessageBox("Autosave journal found with changes made after the sequence was last saved ... would you like to restore them?", "Autosave journal found", wxYES_NO) == wxYES)
+                {
+                    int groups = SequenceJournal::Replay(journal, mSequenceElements);
+                    logger_base.info("Replayed %d autosave journal entries.", groups);
+                    SaveWorking();
+                    mLastAutosaveCount = mSequenceElements.GetChangeCount();
+                    replayed = true;
+                }
+            }
+            if (!replayed)
+            {
+                mSequenceElements.get_undo_mgr().GetJournal().Reset(journal, false, mSequenceElements);
+            }
+        }
+
         float elapsedTime = sw.Time()/1000.0; //msec => sec
         SetStatusText(wxString::Format("'%s' loaded in %4.3f sec.", filename, elapsedTime));
         SetTitle(xlights_base_name + " - " + filename);
@@ -610,8 +640,12 @@ bool xLightsFrame::CloseSequence()
         }
     }
 
+    // the sequence is closing cleanly so the journal is no longer needed for recovery
+    mSequenceElements.get_undo_mgr().GetJournal().Close(true);
+
     // just in case there is still rendering going on
     AbortRender();
+    ClearRenderBufferPool();
 
     _renderCache.CleanupCache(&mSequenceElements);
     _renderCache.SetSequence(fseqDirectory.ToStdString(), "");
@@ -745,6 +779,20 @@ void xLightsFrame::RenderIseqData(bool bottom_layers, ConvertLogDialog* plog)
     }
 }
 
+// true when there are iseq layers above the Nutcracker layer which are applied after the effects render
+bool xLightsFrame::HasIseqLayersAbove()
+{
+    DataLayerSet& data_layers = CurrentSeqXmlFile->GetDataLayers();
+    for (int i = 0; i < data_layers.GetNumLayers(); ++i)
+    {
+        if (data_layers.GetDataLayer(i)->GetName() == "Nutcracker")
+        {
+            return i > 0;
+        }
+    }
+    return false;
+}
+
 void xLightsFrame::SetSequenceEnd(int ms)
 {
     mainSequencer->PanelTimeLine->SetSequenceEnd(CurrentSeqXmlFile->GetSequenceDurationMS());
@@ -22,6 +22,7 @@ SequenceData::SequenceData() {
     _numChannels = 0;
     _bytesPerFrame = 0;
     _frameTime = 50;
+    _generation = 0;
 }
 
 SequenceData::~SequenceData() {
@@ -56,6 +57,7 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
     _numFrames = numFrames;
     _frameTime = frameTime;
     _bytesPerFrame = roundTo4(numChannels);
+    _generation++;
 
     if (numFrames > 0 && numChannels > 0) {
         size_t sz = (size_t)_bytesPerFrame * (size_t)_numFrames;
@@ -53,6 +53,7 @@ class SequenceData {
     unsigned int _numChannels;
     unsigned int _numFrames;
     unsigned int _frameTime;
+    unsigned int _generation;
 
     SequenceData(const SequenceData&);  //make sure we cannot "copy" these
     SequenceData &operator=(const SequenceData& rgb);
@@ -71,6 +72,7 @@ public:
     unsigned int NumChannels() const { return _numChannels;}
     unsigned int NumFrames() const { return _numFrames;}
     unsigned int FrameTime() const { return _frameTime;}
+    unsigned int Generation() const { return _generation; } // changes every time the data is reinitialised
     bool IsValidData() const { return _data != nullptr; }
 
     // encodes contents of SeqData in channel order
@@ -1247,3 +1247,19 @@ void xLightsFrame:: WriteFalconPiFile(const wxString& filename)
     
     FileConverter::WriteFalconPiFile(write_params);
 }
+
+FSEQFile* xLightsFrame::CreateFalconPiFile(const wxString& filename)
+{
+    ConvertParameters write_params(filename,                                     // filename
+                                   SeqData,                                      // sequence data object
+                                   &_outputManager,                               // global network info
+                                   ConvertParameters::READ_MODE_LOAD_MAIN,       // file read mode
+                                   this,                                         // xLights main frame
+                                   nullptr,
+                                   nullptr,
+                                   &mediaFilename, // media filename
+                                   nullptr,
+                                   filename);
+
+    return FileConverter::CreateFalconPiFile(write_params);
+}
@@ -1069,7 +1069,9 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
     RenderIseqData(true, nullptr); // render ISEQ layers below the Nutcracker layer
     logger_base.info("   iseq below effects done.");
     ProgressBar->SetValue(10);
-    RenderGridToSeqData([this, sw, fileNames, exitOnDone] {
+    // with nothing to apply over the rendered effects the fseq is written while the frames render
+    bool streamFseq = !HasIseqLayersAbove();
+    RenderGridToSeqData([this, sw, fileNames, exitOnDone, streamFseq] {
         static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
         logger_base.info("   Effects done.");
         ProgressBar->SetValue(90);
@@ -1079,9 +1081,11 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
         ProgressBar->Hide();
         GaugeSizer->Layout();
 
-        logger_base.info("Saving fseq file.");
-        SetStatusText(_("Saving ") + xlightsFilename + _(" ... Writing fseq."));
-        WriteFalconPiFile(xlightsFilename);
+        if (!streamFseq) {
+            logger_base.info("Saving fseq file.");
+            SetStatusText(_("Saving ") + xlightsFilename + _(" ... Writing fseq."));
+            WriteFalconPiFile(xlightsFilename);
+        }
         logger_base.info("fseq file done.");
         DisplayXlightsFilename(xlightsFilename);
         float elapsedTime = sw.Time()/1000.0; // now stop stopwatch timer and get elapsed time. change into seconds from ms
@@ -1092,7 +1096,7 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
         mLastAutosaveCount = mSavedChangeCount;
 
         CallAfter(&xLightsFrame::OpenRenderAndSaveSequences, fileNames, exitOnDone);
-    } );
+    }, streamFseq ? xlightsFilename : wxString(wxEmptyString));
 }
 
 void xLightsFrame::SaveSequence()
@@ -1166,6 +1170,10 @@ void xLightsFrame::SaveSequence()
     CurrentSeqXmlFile->AddJukebox(jukeboxPanel->Save());
     CurrentSeqXmlFile->Save(mSequenceElements);
     logger_base.info("XML file done.");
+    if (!_renderMode)
+    {
+        mSequenceElements.get_undo_mgr().GetJournal().Reset(GetSequenceJournalFile(), false, mSequenceElements);
+    }
 
     if (mBackupOnSave)
     {
@@ -1193,7 +1201,9 @@ void xLightsFrame::SaveSequence()
         RenderIseqData(true, nullptr); // render ISEQ layers below the Nutcracker layer
         logger_base.info("   iseq below effects done.");
         ProgressBar->SetValue(10);
-        RenderGridToSeqData([this, sw] {
+        // with nothing to apply over the rendered effects the fseq is written while the frames render
+        bool streamFseq = !HasIseqLayersAbove();
+        RenderGridToSeqData([this, sw, streamFseq] {
             static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
             logger_base.info("   Effects done.");
             ProgressBar->SetValue(90);
@@ -1203,10 +1213,12 @@ void xLightsFrame::SaveSequence()
             ProgressBar->Hide();
             GaugeSizer->Layout();
 
-            logger_base.info("Saving fseq file.");
+            if (!streamFseq) {
+                logger_base.info("Saving fseq file.");
 
-            SetStatusText(_("Saving ") + xlightsFilename + _(" ... Writing fseq."));
-            WriteFalconPiFile(xlightsFilename);
+                SetStatusText(_("Saving ") + xlightsFilename + _(" ... Writing fseq."));
+                WriteFalconPiFile(xlightsFilename);
+            }
             logger_base.info("fseq file done.");
             DisplayXlightsFilename(xlightsFilename);
             float elapsedTime = sw.Time()/1000.0; // now stop stopwatch timer and get elapsed time. change into seconds from ms
@@ -1216,7 +1228,7 @@ void xLightsFrame::SaveSequence()
             EnableSequenceControls(true);
             mSavedChangeCount = mSequenceElements.GetChangeCount();
             mLastAutosaveCount = mSavedChangeCount;
-        } );
+        }, streamFseq ? xlightsFilename : wxString(wxEmptyString));
         return;
     }
     wxString display_name;
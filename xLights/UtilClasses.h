@@ -2,25 +2,61 @@
 #define UTILCLASSES_H
 
 #include <map>
+#include <memory>
 #include <string>
 #include <algorithm>
 #include <wx/filepicker.h>
 
 
-class MapStringString: public std::map<std::string,std::string> {
+// Copy on write string map. Maps built by Parse are interned so every effect with
+// identical settings text shares one immutable copy; the first modification detaches.
+class MapStringString {
 public:
-    MapStringString(): std::map<std::string,std::string>() {
+    typedef std::map<std::string, std::string> Map;
+    // iterators are read only; writes go through operator[], insert and erase so
+    // a read never has to detach a shared map
+    typedef Map::const_iterator iterator;
+    typedef Map::const_iterator const_iterator;
+    typedef Map::size_type size_type;
+    typedef Map::value_type value_type;
+    typedef Map::key_type key_type;
+    typedef Map::mapped_type mapped_type;
+
+    MapStringString(): _data(EmptyMap()), _shared(true) {
     }
     virtual ~MapStringString() {}
 
+    const_iterator begin() const { return _data->begin(); }
+    const_iterator end() const { return _data->end(); }
+    const_iterator find(const std::string &key) const { return _data->find(key); }
+    const_iterator cbegin() const { return _data->cbegin(); }
+    const_iterator cend() const { return _data->cend(); }
+    size_type size() const { return _data->size(); }
+    bool empty() const { return _data->empty(); }
+    size_type count(const std::string &key) const { return _data->count(key); }
+    void clear() {
+        _data = EmptyMap();
+        _shared = true;
+    }
+    std::pair<iterator, bool> insert(const value_type &v) {
+        auto r = Mutable().insert(v);
+        return std::pair<iterator, bool>(r.first, r.second);
+    }
+    iterator erase(const_iterator it) {
+        // it may point into the shared copy so erase by key once detached
+        std::string key(it->first);
+        Map &m = Mutable();
+        return m.erase(m.find(key));
+    }
+
     const std::string &operator[](const std::string &key) const {
         return Get(key, EMPTY_STRING);
     }
     std::string &operator[](const std::string &key) {
-        return std::map<std::string, std::string>::operator[](key);
+        return Mutable()[key];
     }
     int GetInt(const std::string &key, const int def = 0) const {
-        std::map<std::string,std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end() || i->second.length() == 0) {
             return def;
         }
@@ -31,7 +67,7 @@ public:
         }
     }
     float GetFloat(const std::string &key, const float def = 0.0) const {
-        std::map<std::string,std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end() || i->second.length() == 0) {
             return def;
         }
@@ -42,7 +78,7 @@ public:
         }
     }
     double GetDouble(const std::string &key, const double def = 0.0) const {
-        std::map<std::string,std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end() || i->second.length() == 0) {
             return def;
         }
@@ -53,28 +89,28 @@ public:
         }
     }
     bool GetBool(const std::string &key, const bool def = false) const {
-        std::map<std::string,std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end()) {
             return def;
         }
         return i->second.length() >= 1 && i->second.at(0) == '1';
     }
     const std::string &Get(const std::string &key, const std::string &def) const {
-        std::map<std::string,std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end()) {
             return def;
         }
         return i->second;
     }
     std::string Get(const std::string &key, const char *def) const {
-        std::map<std::string,std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end()) {
             return def;
         }
         return i->second;
     }
     bool Contains(const std::string &key) const {
-        std::map<std::string, std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end()) {
             return false;
         }
@@ -89,7 +125,7 @@ public:
     }
     std::string &operator[](const char *ckey) {
         std::string key(ckey);
-        return std::map<std::string, std::string>::operator[](key);
+        return Mutable()[key];
     }
     int GetInt(const char * ckey, const int def = 0) const {
         return GetInt(std::string(ckey), def);
@@ -113,7 +149,7 @@ public:
 
     std::string Get(const char *ckey, const char *def) const {
         std::string key(ckey);
-        std::map<std::string,std::string>::const_iterator i(find(key));
+        const_iterator i(find(key));
         if (i == end()) {
             return def;
         }
@@ -121,44 +157,24 @@ public:
     }
     size_type erase(const char *ckey) {
         std::string key(ckey);
-        return std::map<std::string,std::string>::erase(key);
+        return erase(key);
     }
     size_type erase(const std::string &key) {
-        return std::map<std::string,std::string>::erase(key);
-    }
-
-
-    void Parse(const std::string &str) {
-        clear();
-        std::string before,after,name,value;
-        std::string settings(str);
-        while (!settings.empty()) {
-            size_t start_pos = settings.find(',');
-            if (start_pos != std::string::npos) {
-                before = settings.substr(0, start_pos);
-                settings = settings.substr(start_pos + 1);
-            } else {
-                before = settings;
-                settings = "";
-            }
-
-            start_pos = before.find('=');
-            name = before.substr(0, start_pos);
-            value = before.substr(start_pos + 1);
-            ReplaceAll(value, "&comma;", ","); //unescape the commas
-            ReplaceAll(value, "&amp;", "&"); //unescape the amps
-
-            RemapKey(name, value);
-            if (!name.empty()) {
-                (*this)[name]=value;
-            }
+        // dont detach a shared map just to find out there is nothing to remove
+        if (_data->find(key) == _data->end()) {
+            return 0;
         }
+        return Mutable().erase(key);
     }
 
+    // Replaces the contents with the parsed settings string. Identical strings
+    // share a single interned map.
+    void Parse(const std::string &str);
+
     virtual void RemapKey(std::string &n, std::string &value) {};
     std::string AsString() const {
         std::string ret;
-        for (std::map<std::string,std::string>::const_iterator it=begin(); it!=end(); ++it) {
+        for (const_iterator it=begin(); it!=end(); ++it) {
             if (ret.length() != 0) {
                 ret += ",";
             }
@@ -170,8 +186,24 @@ public:
         return ret;
     }
 
+    // Memory held by the intern pool ... unique maps, maps referencing them and approximate bytes
+    static void GetInternStats(size_t &unique, size_t &references, size_t &bytes);
+
+protected:
+    virtual bool RemapsKeys() const { return false; }
+
 private:
 
+    Map &Mutable() {
+        // interned maps can be handed out by the pool at any time so they are never modified in place
+        if (_shared || _data.use_count() > 1) {
+            _data = std::make_shared<Map>(*_data);
+            _shared = false;
+        }
+        return *_data;
+    }
+    void ParseInto(Map &map, const std::string &str);
+
     void ReplaceAll(std::string &str, const std::string& from, const std::string& to) const {
         size_t start_pos = 0;
         while((start_pos = str.find(from, start_pos)) != std::string::npos) {
@@ -180,6 +212,11 @@ private:
         }
     }
 
+    static const std::shared_ptr<Map> &EmptyMap();
+
+    std::shared_ptr<Map> _data;
+    bool _shared;
+
     static const std::string EMPTY_STRING;
 };
 
@@ -192,6 +229,8 @@ public:
     virtual void RemapKey(std::string &n, std::string &value) {
         RemapChangedSettingKey(n, value);
     }
+protected:
+    virtual bool RemapsKeys() const { return true; }
 private:
     static void RemapChangedSettingKey(std::string &n,  std::string &value);
 };
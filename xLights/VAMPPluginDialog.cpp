@@ -254,7 +254,6 @@ wxString VAMPPluginDialog::ProcessPlugin(xLightsXmlFile* xml_file, xLightsFrame
         if (step == 0) {
             step = block;
         }
-        float *pdata[2];
         std::string error;
 		media->SetStepBlock(step, block);
 
@@ -281,46 +280,19 @@ wxString VAMPPluginDialog::ProcessPlugin(xLightsXmlFile* xml_file, xLightsFrame
                 p->setParameter(params[x].identifier, slider->GetValue());
             }
         }
-        int channels = media->GetChannels();
-        if (channels > p->getMaxChannelCount()) {
-            channels = 1;
+        std::vector<xLightsVamp::PluginRun> runs(1);
+        runs[0].Plugin = p;
+        runs[0].Output = output;
+        runs[0].Step = step;
+        runs[0].Block = block;
+        runs[0].Channels = media->GetChannels();
+        if (runs[0].Channels > p->getMaxChannelCount()) {
+            runs[0].Channels = 1;
         }
-        p->initialise(channels, step, block);
-        pdata[0] =media->GetLeftDataPtr(0);
-        pdata[1] = media->GetRightDataPtr(0);
-        
+
         wxProgressDialog progress("Processing Audio", "");
-        long totalLen = media->GetTrackSize();
-        long len = media->GetTrackSize();
-		int percent = 0;
-        long start = 0;
-        while (len) {
-            //int request = block;
-            //if (request > len) request = len;
-
-			pdata[0] = media->GetLeftDataPtr(start);
-			pdata[1] = media->GetRightDataPtr(start);
-
-            Vamp::RealTime timestamp = Vamp::RealTime::frame2RealTime(start, media->GetRate());
-            Vamp::Plugin::FeatureSet features = p->process(pdata, timestamp);
-            processFeatures(features[output], starts, ends, labels);
-
-            if (len > (long)step) {
-                len -= step;
-            } else {
-                len = 0;
-            }
-            start += step;
-            
-            int newp = (int)((start * 100) / totalLen);
-            if (newp != percent) {
-                percent = newp;
-                progress.Update(percent);
-            }
-        }
-        Vamp::Plugin::FeatureSet features = p->getRemainingFeatures();
-        processFeatures(features[output], starts, ends, labels);
-        progress.Update(100);
+        media->RunVampPlugins(runs, [&progress](int pct) { progress.Update(pct); });
+        processFeatures(runs[0].Features, starts, ends, labels);
 
         xml_file->AddNewTimingSection(TimingName->GetValue().ToStdString(), xLightsParent, starts, ends, labels);
         return TimingName->GetValue();
@@ -687,8 +687,11 @@ bool FPP::PrepareUploadSequence(const FSEQFile &file,
         return uploadOrCopyFile(baseName, seq, uploadCompressed, fn.GetExt() == "eseq" ? "effects" : "sequences");
     }
     
-    if (type == 1 && file.getVersionMajor() == 2) {
-        // Full v2 file, upload directly
+    const V2FSEQFile *v2file = dynamic_cast<const V2FSEQFile*>(&file);
+    if (type == 1 && file.getVersionMajor() == 2
+        && (v2file == nullptr || v2file->m_compressionType != FSEQFile::CompressionType::zstd_delta)) {
+        // Full v2 file, upload directly.  FPP cannot decode frame delta compression so those
+        // fall through and get re-encoded with plain zstd
         return uploadOrCopyFile(baseName, seq, false, fn.GetExt() == "eseq" ? "effects" : "sequences");
     }
     baseSeqName = baseName;
@@ -297,38 +297,40 @@ void FireEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer &
     }
     
     //  Now play fire
-    for (y=0; y<maxHt; y++)
-    {
-        for (x=0; x<maxWi; x++)
+    ParallelForRows(buffer, [&](int startY, int endY, std::minstd_rand &) {
+        for (int yp = startY; yp < endY; yp++)
         {
-            int xp = x;
-            int yp = y;
-            if (loc == 1 || loc == 3) {
-                yp = maxHt - y - 1;
-            }
-            if (loc == 2 || loc == 3) {
-                int t = xp;
-                xp = yp;
-                yp = t;
-            }
-            if (HueShift>0) {
-                HSVValue hsv = FirePalette[GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)];
-                hsv.hue = hsv.hue +(HueShift/100.0);
-                if (hsv.hue>1.0) hsv.hue=1.0;
-                if (buffer.allowAlpha) {
-                    xlColor c(hsv);
-                    c.alpha = FirePalette.asAlphaColor(GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)).Alpha();
-                    buffer.SetPixel(xp, yp, c);
-                } else {
-                    buffer.SetPixel(xp, yp, hsv);
+            for (int xp = 0; xp < buffer.BufferWi; xp++)
+            {
+                // work back from the buffer pixel to the fire cell that lands on it
+                int x = xp;
+                int y = yp;
+                if (loc == 2 || loc == 3) {
+                    x = yp;
+                    y = xp;
                 }
-            } else {
-                if (buffer.allowAlpha) {
-                    buffer.SetPixel(xp, yp, FirePalette.asAlphaColor(GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)));
+                if (loc == 1 || loc == 3) {
+                    y = maxHt - y - 1;
+                }
+                if (HueShift>0) {
+                    HSVValue hsv = FirePalette[GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)];
+                    hsv.hue = hsv.hue +(HueShift/100.0);
+                    if (hsv.hue>1.0) hsv.hue=1.0;
+                    if (buffer.allowAlpha) {
+                        xlColor c(hsv);
+                        c.alpha = FirePalette.asAlphaColor(GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)).Alpha();
+                        buffer.SetPixel(xp, yp, c);
+                    } else {
+                        buffer.SetPixel(xp, yp, hsv);
+                    }
                 } else {
-                    buffer.SetPixel(xp, yp, FirePalette.asColor(GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)));
+                    if (buffer.allowAlpha) {
+                        buffer.SetPixel(xp, yp, FirePalette.asAlphaColor(GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)));
+                    } else {
+                        buffer.SetPixel(xp, yp, FirePalette.asColor(GetFireBuffer(x,y, cache->FireBuffer, maxMWi, maxMHt)));
+                    }
                 }
             }
         }
-    }
+    });
 }
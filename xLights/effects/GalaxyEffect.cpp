@@ -324,21 +324,24 @@ void GalaxyEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer
         // blend old data down into final buffer
         if( blend_edges && ( (inward ? (last_check-abs(adj_angle)) : (abs(adj_angle)-last_check)) >= 90.0) )
         {
-            for( int x = 0; x < buffer.BufferWi; x++ )
-            {
-                for( int y = 0; y < buffer.BufferHt; y++ )
+            ParallelForRows(buffer, [&buffer, &temp_colors_pct, &pixel_age, inward, adj_angle](int startY, int endY, std::minstd_rand &) {
+                xlColor color, c_old, c_new;
+                for( int x = 0; x < buffer.BufferWi; x++ )
                 {
-                    if( temp_colors_pct[x][y] > 0.0 && ((inward ? (pixel_age[x][y]-abs(adj_angle)) : (abs(adj_angle)-pixel_age[x][y])) >= 180.0) )
+                    for( int y = startY; y < endY; y++ )
                     {
-                        buffer.GetTempPixel(x,y,c_new);
-                        buffer.GetPixel(x,y,c_old);
-                        buffer.Get2ColorAlphaBlend(c_old, c_new, temp_colors_pct[x][y], color);
-                        buffer.SetPixel(x,y,color);
-                        temp_colors_pct[x][y] = 0.0;
-                        pixel_age[x][y] = 0.0;
+                        if( temp_colors_pct[x][y] > 0.0 && ((inward ? (pixel_age[x][y]-abs(adj_angle)) : (abs(adj_angle)-pixel_age[x][y])) >= 180.0) )
+                        {
+                            buffer.GetTempPixel(x,y,c_new);
+                            buffer.GetPixel(x,y,c_old);
+                            buffer.Get2ColorAlphaBlend(c_old, c_new, temp_colors_pct[x][y], color);
+                            buffer.SetPixel(x,y,color);
+                            temp_colors_pct[x][y] = 0.0;
+                            pixel_age[x][y] = 0.0;
+                        }
                     }
                 }
-            }
+            });
             last_check = abs(adj_angle);
         }
         step = GetStep(current_radius+half_width);
@@ -411,19 +414,22 @@ void GalaxyEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer
     // blend remaining data down into final buffer
     if( blend_edges )
     {
-        for( int x = 0; x < buffer.BufferWi; x++ )
-        {
-            for( int y = 0; y < buffer.BufferHt; y++ )
+        ParallelForRows(buffer, [&buffer, &temp_colors_pct](int startY, int endY, std::minstd_rand &) {
+            xlColor color, c_old, c_new;
+            for( int x = 0; x < buffer.BufferWi; x++ )
             {
-                if( temp_colors_pct[x][y] > 0.0 )
+                for( int y = startY; y < endY; y++ )
                 {
-                    buffer.GetTempPixel(x,y,c_new);
-                    buffer.GetPixel(x,y,c_old);
-                    buffer.Get2ColorAlphaBlend(c_old, c_new, temp_colors_pct[x][y], color);
-                    buffer.SetPixel(x,y,color);
+                    if( temp_colors_pct[x][y] > 0.0 )
+                    {
+                        buffer.GetTempPixel(x,y,c_new);
+                        buffer.GetPixel(x,y,c_old);
+                        buffer.Get2ColorAlphaBlend(c_old, c_new, temp_colors_pct[x][y], color);
+                        buffer.SetPixel(x,y,color);
+                    }
                 }
             }
-        }
+        });
     }
 
 }
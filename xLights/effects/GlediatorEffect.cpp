@@ -242,7 +242,7 @@ std::list<std::string> GlediatorEffect::GetFileReferences(const SettingsMap &Set
 bool GlediatorEffect::CleanupFileLocations(xLightsFrame* frame, SettingsMap &SettingsMap)
 {
     bool rc = false;
-    wxString file = SettingsMap["E_FILEPICKERCTRL_Glediator_Filename"];
+    wxString file = SettingsMap.Get("E_FILEPICKERCTRL_Glediator_Filename", "");
     if (wxFile::Exists(file))
     {
         if (!frame->IsInShowFolder(file))
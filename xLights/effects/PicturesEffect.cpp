@@ -114,7 +114,7 @@ void PicturesEffect::adjustSettings(const std::string &version, Effect *effect,
         settings.erase("E_CHECKBOX_Pictures_ScaleToFit");
     }
 
-    std::string file = settings["E_FILEPICKER_Pictures_Filename"];
+    std::string file = settings.Get("E_FILEPICKER_Pictures_Filename", "");
     if (file != "")
     {
         if (!wxFile::Exists(file))
@@ -125,7 +125,7 @@ void PicturesEffect::adjustSettings(const std::string &version, Effect *effect,
 
     if (IsVersionOlder("2016.9", version))
     {
-        if (settings["E_CHOICE_Pictures_Direction"] == "scaled")
+        if (settings.Get("E_CHOICE_Pictures_Direction", "") == "scaled")
         {
             settings["E_CHOICE_Pictures_Direction"] = "none";
             settings["E_CHOICE_Scaling"] = "Scale To Fit";
@@ -404,7 +404,7 @@ std::list<std::string> PicturesEffect::GetFileReferences(const SettingsMap &Sett
 bool PicturesEffect::CleanupFileLocations(xLightsFrame* frame, SettingsMap &SettingsMap)
 {
     bool rc = false;
-    wxString file = SettingsMap["E_FILEPICKER_Pictures_Filename"];
+    wxString file = SettingsMap.Get("E_FILEPICKER_Pictures_Filename", "");
     if (wxFile::Exists(file))
     {
         if (!frame->IsInShowFolder(file))
@@ -64,7 +64,7 @@ void PinwheelEffect::adjustSettings(const std::string &version, Effect *effect,
     }
     SettingsMap &settings = effect->GetSettings();
     if (settings.Contains("E_TEXTCTRL_Pinwheel_Speed")) {
-        std::string val = settings["E_TEXTCTRL_Pinwheel_Speed"];
+        std::string val = settings.Get("E_TEXTCTRL_Pinwheel_Speed", "");
         settings.erase("E_TEXTCTRL_Pinwheel_Speed");
         settings["E_SLIDER_Pinwheel_Speed"] = val;
     }
@@ -11,7 +11,6 @@
 #include "../../include/plasma-48.xpm"
 #include "../../include/plasma-64.xpm"
 
-#include "../Parallel.h"
 
 PlasmaEffect::PlasmaEffect(int id) : RenderableEffect(id, "Plasma", plasma_16, plasma_24, plasma_32, plasma_48, plasma_64)
 {
@@ -88,73 +87,93 @@ void PlasmaEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer
     const double sin_time_2 = buffer.sin(time / 2);
     static const double pi3 = pi / 3.0;
 
-    int block = buffer.BufferHt * buffer.BufferWi > 100 ? 1 : -1;
-    parallel_for(0, buffer.BufferWi, [&] (int x) {
-        double rx = ((float)x / (buffer.BufferWi - 1)); // rx is now in the range 0.0 to 1.0
-        double rx2 = rx * rx;
-        double cx = rx + .5*sin_time_5;
-        double cx2 = cx*cx;
-        double sin_rx_time = buffer.sin(rx + time);
+    // the terms that only depend on the column are worked out once rather than for every row
+    struct PlasmaColumn {
+        double rx;
+        double rx2;
+        double cx2;
+        double sin_rx_time;
+        double v1;
+    };
+    std::vector<PlasmaColumn> columns(buffer.BufferWi);
+    for (int x = 0; x < buffer.BufferWi; x++) {
+        PlasmaColumn &c = columns[x];
+        c.rx = ((float)x / (buffer.BufferWi - 1)); // rx is now in the range 0.0 to 1.0
+        c.rx2 = c.rx * c.rx;
+        double cx = c.rx + .5*sin_time_5;
+        c.cx2 = cx*cx;
+        c.sin_rx_time = buffer.sin(c.rx + time);
 
         // 1st equation
-        double v1 = buffer.sin(rx * 10 + time);
+        c.v1 = buffer.sin(c.rx * 10 + time);
+    }
 
-        for (int y=0; y<buffer.BufferHt; y++)
+    ParallelForRows(buffer, [&] (int startY, int endY, std::minstd_rand &) {
+        for (int y = startY; y < endY; y++)
         {
-            // reference: http://www.bidouille.org/prog/plasma
-
-            double ry = ((float)y/(buffer.BufferHt-1)) ;
-            double v = v1;
-
-            //  second equation
-            v+=buffer.sin (10*(rx*sin_time_2+ry*cos_time_3)+time);
-
-            //  third equation
-            double cy=ry+.5*cos_time_3;
-            v+=buffer.sin ( sqrt((Style*50)*((cx2)+(cy*cy))+time));
-
-            //    vec2 c = v_coords * u_k - u_k/2.0;
-            v += sin_rx_time;
-            v += buffer.sin ((ry+time)/2.0);
-            v += buffer.sin ((rx+ry+time)/2.0);
-            //   c += u_k/2.0 * vec2(buffer.sin (u_time/3.0), buffer.cos (u_time/2.0));
-            v += buffer.sin (sqrt(rx2+ry*ry)+time);
-            v = v/2.0;
-            // vec3 col = vec3(1, buffer.sin (PI*v), buffer.cos (PI*v));
-            //   gl_FragColor = vec4(col*.5 + .5, 1);
-
-            double vldpi = v*Line_Density*pi;
-
-            xlColor color;
-            switch (ColorScheme)
+            for (int x = 0; x < buffer.BufferWi; x++)
             {
-                case PLASMA_NORMAL_COLORS:
-                    {
-                        double h = (buffer.sin (vldpi + 2 * pi3) + 1) * 0.5;
-                        buffer.GetMultiColorBlend(h,false,color);
-                    }
-                    break;
-                case PLASMA_PRESET1:
-                    color.red = (buffer.sin (vldpi) + 1) * 128;
-                    color.green = (buffer.cos (vldpi) + 1) * 128;
-                    color.blue = 0;
-                    break;
-                case PLASMA_PRESET2:
-                    color.red = 1;
-                    color.green = (buffer.cos (vldpi) + 1) * 128;
-                    color.blue = (buffer.sin (vldpi) + 1) * 128;
-                    break;
-
-                case PLASMA_PRESET3:
-                    color.red = (buffer.sin (vldpi) + 1) * 128;
-                    color.green = (buffer.sin (vldpi + 2 * pi3) + 1) * 128;
-                    color.blue = (buffer.sin (vldpi + 4 * pi3) + 1) * 128;
-                    break;
-                case PLASMA_PRESET4:
-                    color.red=color.green=color.blue = (buffer.sin(vldpi) + 1) * 128;
-                    break;
+                const double rx = columns[x].rx;
+                const double rx2 = columns[x].rx2;
+                const double cx2 = columns[x].cx2;
+                const double sin_rx_time = columns[x].sin_rx_time;
+                const double v1 = columns[x].v1;
+
+                // reference: http://www.bidouille.org/prog/plasma
+
+                double ry = ((float)y/(buffer.BufferHt-1)) ;
+                double v = v1;
+
+                //  second equation
+                v+=buffer.sin (10*(rx*sin_time_2+ry*cos_time_3)+time);
+
+                //  third equation
+                double cy=ry+.5*cos_time_3;
+                v+=buffer.sin ( sqrt((Style*50)*((cx2)+(cy*cy))+time));
+
+                //    vec2 c = v_coords * u_k - u_k/2.0;
+                v += sin_rx_time;
+                v += buffer.sin ((ry+time)/2.0);
+                v += buffer.sin ((rx+ry+time)/2.0);
+                //   c += u_k/2.0 * vec2(buffer.sin (u_time/3.0), buffer.cos (u_time/2.0));
+                v += buffer.sin (sqrt(rx2+ry*ry)+time);
+                v = v/2.0;
+                // vec3 col = vec3(1, buffer.sin (PI*v), buffer.cos (PI*v));
+                //   gl_FragColor = vec4(col*.5 + .5, 1);
+
+                double vldpi = v*Line_Density*pi;
+
+                xlColor color;
+                switch (ColorScheme)
+                {
+                    case PLASMA_NORMAL_COLORS:
+                        {
+                            double h = (buffer.sin (vldpi + 2 * pi3) + 1) * 0.5;
+                            buffer.GetMultiColorBlend(h,false,color);
+                        }
+                        break;
+                    case PLASMA_PRESET1:
+                        color.red = (buffer.sin (vldpi) + 1) * 128;
+                        color.green = (buffer.cos (vldpi) + 1) * 128;
+                        color.blue = 0;
+                        break;
+                    case PLASMA_PRESET2:
+                        color.red = 1;
+                        color.green = (buffer.cos (vldpi) + 1) * 128;
+                        color.blue = (buffer.sin (vldpi) + 1) * 128;
+                        break;
+
+                    case PLASMA_PRESET3:
+                        color.red = (buffer.sin (vldpi) + 1) * 128;
+                        color.green = (buffer.sin (vldpi + 2 * pi3) + 1) * 128;
+                        color.blue = (buffer.sin (vldpi + 4 * pi3) + 1) * 128;
+                        break;
+                    case PLASMA_PRESET4:
+                        color.red=color.green=color.blue = (buffer.sin(vldpi) + 1) * 128;
+                        break;
+                }
+                buffer.SetPixel(x,y,color);
             }
-            buffer.SetPixel(x,y,color);
         }
-    }, block);
+    });
 }
@@ -16,6 +16,7 @@
 #include "FanEffect.h"
 #include "SpiralsEffect.h"
 #include "PinwheelEffect.h"
+#include "../Parallel.h"
 
 RenderableEffect::RenderableEffect(int i, std::string n,
                                    const char **data16,
@@ -843,6 +844,26 @@ void RenderableEffect::AdjustSettingsToBeFitToTime(int effectIdx, SettingsMap &s
 }
 
 
+// roughly how many pixels each band of ParallelForRows covers, smaller buffers are not worth splitting
+#define PARALLEL_ROWS_BAND_PIXELS 4096
+
+void RenderableEffect::ParallelForRows(RenderBuffer &buffer, std::function<void(int, int, std::minstd_rand&)> &&f) {
+    if (buffer.BufferHt <= 0) return;
+
+    int rowsPerBand = std::max(1, PARALLEL_ROWS_BAND_PIXELS / std::max(1, buffer.BufferWi));
+    int bands = (buffer.BufferHt + rowsPerBand - 1) / rowsPerBand;
+    auto band = [&buffer, &f, rowsPerBand](int b) {
+        std::minstd_rand rng((unsigned int)buffer.curPeriod * 7919u + (unsigned int)b + 1u);
+        int startY = b * rowsPerBand;
+        f(startY, std::min(startY + rowsPerBand, buffer.BufferHt), rng);
+    };
+    if (bands == 1) {
+        band(0);
+    } else {
+        parallel_for(0, bands, band);
+    }
+}
+
 void RenderableEffect::SetSliderValue(wxSlider *slider, int value) {
     slider->SetValue(value);
     wxScrollEvent event(wxEVT_SLIDER, slider->GetId());
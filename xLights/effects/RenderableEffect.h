@@ -3,6 +3,8 @@
 
 #include <wx/bitmap.h>
 #include <string>
+#include <functional>
+#include <random>
 #include "../Color.h"
 #include "assist/AssistPanel.h"
 
@@ -83,6 +85,11 @@ class RenderableEffect
         static void SetTextValue(wxTextCtrl* choice, std::string value);
         static void SetCheckBoxValue(wxCheckBox *w, bool b);
 
+        // Runs f over bands of rows of the buffer on the ParallelJobPool, each call gets the rows [startY, endY)
+        // and a random number generator seeded from the frame and band.  The bands depend only on the buffer
+        // size so an effect that only writes pixels in its own rows produces the same output on any number of threads.
+        static void ParallelForRows(RenderBuffer &buffer, std::function<void(int startY, int endY, std::minstd_rand &rng)> &&f);
+
         double GetValueCurveDouble(const std::string & name, double def, SettingsMap &SettingsMap, float offset, double min, double max, long startMS, long endMS, int divisor = 1);
         int GetValueCurveInt(const std::string &name, int def, SettingsMap &SettingsMap, float offset, int min, int max, long startMS, long endMS, int divisor = 1);
         bool IsVersionOlder(const std::string& compare, const std::string& version);
@@ -78,7 +78,7 @@ std::list<std::string> TextEffect::GetFileReferences(const SettingsMap &Settings
 bool TextEffect::CleanupFileLocations(xLightsFrame* frame, SettingsMap &SettingsMap)
 {
     bool rc = false;
-    wxString file = SettingsMap["E_FILEPICKERCTRL_Text_File"];
+    wxString file = SettingsMap.Get("E_FILEPICKERCTRL_Text_File", "");
     if (wxFile::Exists(file))
     {
         if (!frame->IsInShowFolder(file))
@@ -136,9 +136,9 @@ void TextEffect::adjustSettings(const std::string &version, Effect *effect, bool
             EffectLayer* el = effect->GetParentEffectLayer();
             Element* elem = el->GetParentElement();
 
-            std::string line2 = settings["E_TEXTCTRL_Text_Line2"];
-            std::string line3 = settings["E_TEXTCTRL_Text_Line3"];
-            std::string line4 = settings["E_TEXTCTRL_Text_Line4"];
+            std::string line2 = settings.Get("E_TEXTCTRL_Text_Line2", "");
+            std::string line3 = settings.Get("E_TEXTCTRL_Text_Line3", "");
+            std::string line4 = settings.Get("E_TEXTCTRL_Text_Line4", "");
 
             if (line2 != "") {
                 std::string palette = effect->GetPaletteAsString();
@@ -154,7 +154,7 @@ void TextEffect::adjustSettings(const std::string &version, Effect *effect, bool
                 new_settings["E_CHOICE_Text_Effect"] = settings["E_CHOICE_Text_Effect2"];
                 new_settings["E_FONTPICKER_Text_Font"] = settings["E_FONTPICKER_Text_Font2"];
                 new_settings["E_TEXTCTRL_Text_Speed"] = settings["E_TEXTCTRL_Text_Speed2"];
-                int pos = (wxAtoi(settings["E_SLIDER_Text_Position2"]) * 2) - 100;
+                int pos = (wxAtoi(settings.Get("E_SLIDER_Text_Position2", "")) * 2) - 100;
                 wxString strpos = wxString::Format("%d", pos);
                 new_settings["E_SLIDER_Text_XStart"] = "0";
                 new_settings["E_SLIDER_Text_XEnd"] = "0";
@@ -177,7 +177,7 @@ void TextEffect::adjustSettings(const std::string &version, Effect *effect, bool
                 new_settings["E_CHOICE_Text_Effect"] = settings["E_CHOICE_Text_Effect3"];
                 new_settings["E_FONTPICKER_Text_Font"] = settings["E_FONTPICKER_Text_Font3"];
                 new_settings["E_TEXTCTRL_Text_Speed"] = settings["E_TEXTCTRL_Text_Speed3"];
-                int pos = (wxAtoi(settings["E_SLIDER_Text_Position3"]) * 2) - 100;
+                int pos = (wxAtoi(settings.Get("E_SLIDER_Text_Position3", "")) * 2) - 100;
                 wxString strpos = wxString::Format("%d", pos);
                 new_settings["E_SLIDER_Text_XStart"] = "0";
                 new_settings["E_SLIDER_Text_XEnd"] = "0";
@@ -200,7 +200,7 @@ void TextEffect::adjustSettings(const std::string &version, Effect *effect, bool
                 new_settings["E_CHOICE_Text_Effect"] = settings["E_CHOICE_Text_Effect4"];
                 new_settings["E_FONTPICKER_Text_Font"] = settings["E_FONTPICKER_Text_Font4"];
                 new_settings["E_TEXTCTRL_Text_Speed"] = settings["E_TEXTCTRL_Text_Speed4"];
-                int pos = (wxAtoi(settings["E_SLIDER_Text_Position4"]) * 2) - 100;
+                int pos = (wxAtoi(settings.Get("E_SLIDER_Text_Position4", "")) * 2) - 100;
                 wxString strpos = wxString::Format("%d", pos);
                 new_settings["E_SLIDER_Text_XStart"] = "0";
                 new_settings["E_SLIDER_Text_XEnd"] = "0";
@@ -252,7 +252,7 @@ void TextEffect::adjustSettings(const std::string &version, Effect *effect, bool
         }
     }
 
-    wxString file = settings["E_FILEPICKERCTRL_Text_File"];
+    wxString file = settings.Get("E_FILEPICKERCTRL_Text_File", "");
     if (file != "")
     {
         if (!wxFile::Exists(file))
@@ -111,7 +111,7 @@ void VideoEffect::adjustSettings(const std::string &version, Effect *effect, boo
         settings.erase("E_CHECKBOX_Video_Loop");
     }
 
-    std::string file = settings["E_FILEPICKERCTRL_Video_Filename"];
+    std::string file = settings.Get("E_FILEPICKERCTRL_Video_Filename", "");
 
     if (file != "")
     {
@@ -156,7 +156,7 @@ std::list<std::string> VideoEffect::GetFileReferences(const SettingsMap &Setting
 bool VideoEffect::CleanupFileLocations(xLightsFrame* frame, SettingsMap &SettingsMap)
 {
     bool rc = false;
-    wxString file = SettingsMap["E_FILEPICKERCTRL_Video_Filename"];
+    wxString file = SettingsMap.Get("E_FILEPICKERCTRL_Video_Filename", "");
     if (wxFile::Exists(file))
     {
         if (!frame->IsInShowFolder(file))
@@ -129,6 +129,10 @@ void CustomModel::AddTypeProperties(wxPropertyGridInterface *grid) {
                                              "CustomBkgImage",
                                              custom_background));
     p->SetAttribute(wxPG_FILE_WILDCARD, "Image files|*.png;*.bmp;*.jpg;*.gif|All files (*.*)|*.*");
+
+    // compressed storage cant be read by older versions so it is only used if asked for
+    p = grid->Append(new wxBoolProperty("Compressed Storage", "CustomModelCompress", ModelXml->GetAttribute("CustomModelCompress", "0") == "1"));
+    p->SetAttribute("UseCheckbox", true);
 }
 
 int CustomModel::OnPropertyGridChange(wxPropertyGridInterface *grid, wxPropertyGridEvent& event) {
@@ -146,6 +150,15 @@ int CustomModel::OnPropertyGridChange(wxPropertyGridInterface *grid, wxPropertyG
         SetFromXml(ModelXml, zeroBased);
         return GRIDCHANGE_MARK_DIRTY_AND_REFRESH;
     }
+    else if ("CustomModelCompress" == event.GetPropertyName()) {
+        std::string data = GetCustomData();
+        ModelXml->DeleteAttribute("CustomModelCompress");
+        if (event.GetValue().GetBool()) {
+            ModelXml->AddAttribute("CustomModelCompress", "1");
+        }
+        SetCustomData(data);
+        return GRIDCHANGE_MARK_DIRTY;
+    }
     else if ("CustomModelStrings" == event.GetPropertyName())
     {
         _strings = event.GetValue().GetInteger();
@@ -187,51 +200,143 @@ int CustomModel::OnPropertyGridChange(wxPropertyGridInterface *grid, wxPropertyG
     return Model::OnPropertyGridChange(grid, event);
 }
 
-std::tuple<int,int,int> FindNode(int node, const std::vector<std::vector<std::vector<int>>>& locations)
+// Single pass parser for the custom model grid. Layers are separated by '|', rows by ';' and columns by ','.
+// Calls cell(layer, row, col, node) for every cell holding a positive node number without allocating anything
+// and returns the grid dimensions. Cells which do not start with a number are treated as empty.
+template <typename CELL>
+static void ParseCustomModelGrid(const std::string& data, int& width, int& height, int& depth, CELL&& cell)
 {
-    for (int l = 0; l < locations.size(); l++)
-    {
-        for (int r = 0; r < locations[l].size(); r++)
-        {
-            for (int c = 0; c < locations[l][r].size(); c++)
-            {
-                if (locations[l][r][c] == node+1)
-                {
-                    return { l, r, c };
-                }
+    width = 1;
+    height = 1;
+    depth = 1;
+
+    int layer = 0;
+    int row = 0;
+    int col = 0;
+    const char* p = data.c_str();
+    const char* end = p + data.size();
+    while (p <= end) {
+        while (p < end && *p == ' ') p++;
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            neg = *p == '-';
+            p++;
+        }
+        long value = 0;
+        bool digits = false;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value = value * 10 + (*p - '0');
+            digits = true;
+            p++;
+        }
+        if (digits && !neg && value > 0) {
+            cell(layer, row, col, (int)value);
+        }
+        while (p < end && *p != ',' && *p != ';' && *p != '|') p++;
+
+        width = std::max(width, col + 1);
+        height = std::max(height, row + 1);
+        depth = std::max(depth, layer + 1);
+        if (p == end) break;
+        switch (*p) {
+        case ',':
+            col++;
+            break;
+        case ';':
+            row++;
+            col = 0;
+            break;
+        case '|':
+            layer++;
+            row = 0;
+            col = 0;
+            break;
+        }
+        p++;
+    }
+}
+
+// The compressed form only lists the occupied cells as node,row,col[,layer] separated by ';'
+template <typename CELL>
+static void ParseCustomModelCompressed(const std::string& data, CELL&& cell)
+{
+    const char* p = data.c_str();
+    const char* end = p + data.size();
+    while (p < end) {
+        long v[4] = { 0, 0, 0, 0 };
+        int n = 0;
+        while (p < end && *p != ';') {
+            if (*p == ',') {
+                if (n < 3) n++;
+            } else if (*p >= '0' && *p <= '9') {
+                v[n] = v[n] * 10 + (*p - '0');
             }
+            p++;
         }
+        if (n >= 2 && v[0] > 0) {
+            cell((int)v[3], (int)v[1], (int)v[2], (int)v[0]);
+        }
+        if (p < end) p++;
     }
-    wxASSERT(false);
-    return { -1,-1,-1 };
 }
 
-std::vector<std::vector<std::vector<int>>> ParseCustomModel(const wxString& data, int width)
+// only worth using the compressed form on big sparse models ... it also cant be read by older versions
+// so it is only written when the model has CustomModelCompress set
+#define CUSTOM_MODEL_COMPRESS_THRESHOLD 100000
+
+static std::string CompressCustomModel(const std::string& data)
 {
-    std::vector<std::vector<std::vector<int>>> res;
+    int width, height, depth;
+    std::string res;
+    ParseCustomModelGrid(data, width, height, depth, [&res](int layer, int row, int col, int node) {
+        res += std::to_string(node) + "," + std::to_string(row) + "," + std::to_string(col);
+        if (layer != 0) res += "," + std::to_string(layer);
+        res += ";";
+    });
+    return res;
+}
 
-    wxArrayString layers = wxSplit(data, '|');
-    for (auto l : layers)
-    {
-        std::vector<std::vector<int>> ll;
-        wxArrayString rows = wxSplit(l, ';');
-        for (auto r : rows)
-        {
-            std::vector<int> rr;
-            wxArrayString columns = wxSplit(r, ',');
-            for (auto c : columns)
-            {
-                if (c == "") rr.push_back(-1);
-                else rr.push_back(wxAtoi(c));
+static std::string ExpandCustomModel(const std::string& compressed, int width, int height, int depth)
+{
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    depth = std::max(depth, 1);
+
+    std::vector<int> grid((size_t)width * height * depth, 0);
+    ParseCustomModelCompressed(compressed, [&grid, width, height, depth](int layer, int row, int col, int node) {
+        if (layer < depth && row < height && col < width) {
+            grid[((size_t)layer * height + row) * width + col] = node;
+        }
+    });
+
+    std::string res;
+    res.reserve(grid.size() * 2);
+    for (int l = 0; l < depth; l++) {
+        if (l != 0) res += "|";
+        for (int r = 0; r < height; r++) {
+            if (r != 0) res += ";";
+            for (int c = 0; c < width; c++) {
+                if (c != 0) res += ",";
+                int node = grid[((size_t)l * height + r) * width + c];
+                if (node != 0) res += std::to_string(node);
             }
-            while (rr.size() < width) rr.push_back(-1);
-            ll.push_back(rr);
         }
-        res.push_back(ll);
     }
     return res;
 }
 
+void CustomModel::ParseCustomModel(int& width, int& height, int& depth, std::function<void(int, int, int, int)> cell) const
+{
+    if (!ModelXml->HasAttribute("CustomModel") && ModelXml->HasAttribute("CustomModelCompressed")) {
+        width = std::max((int)parm1, 1);
+        height = std::max((int)parm2, 1);
+        depth = std::max(wxAtoi(ModelXml->GetAttribute("Depth", "1")), 1);
+        ParseCustomModelCompressed(ModelXml->GetAttribute("CustomModelCompressed").ToStdString(), cell);
+    } else {
+        ParseCustomModelGrid(ModelXml->GetAttribute("CustomModel").ToStdString(), width, height, depth, cell);
+    }
+}
+
 int CustomModel::GetStrandLength(int strand) const {
     return Nodes.size();
 }
@@ -241,8 +346,7 @@ int CustomModel::MapToNodeIndex(int strand, int node) const {
 }
 
 void CustomModel::InitModel() {
-    std::string customModel = ModelXml->GetAttribute("CustomModel").ToStdString();
-    InitCustomMatrix(customModel);
+    InitCustomMatrix();
     //CopyBufCoord2ScreenCoord();
     custom_background = ModelXml->GetAttribute("CustomBkgImage").ToStdString();
     _strings = wxAtoi(ModelXml->GetAttribute("CustomStrings", "1"));
@@ -272,12 +376,25 @@ void CustomModel::SetCustomDepth(long d)
 }
 
 std::string CustomModel::GetCustomData() const {
+    if (!ModelXml->HasAttribute("CustomModel") && ModelXml->HasAttribute("CustomModelCompressed")) {
+        return ExpandCustomModel(ModelXml->GetAttribute("CustomModelCompressed").ToStdString(), parm1, parm2, _depth);
+    }
     return ModelXml->GetAttribute("CustomModel").ToStdString();
 }
 
 void CustomModel::SetCustomData(const std::string &data) {
     ModelXml->DeleteAttribute("CustomModel");
-    ModelXml->AddAttribute("CustomModel", data);
+    ModelXml->DeleteAttribute("CustomModelCompressed");
+    if (ModelXml->GetAttribute("CustomModelCompress", "0") == "1" && data.size() > CUSTOM_MODEL_COMPRESS_THRESHOLD) {
+        std::string compressed = CompressCustomModel(data);
+        if (compressed.size() < data.size() / 2) {
+            ModelXml->AddAttribute("CustomModelCompressed", compressed);
+        } else {
+            ModelXml->AddAttribute("CustomModel", data);
+        }
+    } else {
+        ModelXml->AddAttribute("CustomModel", data);
+    }
     SetFromXml(ModelXml, zeroBased);
 }
 
@@ -331,9 +448,8 @@ std::list<std::string> CustomModel::GetFileReferences()
 }
 
 void CustomModel::SetStringStartChannels(bool zeroBased, int NumberOfStrings, int StartChannel, int ChannelsPerString) {
-    std::string customModel = ModelXml->GetAttribute("CustomModel").ToStdString();
     _strings = wxAtoi(ModelXml->GetAttribute("CustomStrings", "1").ToStdString());
-    int maxval=GetCustomMaxChannel(customModel);
+    int maxval=GetCustomMaxChannel();
     // fix NumberOfStrings
     if (SingleNode) {
         NumberOfStrings=maxval;
@@ -365,21 +481,6 @@ int CustomModel::NodesPerString() const
     return GetChanCount() / GetChanCountPerNode();
 }
 
-inline void split(std::string frag, char splitBy, std::vector<std::string>& tokens)
-{
-    // Loop infinitely - break is internal.
-    while(true) {
-        size_t splitAt = frag.find(splitBy);
-        // If we didn't find a new split point...
-        if (splitAt == std::string::npos) {
-            tokens.push_back(frag);
-            break;
-        }
-        tokens.push_back(frag.substr(0, splitAt));
-        frag.erase(0, splitAt + 1);
-    }
-}
-
 static std::vector<std::string> CUSTOM_BUFFERSTYLES =
 {
     "Default",
@@ -509,13 +610,21 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
 
     GetBufferSize(type, camera, transform, BufferWi, BufferHi);
 
-    auto locations = ParseCustomModel(ModelXml->GetAttribute("CustomModel"), parm1);
+    // location of each node in the grid as layer, row, column
+    auto FindNode = [this](size_t n, const std::vector<NodeBaseClassPtr>& nodes) {
+        int idx = nodes[n]->StringNum;
+        if (idx >= 0 && idx < _nodeLocations.size()) {
+            return _nodeLocations[idx];
+        }
+        wxASSERT(false);
+        return std::tuple<int, int, int>(-1, -1, -1);
+    };
 
     if (type == "Stacked X Horizontally")
     {
         for (auto n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = depth - std::get<0>(loc) - 1 + std::get<2>(loc) * depth;
             Nodes[n]->Coords[0].bufY = height - std::get<1>(loc) - 1;
         }
@@ -524,7 +633,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = std::get<2>(loc) + std::get<1>(loc) * width;
             Nodes[n]->Coords[0].bufY = std::get<0>(loc);
         }
@@ -537,7 +646,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = depth - std::get<0>(loc) - 1;
             Nodes[n]->Coords[0].bufY = std::get<1>(loc) + height * std::get<2>(loc);
         }
@@ -546,7 +655,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = std::get<2>(loc);
             Nodes[n]->Coords[0].bufY = std::get<0>(loc) + depth * std::get<1>(loc);
         }
@@ -555,7 +664,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = std::get<2>(loc);
             Nodes[n]->Coords[0].bufY = std::get<1>(loc) + depth * std::get<0>(loc);
         }
@@ -564,7 +673,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = depth - std::get<0>(loc) - 1;
             Nodes[n]->Coords[0].bufY = height - std::get<1>(loc) - 1;
         }
@@ -573,7 +682,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = std::get<2>(loc);
             Nodes[n]->Coords[0].bufY = std::get<0>(loc);
         }
@@ -582,7 +691,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = std::get<2>(loc);
             Nodes[n]->Coords[0].bufY = height - std::get<1>(loc) - 1;
         }
@@ -591,7 +700,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = depth - std::get<0>(loc) - 1 + std::get<2>(loc) * depth;
             Nodes[n]->Coords[0].bufY = std::get<1>(loc) + std::get<2>(loc) * height;
         }
@@ -600,7 +709,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = std::get<2>(loc) + std::get<1>(loc) * width;
             Nodes[n]->Coords[0].bufY = std::get<0>(loc) + std::get<1>(loc) * depth;
         }
@@ -609,7 +718,7 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     {
         for (size_t n = 0; n < Nodes.size(); n++)
         {
-            auto loc = FindNode(n, locations);
+            auto loc = FindNode(n, Nodes);
             Nodes[n]->Coords[0].bufX = std::get<2>(loc) + std::get<0>(loc) * width;
             Nodes[n]->Coords[0].bufY = std::get<1>(loc) + (height - std::get<1>(loc) - 1) * height;
         }
@@ -620,42 +729,20 @@ void CustomModel::InitRenderBufferNodes(const std::string& type, const std::stri
     }
 }
 
-int CustomModel::GetCustomMaxChannel(const std::string& customModel) const
+int CustomModel::GetCustomMaxChannel() const
 {
     int maxval = 0;
-
-    std::vector<std::string> layers;
-    std::vector<std::string> rows;
-    std::vector<std::string> cols;
-    layers.reserve(100);
-    rows.reserve(100);
-    cols.reserve(100);
-
-    split(customModel, '|', layers);
-
-    for (auto layer : layers) {
-        split(layer, ';', rows);
-        for (auto row : rows) {
-            cols.clear();
-            split(row, ',', cols);
-            for (auto col : cols) {
-                if (col != "") {
-                    try {
-                        maxval = std::max(std::stoi(col), maxval);
-                    }
-                    catch (...) {
-                        // not a number, treat as 0
-                    }
-                }
-            }
-        }
-    }
+    int width, height, depth;
+    ParseCustomModel(width, height, depth, [&maxval](int layer, int row, int col, int node) {
+        maxval = std::max(node, maxval);
+    });
     return maxval;
 }
 
-void CustomModel::InitCustomMatrix(const std::string& customModel) {
+void CustomModel::InitCustomMatrix() {
     int width = 1;
     int height = 1;
+    int depth = 1;
     std::vector<int> nodemap;
 
     long firstStartChan = 999999999;
@@ -664,95 +751,59 @@ void CustomModel::InitCustomMatrix(const std::string& customModel) {
         firstStartChan = std::min(it, firstStartChan);
     }
 
-    int cpn = -1;
-    std::vector<std::string> layers;
-    std::vector<std::string> rows;
-    std::vector<std::string> cols;
-    layers.reserve(20);
-    rows.reserve(100);
-    cols.reserve(100);
-
-    split(customModel, '|', layers);
-    int depth = layers.size();
-    int layer = 0;
-
-    for (auto lv : layers) {
-        rows.clear();
-        split(lv, ';', rows);
-        height = rows.size();
-
-        int row = 0;
-        for (auto rv : rows) {
-            cols.clear();
-            split(rv, ',', cols);
-            if (cols.size() > width) width = cols.size();
-            int col = 0;
-            for (auto value : cols) {
-                while (value.length() > 0 && value[0] == ' ') {
-                    value = value.substr(1);
-                }
-                long idx = -1;
-                if (value != "") {
-                    try {
-                        idx = std::stoi(value);
-                    }
-                    catch (...) {
-                        // not a number, treat as 0
-                    }
-                }
-                if (idx > 0) {
-                    // increase nodemap size if necessary
-                    if (idx > nodemap.size()) {
-                        nodemap.resize(idx, -1);
-                    }
-                    idx--;  // adjust to 0-based
-
-                    // is node already defined in map?
-                    if (nodemap[idx] < 0) {
-                        // unmapped - so add a node
-                        nodemap[idx] = Nodes.size();
-                        SetNodeCount(1, 0, rgbOrder);  // this creates a node of the correct class
-                        Nodes.back()->StringNum = idx;
-                        if (cpn == -1) {
-                            cpn = GetChanCountPerNode();
-                        }
-                        Nodes.back()->ActChan = firstStartChan + idx * cpn;
-                        if (idx < nodeNames.size() && nodeNames[idx] != "") {
-                            Nodes.back()->SetName(nodeNames[idx]);
-                        }
-                        else {
-                            Nodes.back()->SetName("Node " + std::to_string(idx + 1));
-                        }
+    // first collect the occupied cells ... the coordinates depend on the overall grid size
+    struct Cell { int layer; int row; int col; int node; };
+    std::vector<Cell> cells;
+    ParseCustomModel(width, height, depth, [&cells](int layer, int row, int col, int node) {
+        cells.push_back({ layer, row, col, node });
+    });
 
-                        Nodes.back()->AddBufCoord(layer * width + col, height - row - 1);
-                        auto& c = Nodes[nodemap[idx]]->Coords.back();
-                        c.screenX = col - width / 2;
-                        c.screenY = height - row - 1 - height / 2;
-                        c.screenZ = depth - layer - 1 - depth / 2;
-                    }
-                    else {
-                        // mapped - so add a coord to existing node
-                        Nodes[nodemap[idx]]->AddBufCoord(layer * width + col, height - row - 1);
-                        auto& c = Nodes[nodemap[idx]]->Coords.back();
-                        c.screenX = col - width / 2;
-                        c.screenY = height - row - 1 - height / 2;
-                        c.screenZ = depth - layer - 1 - depth / 2;
-                    }
-                }
-                col++;
-            }
-            row++;
+    _nodeLocations.clear();
+    int cpn = -1;
+    for (const auto& cell : cells) {
+        int layer = cell.layer;
+        int row = cell.row;
+        int col = cell.col;
+        long idx = cell.node;
+
+        // increase nodemap size if necessary
+        if (idx > nodemap.size()) {
+            nodemap.resize(idx, -1);
+            _nodeLocations.resize(idx, std::tuple<int, int, int>(-1, -1, -1));
         }
-        layer++;
-    }
-
-    for (int x = 0; x < Nodes.size(); x++) {
-        for (int y = x+1; y < Nodes.size(); y++) {
-            if (Nodes[y]->StringNum < Nodes[x]->StringNum) {
-                Nodes[x].swap(Nodes[y]);
+        idx--;  // adjust to 0-based
+
+        // is node already defined in map?
+        if (nodemap[idx] < 0) {
+            // unmapped - so add a node
+            nodemap[idx] = Nodes.size();
+            _nodeLocations[idx] = std::tuple<int, int, int>(layer, row, col);
+            SetNodeCount(1, 0, rgbOrder);  // this creates a node of the correct class
+            Nodes.back()->StringNum = idx;
+            if (cpn == -1) {
+                cpn = GetChanCountPerNode();
+            }
+            Nodes.back()->ActChan = firstStartChan + idx * cpn;
+            if (idx < nodeNames.size() && nodeNames[idx] != "") {
+                Nodes.back()->SetName(nodeNames[idx]);
+            }
+            else {
+                Nodes.back()->SetName("Node " + std::to_string(idx + 1));
             }
         }
+
+        // add a coord to the node
+        Nodes[nodemap[idx]]->AddBufCoord(layer * width + col, height - row - 1);
+        auto& c = Nodes[nodemap[idx]]->Coords.back();
+        c.screenX = col - width / 2;
+        c.screenY = height - row - 1 - height / 2;
+        c.screenZ = depth - layer - 1 - depth / 2;
     }
+
+    // node numbers are unique so the order only depends on the node number
+    std::sort(Nodes.begin(), Nodes.end(), [](const NodeBaseClassPtr& a, const NodeBaseClassPtr& b) {
+        return a->StringNum < b->StringNum;
+    });
     for (int x = 0; x < Nodes.size(); x++) {
         if (Nodes[x]->GetName() == "") {
             Nodes[x]->SetName(GetNodeName(Nodes[x]->StringNum));
@@ -941,27 +992,13 @@ std::string CustomModel::ChannelLayoutHtml(OutputManager* outputManager) {
             html+="<tr><td>No custom data</td></tr>";
     }
 
-    std::vector<std::vector<std::vector<wxString>>> _data;
-
-    int cols = parm1;
-    wxArrayString layers = wxSplit(data, '|');
-    for (auto l : layers)
-    {
-        std::vector<std::vector<wxString>> ll;
-        wxArrayString rows = wxSplit(l, ';');
-        for (auto r : rows)
-        {
-            std::vector<wxString> rr;
-            wxArrayString columns = wxSplit(r, ',');
-            for (auto c : columns)
-            {
-                rr.push_back(c);
-            }
-            while (rr.size() < cols) rr.push_back("");
-            ll.push_back(rr);
+    std::vector<int> grid((size_t)std::max((long)_depth, 1L) * std::max(parm1, 1L) * std::max(parm2, 1L), 0);
+    int width, height, depth;
+    ParseCustomModel(width, height, depth, [this, &grid](int layer, int row, int col, int node) {
+        if (layer < _depth && row < parm2 && col < parm1) {
+            grid[((size_t)layer * parm2 + row) * parm1 + col] = node;
         }
-        _data.push_back(ll);
-    }
+    });
 
     for (int r = 0; r < parm2; r++)
     {
@@ -970,18 +1007,18 @@ std::string CustomModel::ChannelLayoutHtml(OutputManager* outputManager) {
         {
             for (int c = 0; c < parm1; c++)
             {
-                wxString value = _data[l][r][c];
-                if (!value.IsEmpty() && value != "0")
+                int value = grid[((size_t)l * parm2 + r) * parm1 + c];
+                if (value != 0)
                 {
                     wxString bgcolor = "#ADD8E6"; //"#90EE90"
                     if (_strings == 1)
                     {
-                        html += wxString::Format("<td bgcolor='" + bgcolor + "'>n%s</td>", value);
+                        html += wxString::Format("<td bgcolor='" + bgcolor + "'>n%d</td>", value);
                     }
                     else
                     {
-                        int string = GetCustomNodeStringNumber(wxAtoi(value));
-                        html += wxString::Format("<td bgcolor='" + bgcolor + "'>n%ss%d</td>", value, string);
+                        int string = GetCustomNodeStringNumber(value);
+                        html += wxString::Format("<td bgcolor='" + bgcolor + "'>n%ds%d</td>", value, string);
                     }
                 }
                 else
@@ -1032,6 +1069,7 @@ void CustomModel::ImportXlightsModel(std::string filename, xLightsFrame* xlights
             // Add any model version conversion logic here
             // Source version will be the program version that created the custom model
 
+            ModelXml->DeleteAttribute("CustomModelCompressed");
             SetProperty("CustomModel", cm);
             SetProperty("parm1", p1);
             SetProperty("parm2", p2);
@@ -1338,6 +1376,7 @@ void CustomModel::ImportLORModel(std::string filename, xLightsFrame* xlights, fl
         }
         free(data);
 
+        ModelXml->DeleteAttribute("CustomModelCompressed");
         SetProperty("CustomModel", cm);
         logger_base.debug("Model import done.");
     }
@@ -1356,7 +1395,7 @@ void CustomModel::ExportXlightsModel()
     wxFile f(filename);
     //    bool isnew = !wxFile::Exists(filename);
     if (!f.Create(filename, true) || !f.IsOpened()) DisplayError(wxString::Format("Unable to create file %s. Error %d\n", filename, f.GetLastError()).ToStdString());
-    wxString cm = ModelXml->GetAttribute("CustomModel");
+    wxString cm = GetCustomData();
     wxString p1 = ModelXml->GetAttribute("parm1");
     wxString p2 = ModelXml->GetAttribute("parm2");
     wxString d = ModelXml->GetAttribute("Depth");
@@ -1,6 +1,9 @@
 #ifndef CUSTOMMODEL_H
 #define CUSTOMMODEL_H
 
+#include <functional>
+#include <tuple>
+
 #include "Model.h"
 
 class CustomModel : public ModelWithScreenLocation<BoxedScreenLocation>
@@ -61,8 +64,9 @@ class CustomModel : public ModelWithScreenLocation<BoxedScreenLocation>
         virtual void SetStringStartChannels(bool zeroBased, int NumberOfStrings, int StartChannel, int ChannelsPerString) override;
 
     private:
-        int GetCustomMaxChannel(const std::string& customModel) const;
-        void InitCustomMatrix(const std::string& customModel);
+        int GetCustomMaxChannel() const;
+        void InitCustomMatrix();
+        void ParseCustomModel(int& width, int& height, int& depth, std::function<void(int, int, int, int)> cell) const;
         static std::string StartNodeAttrName(int idx)
         {
             return wxString::Format(wxT("String%i"), idx + 1).ToStdString();  // a space between "String" and "%i" breaks the start channels listed in Indiv Start Chans
@@ -74,6 +78,7 @@ class CustomModel : public ModelWithScreenLocation<BoxedScreenLocation>
         std::string custom_background;
         int _strings;
         std::vector<int> stringStartNodes;
+        std::vector<std::tuple<int, int, int>> _nodeLocations; // layer, row, column of the first cell of each node number
 };
 
 #endif // CUSTOMMODEL_H
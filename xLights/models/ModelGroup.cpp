@@ -6,6 +6,8 @@
 #include "ModelManager.h"
 #include "SingleLineModel.h"
 #include "ModelScreenLocation.h"
+#include "../xLightsApp.h"
+#include "../xLightsMain.h"
 #include <log4cpp/Category.hh>
 
 static const std::string HORIZ("Horizontal Stack");
@@ -245,6 +247,7 @@ bool ModelGroup::Reset(bool zeroBased) {
     Nodes.clear();
     models.clear();
     modelNames.clear();
+    ClearLayoutCache();
     changeCount = 0;
     wxArrayString mn = wxSplit(ModelXml->GetAttribute("models"), ',');
     int nc = 0;
@@ -543,8 +546,70 @@ void ModelGroup::CheckForChanges() const {
     }
 }
 
+unsigned long ModelGroup::GetLayoutChangeCount() const {
+    // nested groups only pick up changes to their models when they are used so look through them
+    unsigned long l = 0;
+    for (auto it = models.begin(); it != models.end(); ++it) {
+        const ModelGroup *grp = dynamic_cast<const ModelGroup*>(*it);
+        if (grp != nullptr) {
+            l += grp->GetLayoutChangeCount();
+        } else {
+            l += (*it)->GetChangeCount();
+        }
+    }
+    return l;
+}
+
+std::string ModelGroup::GetLayoutKey(const std::string &type, const std::string &camera, const std::string &transform) const {
+    std::string key = type + "|" + camera + "|" + transform;
+    if (camera != "2D" && xLightsApp::GetFrame() != nullptr) {
+        // 3D cameras can be moved without changing their name
+        PreviewCamera* pcamera = xLightsApp::GetFrame()->viewpoint_mgr.GetNamedCamera3D(camera);
+        if (pcamera != nullptr) {
+            key += wxString::Format("|%f,%f,%f,%f,%f,%f,%f,%f,%f,%f",
+                pcamera->GetPosX(), pcamera->GetPosY(), pcamera->GetPosZ(),
+                pcamera->GetAngleX(), pcamera->GetAngleY(), pcamera->GetDistance(), pcamera->GetZoom(),
+                pcamera->GetPanX(), pcamera->GetPanY(), pcamera->GetPanZ()).ToStdString();
+        }
+    }
+    return key;
+}
+
+void ModelGroup::ClearLayoutCache() const {
+    std::unique_lock<std::mutex> lock(layoutLock);
+    layoutCache.clear();
+}
+
 void ModelGroup::GetBufferSize(const std::string &tp, const std::string &camera, const std::string &transform, int &BufferWi, int &BufferHt) const {
     CheckForChanges();
+
+    std::string key = GetLayoutKey(tp, camera, transform);
+    unsigned long cc = GetLayoutChangeCount();
+    {
+        std::unique_lock<std::mutex> lock(layoutLock);
+        auto it = layoutCache.find(key);
+        if (it != layoutCache.end() && it->second.changeCount == cc && it->second.hasSize) {
+            BufferWi = it->second.sizeWi;
+            BufferHt = it->second.sizeHt;
+            return;
+        }
+    }
+
+    CalcBufferSize(tp, camera, transform, BufferWi, BufferHt);
+
+    std::unique_lock<std::mutex> lock(layoutLock);
+    BufferLayout &layout = layoutCache[key];
+    if (layout.changeCount != cc) {
+        layout.hasNodes = false;
+        layout.nodes.clear();
+    }
+    layout.changeCount = cc;
+    layout.hasSize = true;
+    layout.sizeWi = BufferWi;
+    layout.sizeHt = BufferHt;
+}
+
+void ModelGroup::CalcBufferSize(const std::string &tp, const std::string &camera, const std::string &transform, int &BufferWi, int &BufferHt) const {
     std::string type = tp;
     if (type.compare(0, 9, "Per Model") == 0) {
         type = "Default";
@@ -656,6 +721,52 @@ void ModelGroup::InitRenderBufferNodes(const std::string &tp,
                                        std::vector<NodeBaseClassPtr> &Nodes,
                                        int &BufferWi, int &BufferHt) const {
     CheckForChanges();
+
+    if (!Nodes.empty()) {
+        // some layouts depend on the nodes already in the buffer so these cannot come from the cache
+        BuildRenderBufferNodes(tp, camera, transform, Nodes, BufferWi, BufferHt);
+        return;
+    }
+
+    std::string key = GetLayoutKey(tp, camera, transform);
+    unsigned long cc = GetLayoutChangeCount();
+    {
+        std::unique_lock<std::mutex> lock(layoutLock);
+        auto it = layoutCache.find(key);
+        if (it != layoutCache.end() && it->second.changeCount == cc && it->second.hasNodes) {
+            Nodes.reserve(it->second.nodes.size());
+            for (auto it2 = it->second.nodes.begin(); it2 != it->second.nodes.end(); ++it2) {
+                Nodes.push_back(NodeBaseClassPtr(it2->get()->clone()));
+            }
+            BufferWi = it->second.nodesWi;
+            BufferHt = it->second.nodesHt;
+            return;
+        }
+    }
+
+    BuildRenderBufferNodes(tp, camera, transform, Nodes, BufferWi, BufferHt);
+
+    std::unique_lock<std::mutex> lock(layoutLock);
+    BufferLayout &layout = layoutCache[key];
+    if (layout.changeCount != cc) {
+        layout.hasSize = false;
+    }
+    layout.changeCount = cc;
+    layout.hasNodes = true;
+    layout.nodesWi = BufferWi;
+    layout.nodesHt = BufferHt;
+    layout.nodes.clear();
+    layout.nodes.reserve(Nodes.size());
+    for (auto it = Nodes.begin(); it != Nodes.end(); ++it) {
+        layout.nodes.push_back(NodeBaseClassPtr(it->get()->clone()));
+    }
+}
+
+void ModelGroup::BuildRenderBufferNodes(const std::string &tp,
+                                        const std::string& camera,
+                                        const std::string &transform,
+                                        std::vector<NodeBaseClassPtr> &Nodes,
+                                        int &BufferWi, int &BufferHt) const {
     std::string type = tp;
     if (type.compare(0, 9, "Per Model") == 0) {
         type = "Default";
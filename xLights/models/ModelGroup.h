@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include <map>
+#include <mutex>
 
 #include "Model.h"
 
@@ -47,7 +49,29 @@ class ModelGroup : public ModelWithScreenLocation<BoxedScreenLocation>
         static std::vector<std::string> GROUP_BUFFER_STYLES;
 
     private:
+        // the buffer size and nodes for a buffer style/camera/transform ... built once and reused by every render job
+        struct BufferLayout
+        {
+            unsigned long changeCount = 0;
+            bool hasSize = false;
+            int sizeWi = 0;
+            int sizeHt = 0;
+            bool hasNodes = false;
+            int nodesWi = 0;
+            int nodesHt = 0;
+            std::vector<NodeBaseClassPtr> nodes;
+        };
+
         void CheckForChanges() const;
+        unsigned long GetLayoutChangeCount() const;
+        std::string GetLayoutKey(const std::string &type, const std::string &camera, const std::string &transform) const;
+        void ClearLayoutCache() const;
+        void CalcBufferSize(const std::string &type, const std::string &camera, const std::string &transform, int &BufferWi, int &BufferHi) const;
+        void BuildRenderBufferNodes(const std::string &type, const std::string &camera, const std::string &transform,
+                                    std::vector<NodeBaseClassPtr> &Nodes, int &BufferWi, int &BufferHi) const;
+
+        mutable std::mutex layoutLock;
+        mutable std::map<std::string, BufferLayout> layoutCache;
 
         std::vector<std::string> modelNames;
         std::vector<Model *> models;
@@ -1,5 +1,7 @@
 #include <wx/xml/xml.h>
 #include <wx/msgdlg.h>
+#include <wx/stopwatch.h>
+#include <algorithm>
 
 #include "ModelManager.h"
 #include "Model.h"
@@ -27,6 +29,7 @@
 #include "../xLightsMain.h"
 #include "UtilFunctions.h"
 #include "outputs/Output.h"
+#include "../Parallel.h"
 
 #include <log4cpp/Category.hh>
 
@@ -162,40 +165,131 @@ bool ModelManager::IsModelOverlapping(Model* model) const
 }
 
 void ModelManager::LoadModels(wxXmlNode *modelNode, int previewW, int previewH) {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    wxStopWatch sw;
+
     clear();
     previewWidth = previewW;
     previewHeight = previewH;
     this->modelNode = modelNode;
-    int countValid = 0;
+
+    // where a name is used more than once the last one wins
+    std::vector<wxXmlNode*> nodes;
+    std::map<std::string, int> nodeIndex;
     for (wxXmlNode* e=modelNode->GetChildren(); e!=nullptr; e=e->GetNext()) {
         if (e->GetName() == "model") {
             std::string name = e->GetAttribute("name").ToStdString();
             if (!name.empty()) {
-                Model *m = createAndAddModel(e, previewW, previewH);
-                if (m != nullptr) {
-                    countValid += m->CouldComputeStartChannel ? 1 : 0;
+                auto it = nodeIndex.find(name);
+                if (it == nodeIndex.end()) {
+                    nodeIndex[name] = nodes.size();
+                    nodes.push_back(e);
+                } else {
+                    nodes[it->second] = e;
                 }
             }
         }
     }
-    while (countValid != models.size()) {
-        int newCountValid = 0;
-        for (auto it = models.begin(); it != models.end(); ++it) {
-            if (!it->second->CouldComputeStartChannel) {
-                it->second->SetFromXml(it->second->GetModelXml());
-                newCountValid += it->second->CouldComputeStartChannel ? 1 : 0;
+
+    // Work out which models each model's start channel depends on and sort them into levels so that
+    // every model is created after the models it references. Models on the same level are independent
+    // and can be created in parallel. Anything in a reference loop never resolves and ends up on the
+    // last level where it will fail to calculate its start channel just like it always has.
+    std::vector<std::list<int>> dependents(nodes.size());
+    std::vector<int> waitingOn(nodes.size(), 0);
+    for (int i = 0; i < nodes.size(); i++) {
+        for (auto& d : GetStartChannelDependencies(nodes[i])) {
+            auto it = nodeIndex.find(d);
+            if (it != nodeIndex.end() && it->second != i) {
+                dependents[it->second].push_back(i);
+                waitingOn[i]++;
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> levels;
+    std::vector<int> current;
+    for (int i = 0; i < nodes.size(); i++) {
+        if (waitingOn[i] == 0) {
+            current.push_back(i);
+        }
+    }
+    int placed = 0;
+    while (!current.empty()) {
+        placed += current.size();
+        std::vector<int> next;
+        for (auto i : current) {
+            for (auto d : dependents[i]) {
+                if (--waitingOn[d] == 0) {
+                    next.push_back(d);
+                }
+            }
+        }
+        levels.push_back(current);
+        current.swap(next);
+    }
+    if (placed != nodes.size()) {
+        std::vector<int> unresolved;
+        for (int i = 0; i < nodes.size(); i++) {
+            if (waitingOn[i] > 0) {
+                unresolved.push_back(i);
+            }
+        }
+        levels.push_back(unresolved);
+    }
+
+    bool failed = false;
+    for (auto& level : levels) {
+        // keep document order within a level so the result does not depend on thread timing
+        std::sort(level.begin(), level.end());
+
+        // models only read the model list while being created so it must not change until the level is done
+        std::vector<Model*> created(level.size(), nullptr);
+        parallel_for(0, level.size(), [this, &level, &created, &nodes, previewW, previewH](int x) {
+            created[x] = DoCreateModel(nodes[level[x]], previewW, previewH, false);
+        });
+
+        for (int x = 0; x < level.size(); x++) {
+            if (created[x] == nullptr) {
+                wxXmlNode* e = nodes[level[x]];
+                DisplayError(wxString::Format("'%s' is not a valid model type for model '%s'", e->GetAttribute("DisplayAs"), e->GetAttribute("name")).ToStdString());
             } else {
-                newCountValid++;
+                AddModel(created[x]);
+                failed |= !created[x]->CouldComputeStartChannel;
             }
         }
-        if (countValid == newCountValid) {
-            DisplayStartChannelCalcWarning();
+    }
 
-            //nothing improved
-            return;
+    logger_base.debug("Loaded %d models in %d dependency levels in %ldms.", (int)models.size(), (int)levels.size(), sw.Time());
+
+    if (failed) {
+        DisplayStartChannelCalcWarning();
+    }
+}
+
+// returns the names of the models this model's start channels are relative to
+std::list<std::string> ModelManager::GetStartChannelDependencies(wxXmlNode *node) {
+    std::list<std::string> res;
+
+    auto addDependency = [&res](const std::string& sc) {
+        if (sc.size() > 1 && (sc[0] == '@' || sc[0] == '<' || sc[0] == '>')) {
+            size_t colon = sc.find(':');
+            if (colon != std::string::npos) {
+                res.push_back(sc.substr(1, colon - 1));
+            }
+        }
+    };
+
+    addDependency(node->GetAttribute("StartChannel", "1").ToStdString());
+    if (node->GetAttribute("Advanced", "0") == "1") {
+        for (wxXmlAttribute* a = node->GetAttributes(); a != nullptr; a = a->GetNext()) {
+            if (a->GetName().StartsWith("String")) {
+                addDependency(a->GetValue().ToStdString());
+            }
         }
-        countValid = newCountValid;
     }
+
+    return res;
 }
 
 unsigned int ModelManager::GetLastChannel() const {
@@ -688,6 +782,14 @@ Model* ModelManager::CreateDefaultModel(const std::string &type, const std::stri
 }
 
 Model *ModelManager::CreateModel(wxXmlNode *node, int previewW, int previewH, bool zeroBased ) const {
+    Model *model = DoCreateModel(node, previewW, previewH, zeroBased);
+    if (model == nullptr) {
+        DisplayError(wxString::Format("'%s' is not a valid model type for model '%s'", node->GetAttribute("DisplayAs"), node->GetAttribute("name")).ToStdString());
+    }
+    return model;
+}
+
+Model *ModelManager::DoCreateModel(wxXmlNode *node, int previewW, int previewH, bool zeroBased) const {
 
     if (node->GetName() == "modelGroup") {
         ModelGroup *grp = new ModelGroup(node, *this, previewWidth, previewHeight);
@@ -735,7 +837,6 @@ Model *ModelManager::CreateModel(wxXmlNode *node, int previewW, int previewH, bo
     } else if (type == "Spinner") {
         model = new SpinnerModel(node, *this, zeroBased);
     } else {
-        DisplayError(wxString::Format("'%s' is not a valid model type for model '%s'", type, node->GetAttribute("name")).ToStdString());
         return nullptr;
     }
     model->GetModelScreenLocation().previewW = previewW;
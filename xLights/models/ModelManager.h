@@ -1,6 +1,7 @@
 #ifndef MODELMANAGER_H
 #define MODELMANAGER_H
 
+#include <list>
 #include <map>
 #include <string>
 #include <vector>
@@ -57,6 +58,9 @@ class ModelManager : public ObjectManager
         xLightsFrame* GetXLightsFrame() const { return xlights; }
     protected:
         Model *createAndAddModel(wxXmlNode *node, int previewW, int previewH);
+        // same as CreateModel but returns nullptr for unknown model types rather than displaying an error so it is safe to call off the main thread
+        Model *DoCreateModel(wxXmlNode *node, int previewW, int previewH, bool zeroBased) const;
+        static std::list<std::string> GetStartChannelDependencies(wxXmlNode *node);
     private:
 
     wxXmlNode *layoutsNode;
@@ -271,12 +271,33 @@ void ArtNetOutput::StartFrame(long msec)
 
 void ArtNetOutput::EndFrame(int suppressFrames)
 {
-    if (!_enabled || _suspend || _datagram == nullptr) return;
+    if (!_enabled || _suspend || _datagram == nullptr)
+    {
+        _frameData = nullptr;
+        return;
+    }
+
+    if (_frameData != nullptr)
+    {
+        // zero copy ... detect changes by hashing the frame rather than comparing it to a copy. Our own packet
+        // only takes a copy when the frame changes so it stays current for a later partial write
+        uint64_t hash = HashChannels(_frameData, _channels);
+        if (hash != _frameHash)
+        {
+            memcpy(&_data[ARTNET_PACKET_HEADERLEN], _frameData, _channels);
+            _frameHash = hash;
+            _changed = true;
+        }
+    }
 
     if (_changed || NeedToOutput(suppressFrames))
     {
         _data[12] = _sequenceNum;
-        _datagram->SendTo(_remoteAddr, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        // only fall back to a copy when nothing went out or the universe would be sent twice
+        if (_frameData == nullptr || SendGather(_datagram, _remoteAddr, _data, ARTNET_PACKET_HEADERLEN, _frameData, _channels) == 0)
+        {
+            _datagram->SendTo(_remoteAddr, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        }
         _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
         FrameOutput();
         _changed = false;
@@ -285,6 +306,8 @@ void ArtNetOutput::EndFrame(int suppressFrames)
     {
         SkipFrame();
     }
+
+    _frameData = nullptr;
 }
 #pragma endregion Frame Handling
 
@@ -293,9 +316,11 @@ void ArtNetOutput::SetOneChannel(long channel, unsigned char data)
 {
     wxASSERT(channel < _channels);
 
+    _frameData = nullptr;
     if (_data[channel + ARTNET_PACKET_HEADERLEN] != data) {
         _data[channel + ARTNET_PACKET_HEADERLEN] = data;
         _changed = true;
+        _frameHash = 0; // the next zero copy frame has to be sent
     }
 }
 
@@ -309,6 +334,7 @@ void ArtNetOutput::SetManyChannels(long channel, unsigned char data[], long size
     long chs = std::min(size, _channels - channel);
 #endif
 
+    _frameData = nullptr;
     if (memcmp(&_data[channel + ARTNET_PACKET_HEADERLEN], data, chs) == 0)
     {
         // nothing has changed
@@ -317,6 +343,20 @@ void ArtNetOutput::SetManyChannels(long channel, unsigned char data[], long size
     {
         memcpy(&_data[channel + ARTNET_PACKET_HEADERLEN], data, chs);
         _changed = true;
+        _frameHash = 0; // the next zero copy frame has to be sent
+    }
+}
+
+void ArtNetOutput::SetManyChannelsZeroCopy(long channel, unsigned char data[], long size)
+{
+    if (channel == 0 && size >= _channels)
+    {
+        // we send the whole universe so just remember where it is
+        _frameData = data;
+    }
+    else
+    {
+        SetManyChannels(channel, data, size);
     }
 }
 
@@ -324,6 +364,8 @@ void ArtNetOutput::AllOff()
 {
     memset(&_data[ARTNET_PACKET_HEADERLEN], 0x00, _channels);
     _changed = true;
+    _frameHash = 0; // the next zero copy frame has to be sent
+    _frameData = nullptr;
 }
 #pragma endregion Data Setting
 
@@ -75,6 +75,7 @@ public:
     #pragma region Data Setting
     virtual void SetOneChannel(long channel, unsigned char data) override;
     virtual void SetManyChannels(long channel, unsigned char* data, long size) override;
+    virtual void SetManyChannelsZeroCopy(long channel, unsigned char data[], long size) override;
     virtual void AllOff() override;
     #pragma endregion Data Setting
 
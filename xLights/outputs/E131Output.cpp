@@ -429,7 +429,11 @@ void E131Output::StartFrame(long msec)
 
 void E131Output::EndFrame(int suppressFrames)
 {
-    if (!_enabled || _suspend) return;
+    if (!_enabled || _suspend)
+    {
+        _frameData = nullptr;
+        return;
+    }
 
     if (IsOutputCollection())
     {
@@ -440,12 +444,33 @@ void E131Output::EndFrame(int suppressFrames)
     }
     else
     {
-        if (_datagram == nullptr) return;
+        if (_datagram == nullptr)
+        {
+            _frameData = nullptr;
+            return;
+        }
+
+        if (_frameData != nullptr)
+        {
+            // zero copy ... detect changes by hashing the frame rather than comparing it to a copy. Our own packet
+            // only takes a copy when the frame changes so it stays current for a later partial write
+            uint64_t hash = HashChannels(_frameData, _channels);
+            if (hash != _frameHash)
+            {
+                memcpy(&_data[E131_PACKET_HEADERLEN], _frameData, _channels);
+                _frameHash = hash;
+                _changed = true;
+            }
+        }
 
         if (_changed || NeedToOutput(suppressFrames))
         {
             _data[111] = _sequenceNum;
-            _datagram->SendTo(_remoteAddr, _data, E131_PACKET_LEN - (512 - _channels));
+            // only fall back to a copy when nothing went out or the universe would be sent twice
+            if (_frameData == nullptr || SendGather(_datagram, _remoteAddr, _data, E131_PACKET_HEADERLEN, _frameData, _channels) == 0)
+            {
+                _datagram->SendTo(_remoteAddr, _data, E131_PACKET_LEN - (512 - _channels));
+            }
             _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
             FrameOutput();
         }
@@ -453,6 +478,8 @@ void E131Output::EndFrame(int suppressFrames)
         {
             SkipFrame();
         }
+
+        _frameData = nullptr;
     }
 }
 
@@ -491,9 +518,11 @@ void E131Output::SetOneChannel(long channel, unsigned char data)
     }
     else
     {
+        _frameData = nullptr;
         if (_data[channel + E131_PACKET_HEADERLEN] != data) {
             _data[channel + E131_PACKET_HEADERLEN] = data;
             _changed = true;
+            _frameHash = 0; // the next zero copy frame has to be sent
         }
     }
 }
@@ -533,6 +562,7 @@ void E131Output::SetManyChannels(long channel, unsigned char data[], long size)
         long chs = std::min(size, GetMaxChannels() - channel);
 #endif
 
+        _frameData = nullptr;
         if (memcmp(&_data[channel + E131_PACKET_HEADERLEN], data, chs) == 0)
         {
             // nothing changed
@@ -541,8 +571,47 @@ void E131Output::SetManyChannels(long channel, unsigned char data[], long size)
         {
             memcpy(&_data[channel + E131_PACKET_HEADERLEN], data, chs);
             _changed = true;
+            _frameHash = 0; // the next zero copy frame has to be sent
+        }
+    }
+}
+
+void E131Output::SetManyChannelsZeroCopy(long channel, unsigned char data[], long size)
+{
+    if (IsOutputCollection())
+    {
+        long startu = (channel) / _channels;
+        long startc = (channel) % _channels;
+
+        auto o = _outputs.begin();
+        for (long i = 0; i < startu; i++)
+        {
+            ++o;
+        }
+
+        long left = size;
+        while (left > 0 && o != _outputs.end())
+        {
+#ifdef _MSC_VER
+            long send = min(left, _channels);
+#else
+            long send = std::min(left, _channels);
+#endif
+            (*o)->SetManyChannelsZeroCopy(startc, &data[size - left], send);
+            left -= send;
+            ++o;
+            startc = 0;
         }
     }
+    else if (channel == 0 && size >= _channels)
+    {
+        // we send the whole universe so just remember where it is
+        _frameData = data;
+    }
+    else
+    {
+        SetManyChannels(channel, data, size);
+    }
 }
 
 void E131Output::AllOff()
@@ -558,6 +627,8 @@ void E131Output::AllOff()
     {
         memset(&_data[E131_PACKET_HEADERLEN], 0x00, _channels);
         _changed = true;
+        _frameHash = 0; // the next zero copy frame has to be sent
+        _frameData = nullptr;
     }
 }
 #pragma endregion Data Setting
@@ -10,6 +10,9 @@
 #include <winsock2.h>
 #include <iphlpapi.h>
 #include <icmpapi.h>
+#else
+#include <sys/socket.h>
+#include <sys/uio.h>
 #endif
 
 #include <log4cpp/Category.hh>
@@ -67,6 +70,43 @@ std::string IPOutput::CleanupIP(const std::string &ip)
     }
     return IpAddr.ToStdString();
 }
+
+long IPOutput::SendGather(wxDatagramSocket* datagram, const wxIPV4address& remoteAddr, const uint8_t* header, size_t headerLen, const unsigned char* payload, size_t payloadLen)
+{
+    if (datagram == nullptr) return 0;
+
+    const sockaddr* addr = (const sockaddr*)remoteAddr.GetAddressData();
+    int addrLen = remoteAddr.GetAddressDataLen();
+    if (addr == nullptr || addrLen <= 0) return 0;
+
+#ifdef __WXMSW__
+    WSABUF buffers[2];
+    buffers[0].buf = (CHAR*)header;
+    buffers[0].len = (ULONG)headerLen;
+    buffers[1].buf = (CHAR*)payload;
+    buffers[1].len = (ULONG)payloadLen;
+
+    DWORD sent = 0;
+    if (WSASendTo(datagram->GetSocket(), buffers, 2, &sent, 0, addr, addrLen, nullptr, nullptr) != 0) return 0;
+    return (long)sent;
+#else
+    struct iovec iov[2];
+    iov[0].iov_base = (void*)header;
+    iov[0].iov_len = headerLen;
+    iov[1].iov_base = (void*)payload;
+    iov[1].iov_len = payloadLen;
+
+    struct msghdr msg;
+    memset(&msg, 0x00, sizeof(msg));
+    msg.msg_name = (void*)addr;
+    msg.msg_namelen = addrLen;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    ssize_t sent = sendmsg(datagram->GetSocket(), &msg, 0);
+    return sent < 0 ? 0 : (long)sent;
+#endif
+}
 #pragma endregion Static Functions
 
 wxXmlNode* IPOutput::Save()
@@ -3,6 +3,9 @@
 
 #include "Output.h"
 
+class wxDatagramSocket;
+class wxIPV4address;
+
 class IPOutput : public Output
 {
 protected:
@@ -27,6 +30,9 @@ public:
     static std::string CleanupIP(const std::string &ip);
     static void SetLocalIP(const std::string& localIP) { __localIP = localIP; }
     static std::string GetLocalIP() { return __localIP; }
+    // sends header and payload as one datagram without first assembling them into one buffer
+    // returns the number of bytes sent, 0 if the platform could not do this in which case nothing was sent
+    static long SendGather(wxDatagramSocket* datagram, const wxIPV4address& remoteAddr, const uint8_t* header, size_t headerLen, const unsigned char* payload, size_t payloadLen);
     #pragma endregion Static Functions
 
     #pragma region Getters and Setters
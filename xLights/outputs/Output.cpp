@@ -23,6 +23,8 @@ Output::Output(Output* output)
 {
     _suspend = false;
     _changed = false;
+    _frameData = nullptr;
+    _frameHash = 0;
     _timer_msec = 0;
     _outputNumber = -1;
     _nullNumber = -1;
@@ -46,6 +48,8 @@ Output::Output(wxXmlNode* node)
 {
     _suspend = false;
     _changed = false;
+    _frameData = nullptr;
+    _frameHash = 0;
     _autoSize = false;
     _timer_msec = 0;
     _outputNumber = -1;
@@ -72,6 +76,8 @@ Output::Output()
 {
     _suspend = false;
     _changed = false;
+    _frameData = nullptr;
+    _frameHash = 0;
     _autoSize = false;
     _timer_msec = 0;
     _outputNumber = -1;
@@ -188,6 +194,29 @@ Output* Output::Create(wxXmlNode* node)
     wxASSERT(false);
     return nullptr;
 }
+
+// fast non cryptographic hash used to detect changes in channel data without keeping a copy of it
+uint64_t Output::HashChannels(const unsigned char* data, long size)
+{
+    uint64_t h = 0xcbf29ce484222325ULL ^ (uint64_t)size;
+
+    long i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t v;
+        memcpy(&v, &data[i], sizeof(v));
+        h ^= v;
+        h *= 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++)
+    {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+
+    return h;
+}
 #pragma endregion Static Functions
 
 #pragma region Getters and Setters
@@ -234,6 +263,8 @@ bool Output::operator==(const Output& output) const
 bool Output::Open()
 {
     _changed = false;
+    _frameData = nullptr;
+    _frameHash = 0;
     _skippedFrames = 9999;
     _lastOutputTime = 0;
 
@@ -4,6 +4,8 @@
 #include <wx/window.h>
 #include <wx/time.h>
 
+#include <cstdint>
+
 class ModelManager;
 class OutputManager;
 class wxXmlNode;
@@ -60,6 +62,8 @@ protected:
     int _skippedFrames;
     bool _changed; // set to true when something in the packed has changed
     bool _autoSize;
+    unsigned char* _frameData; // zero copy mode ... points into the callers frame buffer and is only valid until EndFrame
+    uint64_t _frameHash; // hash of the channel data last seen in zero copy mode, reset whenever our own packet is written
     #pragma endregion Member Variables
 
     virtual void Save(wxXmlNode* node);
@@ -76,6 +80,7 @@ public:
     #pragma region Static Functions
     static Output* Create(wxXmlNode* node);
     static std::list<Output*> Discover() { return std::list<Output*>(); } // Discovers controllers supporting this protocol
+    static uint64_t HashChannels(const unsigned char* data, long size);
     #pragma endregion Static Functions
 
     #pragma region Getters and Setters
@@ -154,6 +159,8 @@ public:
     #pragma region Data Setting
     virtual void SetOneChannel(long channel, unsigned char data) = 0;
     virtual void SetManyChannels(long channel, unsigned char data[], long size);
+    // data must remain valid until EndFrame ... outputs which cannot send straight from it just copy it
+    virtual void SetManyChannelsZeroCopy(long channel, unsigned char data[], long size) { SetManyChannels(channel, data, size); }
     virtual void AllOff() = 0;
     #pragma endregion Data Setting
 
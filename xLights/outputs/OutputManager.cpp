@@ -1,5 +1,7 @@
 #include "OutputManager.h"
 
+#include <algorithm>
+
 #include <wx/xml/xml.h>
 #include <wx/msgdlg.h>
 #include <wx/config.h>
@@ -188,6 +190,11 @@ bool OutputManager::Discover()
         }
     }
 
+    if (found)
+    {
+        SomethingChanged();
+    }
+
     return found;
 }
 #pragma endregion Controller Discovery
@@ -196,14 +203,12 @@ bool OutputManager::Discover()
 // get an output based on an output number - zero based
 Output* OutputManager::GetOutput(int outputNumber) const
 {
-    if (outputNumber >= (int)_outputs.size() || outputNumber < 0)
+    if (outputNumber >= (int)_outputIndex.size() || outputNumber < 0)
     {
         return nullptr;
     }
 
-    auto iter = _outputs.begin();
-    std::advance(iter, outputNumber);
-    return *iter;
+    return _outputIndex[outputNumber];
 }
 
 void OutputManager::SetShowDir(const std::string& showDir)
@@ -223,47 +228,23 @@ void OutputManager::SuspendAll(bool suspend)
 // get an output based on an absolute channel number
 Output* OutputManager::GetOutput(long absoluteChannel, long& startChannel) const
 {
-    for (auto it : _outputs)
-    {
-        if (it->IsOutputCollection() && absoluteChannel >= it->GetStartChannel() && absoluteChannel <= it->GetEndChannel())
-        {
-            auto outputs = it->GetOutputs();
-
-            for (auto it2 : outputs)
-            {
-                if (absoluteChannel >= it2->GetStartChannel() && absoluteChannel <= it2->GetEndChannel())
-                {
-                    startChannel = absoluteChannel - it2->GetStartChannel() + 1;
-                    return it2;
-                }
-            }
-        }
-        else
-        {
-            if (absoluteChannel >= it->GetStartChannel() && absoluteChannel <= it->GetEndChannel())
-            {
-                startChannel = absoluteChannel - it->GetStartChannel() + 1;
-                return it;
-            }
-        }
-    }
+    int i = FindOutputIndex(_leafOutputIndex, absoluteChannel);
+    if (i < 0) return nullptr;
 
-    return nullptr;
+    Output* o = _leafOutputIndex[i];
+    startChannel = absoluteChannel - o->GetStartChannel() + 1;
+    return o;
 }
 
 // get an output based on an absolute channel number
 Output* OutputManager::GetLevel1Output(long absoluteChannel, long& startChannel) const
 {
-    for (auto it : _outputs)
-    {
-        if (absoluteChannel >= it->GetStartChannel() && absoluteChannel <= it->GetEndChannel())
-        {
-            startChannel = absoluteChannel - it->GetStartChannel() + 1;
-            return it;
-        }
-    }
+    int i = FindOutputIndex(_outputIndex, absoluteChannel);
+    if (i < 0) return nullptr;
 
-    return nullptr;
+    Output* o = _outputIndex[i];
+    startChannel = absoluteChannel - o->GetStartChannel() + 1;
+    return o;
 }
 
 // get an output based on a universe number
@@ -333,15 +314,9 @@ std::string OutputManager::GetChannelName(long channel)
 
 long OutputManager::GetAbsoluteChannel(int outputNumber, int startChannel) const
 {
-    if (outputNumber >= (int)_outputs.size()) return -1;
+    if (outputNumber >= (int)_outputIndex.size()) return -1;
 
-    auto it = _outputs.begin();
-    for (int i = 0; i < outputNumber; i++)
-    {
-        ++it;
-    }
-
-    return (*it)->GetStartChannel() + startChannel;
+    return _outputIndex[outputNumber]->GetStartChannel() + startChannel;
 }
 
 long OutputManager::GetAbsoluteChannel(const std::string& ip, int universe, int startChannel) const
@@ -525,6 +500,52 @@ void OutputManager::SomethingChanged() const
 
         start += it->GetChannels() * it->GetUniverses();
     }
+
+    RebuildChannelIndex();
+}
+
+// Flattens the output list into vectors sorted by start channel so channel lookups can binary search
+// rather than walking the list. Start channels are allocated cumulatively in SomethingChanged so
+// output number order is also start channel order.
+void OutputManager::RebuildChannelIndex() const
+{
+    _outputIndex.clear();
+    _outputIndex.reserve(_outputs.size());
+    _leafOutputIndex.clear();
+    _leafOutputIndex.reserve(_outputs.size());
+
+    for (auto it : _outputs)
+    {
+        _outputIndex.push_back(it);
+
+        if (it->IsOutputCollection())
+        {
+            auto outputs = it->GetOutputs();
+            for (auto it2 : outputs)
+            {
+                _leafOutputIndex.push_back(it2);
+            }
+        }
+        else
+        {
+            _leafOutputIndex.push_back(it);
+        }
+    }
+}
+
+// returns the position in the index of the output containing the channel or -1 if none does
+int OutputManager::FindOutputIndex(const std::vector<Output*>& index, long absoluteChannel)
+{
+    // find the first output which starts after the channel ... the one before it is the only candidate
+    auto it = std::upper_bound(index.begin(), index.end(), absoluteChannel,
+        [](long ch, const Output* o) { return ch < o->GetStartChannel(); });
+
+    if (it == index.begin()) return -1;
+    --it;
+
+    if (absoluteChannel > (*it)->GetEndChannel()) return -1;
+
+    return it - index.begin();
 }
 
 void OutputManager::SetForceFromIP(const std::string& forceFromIP)
@@ -789,6 +810,8 @@ void OutputManager::Replace(Output* replacethis, Output* withthis)
         }
     }
     _outputs = newoutputs;
+
+    SomethingChanged();
 }
 #pragma endregion Output Management
 
@@ -960,30 +983,53 @@ void OutputManager::SetOneChannel(long channel, unsigned char data)
 }
 
 // channel here is zero based
-void OutputManager::SetManyChannels(long channel, unsigned char* data, long size)
+// walks the outputs covering the channels handing each its part of data
+void OutputManager::DoSetManyChannels(long channel, unsigned char* data, long size, bool zeroCopy)
 {
     if (size == 0) return;
 
-    long stch;
-    Output* o = GetLevel1Output(channel + 1, stch);
+    int i = FindOutputIndex(_outputIndex, channel + 1);
 
     // if this doesnt map to an output then skip it
-    if (o == nullptr) return;
+    if (i < 0) return;
 
+    long stch = channel + 1 - _outputIndex[i]->GetStartChannel() + 1;
     long left = size;
 
-    while (left > 0 && o != nullptr)
+    // outputs are contiguous so just walk forward through the index
+    for (; left > 0 && i < (int)_outputIndex.size(); ++i)
     {
+        Output* o = _outputIndex[i];
         long send = std::min(left, (o->GetChannels() * o->GetUniverses()) - stch + 1);
         if (o->IsEnabled())
         {
-            o->SetManyChannels(stch - 1, &data[size - left], send);
+            if (zeroCopy)
+            {
+                o->SetManyChannelsZeroCopy(stch - 1, &data[size - left], send);
+            }
+            else
+            {
+                o->SetManyChannels(stch - 1, &data[size - left], send);
+            }
         }
         stch = 1;
         left -= send;
-        o = GetOutput(o->GetOutputNumber()); // get the next output
     }
 }
+
+// channel here is zero based
+void OutputManager::SetManyChannels(long channel, unsigned char* data, long size)
+{
+    DoSetManyChannels(channel, data, size, false);
+}
+
+// channel here is zero based
+// Outputs which support it send straight out of data rather than copying it into their own packets
+// so data must remain valid and unchanged until EndFrame is called
+void OutputManager::SetManyChannelsZeroCopy(long channel, unsigned char* data, long size)
+{
+    DoSetManyChannels(channel, data, size, true);
+}
 #pragma endregion Data Setting
 
 #pragma region Sync
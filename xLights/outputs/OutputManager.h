@@ -3,6 +3,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 #include <wx/thread.h>
 
 class Output;
@@ -24,6 +25,10 @@ class OutputManager
     bool _parallelTransmission;
     bool _outputting; // true if we are currently sending out data
     wxCriticalSection _outputCriticalSection; // used to protect areas that must be single threaded
+
+    // channel lookup index ... rebuilt in SomethingChanged whenever the outputs or their channels change
+    mutable std::vector<Output*> _outputIndex; // level 1 outputs in output number order ... sorted by start channel
+    mutable std::vector<Output*> _leafOutputIndex; // outputs with collections expanded ... sorted by start channel
     #pragma endregion Member Variables
 
     static int _lastSecond;
@@ -34,6 +39,9 @@ class OutputManager
     static bool _isInteractive;
 
     bool SetGlobalOutputtingFlag(bool state, bool force = false);
+    void RebuildChannelIndex() const;
+    static int FindOutputIndex(const std::vector<Output*>& index, long absoluteChannel);
+    void DoSetManyChannels(long channel, unsigned char* data, long size, bool zeroCopy);
 
 public:
 
@@ -124,6 +132,7 @@ public:
     #pragma region Data Setting
     void SetOneChannel(long channel, unsigned char data);
     void SetManyChannels(long channel, unsigned char* data, long size);
+    void SetManyChannelsZeroCopy(long channel, unsigned char* data, long size); // data must not change or be freed until EndFrame
     void AllOff(bool send = true);
     #pragma endregion Data Setting
 
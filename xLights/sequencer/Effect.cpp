@@ -14,6 +14,7 @@
 #include "../effects/RenderableEffect.h"
 
 #include <unordered_map>
+#include <mutex>
 
 #include <log4cpp/Category.hh>
 
@@ -77,6 +78,151 @@ private:
 
 const std::string MapStringString::EMPTY_STRING;
 
+#pragma region Settings Intern Pool
+
+// Settings strings are heavily duplicated across a sequence so parsed maps are shared.
+// The pool only holds weak references ... a map goes away with the last effect using it.
+class SettingsInternPool
+{
+public:
+    std::shared_ptr<MapStringString::Map> Find(const std::string& str)
+    {
+        auto it = _maps.find(str);
+        if (it == _maps.end()) return nullptr;
+        return it->second.lock();
+    }
+
+    void Add(const std::string& str, const std::shared_ptr<MapStringString::Map>& map)
+    {
+        _maps[str] = map;
+        if (_maps.size() >= _pruneAt)
+        {
+            for (auto it = _maps.begin(); it != _maps.end(); )
+            {
+                if (it->second.expired())
+                {
+                    it = _maps.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            _pruneAt = std::max((size_t)1024, _maps.size() * 2);
+        }
+    }
+
+    void AddStats(size_t& unique, size_t& references, size_t& bytes) const
+    {
+        for (const auto& it : _maps)
+        {
+            auto map = it.second.lock();
+            if (map == nullptr) continue;
+            unique++;
+            references += map.use_count() - 1;
+            bytes += it.first.capacity();
+            for (const auto& kv : *map)
+            {
+                // approximate node overhead of a red black tree entry
+                bytes += kv.first.capacity() + kv.second.capacity() + sizeof(kv) + 4 * sizeof(void*);
+            }
+        }
+    }
+
+private:
+    std::unordered_map<std::string, std::weak_ptr<MapStringString::Map>> _maps;
+    size_t _pruneAt = 1024;
+};
+
+static std::mutex internPoolLock;
+static SettingsInternPool internPools[2];
+
+const std::shared_ptr<MapStringString::Map>& MapStringString::EmptyMap()
+{
+    static const std::shared_ptr<Map> empty = std::make_shared<Map>();
+    return empty;
+}
+
+void MapStringString::Parse(const std::string& str)
+{
+    if (str.empty())
+    {
+        clear();
+        return;
+    }
+
+    SettingsInternPool& pool = internPools[RemapsKeys() ? 1 : 0];
+    {
+        std::unique_lock<std::mutex> lock(internPoolLock);
+        auto map = pool.Find(str);
+        if (map != nullptr)
+        {
+            _data = map;
+            _shared = true;
+            return;
+        }
+    }
+
+    // parse outside the lock, if another thread beat us to it just use theirs
+    auto map = std::make_shared<Map>();
+    ParseInto(*map, str);
+
+    std::unique_lock<std::mutex> lock(internPoolLock);
+    auto existing = pool.Find(str);
+    if (existing != nullptr)
+    {
+        _data = existing;
+    }
+    else
+    {
+        pool.Add(str, map);
+        _data = map;
+    }
+    _shared = true;
+}
+
+void MapStringString::ParseInto(Map& map, const std::string& str)
+{
+    std::string before, after, name, value;
+    std::string settings(str);
+    while (!settings.empty()) {
+        size_t start_pos = settings.find(',');
+        if (start_pos != std::string::npos) {
+            before = settings.substr(0, start_pos);
+            settings = settings.substr(start_pos + 1);
+        }
+        else {
+            before = settings;
+            settings = "";
+        }
+
+        start_pos = before.find('=');
+        name = before.substr(0, start_pos);
+        value = before.substr(start_pos + 1);
+        ReplaceAll(value, "&comma;", ","); //unescape the commas
+        ReplaceAll(value, "&amp;", "&"); //unescape the amps
+
+        RemapKey(name, value);
+        if (!name.empty()) {
+            map[name] = value;
+        }
+    }
+}
+
+void MapStringString::GetInternStats(size_t& unique, size_t& references, size_t& bytes)
+{
+    unique = 0;
+    references = 0;
+    bytes = 0;
+    std::unique_lock<std::mutex> lock(internPoolLock);
+    for (const auto& pool : internPools)
+    {
+        pool.AddStats(unique, references, bytes);
+    }
+}
+
+#pragma endregion
+
 void SettingsMap::RemapChangedSettingKey(std::string &n,  std::string &value)
 {
     Remaps.map(n);
@@ -191,7 +337,7 @@ Effect::Effect(EffectLayer* parent,int id, const std::string & name, const std::
     }
 
     // check for any other odd looking blank settings
-    for (auto it = mSettings.begin(); it != mSettings.end(); ++it)
+    for (auto it = mSettings.cbegin(); it != mSettings.cend(); ++it)
     {
         if (it->second == "")
         {
@@ -406,7 +552,7 @@ void Effect::SetSettings(const std::string &settings, bool keepxsettings)
     SettingsMap x;
     if (keepxsettings)
     {
-        for (auto it = mSettings.begin(); it != mSettings.end(); ++it)
+        for (auto it = mSettings.cbegin(); it != mSettings.cend(); ++it)
         {
             if (it->first.size() > 2 && it->first[0] == 'X' && it->first[1] == '_')
             {
@@ -512,6 +658,14 @@ void Effect::CopySettingsMap(SettingsMap &target, bool stripPfx) const
     }
 }
 
+// Shares the underlying maps ... no strings are copied until one side is modified
+void Effect::CopySettings(SettingsMap &settings, SettingsMap &palette) const
+{
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    settings = mSettings;
+    palette = mPaletteMap;
+}
+
 // When an effect is copied between model types the buffer may not be supported so make it valid
 void Effect::FixBuffer(const Model* m)
 {
@@ -565,7 +719,7 @@ void Effect::SetColourOnlyPalette(const std::string& i)
     mPaletteMap.Parse(i);
 
     // copy over all the non colour entries
-    for (auto it = oldPalette.begin(); it != oldPalette.end(); ++it)
+    for (auto it = oldPalette.cbegin(); it != oldPalette.cend(); ++it)
     {
         wxString key(it->first);
         if (!key.StartsWith("C_BUTTON_Palette") && !key.StartsWith("C_CHECKBOX_Palette"))
@@ -101,6 +101,7 @@ public:
     void PressButton(RenderableEffect* re, const std::string& id);
     const SettingsMap &GetSettings() const { return mSettings; }
     void CopySettingsMap(SettingsMap &target, bool stripPfx = false) const;
+    void CopySettings(SettingsMap &settings, SettingsMap &palette) const;
     void FixBuffer(const Model* m);
 
     const xlColorVector &GetPalette() const { return mColors; }
@@ -315,6 +315,14 @@ Effect* EffectLayer::GetEffectAfterTime(int ms)
     }
 }
 
+// effects in a layer never overlap so end times are sorted just like start times
+int EffectLayer::GetFirstEffectIndexEndingAfter(int timeMS) const
+{
+    auto it = std::lower_bound(mEffects.begin(), mEffects.end(), timeMS,
+        [](const Effect* e, int ms) { return e->GetEndTimeMS() < ms; });
+    return it - mEffects.begin();
+}
+
 Effect* EffectLayer::GetEffectAtTime(int timeMS)
 {
     for (int i = 0; i < mEffects.size(); i++) {
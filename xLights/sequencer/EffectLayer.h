@@ -58,6 +58,7 @@ class EffectLayer
         bool HitTestEffectBetweenTime(int t1MS, int t2MS);
 
         Effect* GetEffectAtTime(int ms);
+        int GetFirstEffectIndexEndingAfter(int ms) const;
         Effect* GetEffectBeforeTime(int ms);
         Effect* GetEffectAfterTime(int ms);
         Effect* GetEffectBeforeEmptyTime(int ms);
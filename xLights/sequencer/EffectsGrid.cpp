@@ -406,6 +406,24 @@ void EffectsGrid::sendRenderEvent(const std::string &model, int start, int end,
     wxPostEvent(mParent, event);
 }
 
+// one render per dirty interval so edits far apart don't render everything between them, intervals
+// overlapping start-end (when given) are folded into that render
+void EffectsGrid::sendRenderDirtyEvents(const std::string &model, std::list<std::pair<int, int>> &ranges, int start, int end) {
+    ranges.sort();
+    ranges.unique();
+    for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+        if (end != -1 && it->second >= start && it->first <= end) {
+            start = std::min(start, it->first);
+            end = std::max(end, it->second);
+        } else {
+            sendRenderEvent(model, it->first, it->second);
+        }
+    }
+    if (end != -1) {
+        sendRenderEvent(model, start, end);
+    }
+}
+
 void EffectsGrid::OnGridPopup(wxCommandEvent& event)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -2997,31 +3015,22 @@ void EffectsGrid::mouseReleased(wxMouseEvent& event)
             logger_base.debug("EffectsGrid::mouseReleased model effect released.");
             if (MultipleEffectsSelected()) {
                 std::string lastModel;
-                int startMS = 99999999;
-                int endMS = -1;
+                std::list<std::pair<int, int>> dirty;
                 for(int row=0;row<mSequenceElements->GetRowInformationSize();row++)
                 {
                     EffectLayer* el = mSequenceElements->GetEffectLayer(row);
                     if (el->GetParentElement()->GetModelName() != lastModel) {
-                        if (endMS != -1) {
-                            sendRenderEvent(lastModel, startMS, endMS);
-                        }
-                        startMS = 99999999;
-                        endMS = -1;
+                        sendRenderDirtyEvents(lastModel, dirty);
+                        dirty.clear();
                         lastModel = el->GetParentElement()->GetModelName();
                     }
                     if (el->GetSelectedEffectCount() > 0) {
-                        int startDirty, endDirty;
-                        el->GetParentElement()->GetDirtyRange(startDirty, endDirty);
-                        if (startDirty != -1) {
-                            adjustMS(startDirty, startMS, endMS);
-                            adjustMS(endDirty, startMS, endMS);
-                        }
+                        std::list<std::pair<int, int>> ranges;
+                        el->GetParentElement()->GetDirtyRanges(ranges);
+                        dirty.splice(dirty.end(), ranges);
                     }
                 }
-                if (endMS != -1) {
-                    sendRenderEvent(lastModel, startMS, endMS);
-                }
+                sendRenderDirtyEvents(lastModel, dirty);
             } else {
                 int stime = mStartResizeTimeMS;
                 int timeMS = mTimeline->GetAbsoluteTimeMSfromPosition(event.GetX());
@@ -3045,13 +3054,9 @@ void EffectsGrid::mouseReleased(wxMouseEvent& event)
                         adjustMS(mEffectLayer->GetEffect(mResizeEffectIndex + 1)->GetStartTimeMS(), min, max);
                         adjustMS(mEffectLayer->GetEffect(mResizeEffectIndex + 1)->GetEndTimeMS(), min, max);
                     }
-                    int startDirty, endDirty;
-                    mEffectLayer->GetParentElement()->GetDirtyRange(startDirty, endDirty);
-                    if (startDirty != -1) {
-                        adjustMS(startDirty, min, max);
-                        adjustMS(endDirty, min, max);
-                    }
-                    sendRenderEvent(mEffectLayer->GetParentElement()->GetModelName(), min, max);
+                    std::list<std::pair<int, int>> dirty;
+                    mEffectLayer->GetParentElement()->GetDirtyRanges(dirty);
+                    sendRenderDirtyEvents(mEffectLayer->GetParentElement()->GetModelName(), dirty, min, max);
                     RaisePlayModelEffect(mEffectLayer->GetParentElement(), effect, false);
                 }
             }
@@ -5777,6 +5782,128 @@ float ComputeFontSize(int &toffset, const float factor) {
     return fontSize;
 }
 
+#pragma region Node Colour Summaries
+void EffectsGrid::NodeValuesChanged(int startFrame, int endFrame)
+{
+    for (auto& it : mNodeColourSummaries) {
+        NodeColourSummary& summary = it.second;
+        if (summary.dirtyEnd < summary.dirtyStart) {
+            summary.dirtyStart = startFrame;
+            summary.dirtyEnd = endFrame;
+        } else {
+            summary.dirtyStart = std::min(summary.dirtyStart, startFrame);
+            summary.dirtyEnd = std::max(summary.dirtyEnd, endFrame);
+        }
+    }
+}
+
+const EffectsGrid::NodeColourSummary& EffectsGrid::GetNodeColourSummary(Model* m, int strand, int node)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (seqData->Generation() != mNodeColourSummaryGeneration) {
+        mNodeColourSummaries.clear();
+        mNodeColourSummaryGeneration = seqData->Generation();
+    }
+
+    NodeColourSummary& summary = mNodeColourSummaries[std::make_tuple(m->GetName(), strand, node)];
+
+    int numFrames = seqData->NumFrames();
+    int ds = std::max(0, summary.dirtyStart);
+    int de = std::min(numFrames - 1, summary.dirtyEnd);
+    summary.dirtyStart = 0;
+    summary.dirtyEnd = -1;
+    if (ds > de) {
+        return summary;
+    }
+
+    wxStopWatch sw;
+    PixelBufferClass ncls(xlights);
+    ncls.InitNodeBuffer(*m, strand, node, seqData->FrameTime());
+    xlColor maskColor = m->GetNodeMaskColor(strand);
+
+    std::vector<int> startFrames;
+    std::vector<xlColor> colors;
+    auto addRun = [&startFrames, &colors](int frame, const xlColor& c) {
+        if (colors.empty() || colors.back() != c) {
+            startFrames.push_back(frame);
+            colors.push_back(c);
+        }
+    };
+
+    // the runs after the rescanned frames are unchanged but the one straddling the end needs restarting
+    bool hasAfter = de + 1 < numFrames && !summary.startFrames.empty();
+    xlColor after;
+    if (hasAfter) {
+        auto it = std::upper_bound(summary.startFrames.begin(), summary.startFrames.end(), de + 1);
+        after = summary.colors[it - summary.startFrames.begin() - 1];
+    }
+
+    for (size_t i = 0; i < summary.startFrames.size() && summary.startFrames[i] < ds; i++) {
+        addRun(summary.startFrames[i], summary.colors[i]);
+    }
+    for (int f = ds; f <= de; f++) {
+        ncls.SetNodeChannelValues(0, (*seqData)[f][ncls.NodeStartChannel(0)]);
+        xlColor c = ncls.GetNodeColor(0);
+        c.ApplyMask(&maskColor);
+        addRun(f, c);
+    }
+    if (hasAfter) {
+        addRun(de + 1, after);
+        for (size_t i = 0; i < summary.startFrames.size(); i++) {
+            if (summary.startFrames[i] > de + 1) {
+                addRun(summary.startFrames[i], summary.colors[i]);
+            }
+        }
+    }
+
+    summary.startFrames.swap(startFrames);
+    summary.colors.swap(colors);
+
+    if (sw.Time() > 50) {
+        logger_base.debug("Node colour summary for %s strand %d node %d frames %d-%d took %ldms, %d runs.",
+            (const char*)m->GetName().c_str(), strand, node, ds, de, sw.Time(), (int)summary.colors.size());
+    }
+    return summary;
+}
+
+void EffectsGrid::DrawNodeValues(int row, Model* m, int strand, int node, int width)
+{
+    if (m == nullptr || seqData->NumFrames() == 0) {
+        return;
+    }
+
+    const NodeColourSummary& summary = GetNodeColourSummary(m, strand, node);
+    if (summary.colors.empty()) {
+        return;
+    }
+
+    int frameTime = seqData->FrameTime();
+    int numFrames = seqData->NumFrames();
+
+    // start from the run that is on screen at the left edge
+    int firstFrame = mTimeline->GetTimeMSfromPosition(mTimeline->GetStartPixelOffset()) / frameTime;
+    size_t n = std::upper_bound(summary.startFrames.begin(), summary.startFrames.end(), firstFrame) - summary.startFrames.begin();
+    if (n > 0) n--;
+
+    float y1a = (row*DEFAULT_ROW_HEADING_HEIGHT)+3;
+    float y2a = ((row+1)*DEFAULT_ROW_HEADING_HEIGHT)-3;
+    float x = mTimeline->GetPositionFromTimeMS(summary.startFrames[n] * frameTime);
+    backgrounds.PreAlloc((summary.colors.size() - n) * 6);
+    for (; n < summary.colors.size(); n++) {
+        int endFrame = n + 1 < summary.startFrames.size() ? summary.startFrames[n + 1] : numFrames;
+        int x2 = mTimeline->GetPositionFromTimeMS(endFrame * frameTime);
+        if (x2 >= 0) {
+            backgrounds.AddRect(x, y1a, x2, y2a, summary.colors[n]);
+        }
+        x = x2;
+        if (x > width) {
+            break;
+        }
+    }
+}
+#pragma endregion Node Colour Summaries
+
 void EffectsGrid::DrawEffects()
 {
     int width = getWidth();
@@ -5806,55 +5933,16 @@ void EffectsGrid::DrawEffects()
             int y = (row*DEFAULT_ROW_HEADING_HEIGHT) + (DEFAULT_ROW_HEADING_HEIGHT/2);
 
             if (mGridNodeValues && ri->nodeIndex != -1) {
-                std::vector<xlColor> colors;
-                std::vector<double> xs;
-                PixelBufferClass ncls(xlights);
                 StrandElement *se = dynamic_cast<StrandElement*>(ri->element);
                 Model* m = xlights->GetModel(ri->element->GetModelName());
-                ncls.InitNodeBuffer(*m, se->GetStrand(), ri->nodeIndex, seqData->FrameTime());
-                xlColor maskColor = m->GetNodeMaskColor(se->GetStrand());
-                xlColor lastColor;
-                for (size_t f = 0; f < seqData->NumFrames(); f++) {
-                    ncls.SetNodeChannelValues(0, (*seqData)[f][ncls.NodeStartChannel(0)]);
-                    xlColor c = ncls.GetNodeColor(0);
-                    c.ApplyMask(&maskColor);
-                    if (f == 0) {
-                        colors.push_back(c);
-                        lastColor = c;
-                    } else if (c != lastColor) {
-                        colors.push_back(c);
-                        lastColor = c;
-                        int timems = f * seqData->FrameTime();
-                        xs.push_back(mTimeline->GetPositionFromTimeMS(timems));
-                    }
-                }
-                int timems = seqData->NumFrames() * seqData->FrameTime();
-                xs.push_back(mTimeline->GetPositionFromTimeMS(timems));
-
-                backgrounds.PreAlloc(xs.size() * 6);
-                float y1a = (row*DEFAULT_ROW_HEADING_HEIGHT)+3;
-                float y2a = ((row+1)*DEFAULT_ROW_HEADING_HEIGHT)-3;
-                float x =  mTimeline->GetPositionFromTimeMS(0);
-                for (size_t n = 0; n < xs.size(); n++) {
-                    int x2 = xs[n];
-                    if (x2 >= 0) {
-                        if (colors.size() < n)
-                        {
-                            // that wont work
-                        }
-                        else
-                        {
-                            backgrounds.AddRect(x, y1a, x2, y2a, colors[n]);
-                        }
-                    }
-                    x = x2;
-                    if (x > width) {
-                        break;
-                    }
-                }
+                DrawNodeValues(row, m, se->GetStrand(), ri->nodeIndex, width);
             }
 
-            for(int effectIndex=0;effectIndex < effectLayer->GetEffectCount();effectIndex++)
+            // skip straight to the first effect that can be on screen
+            int firstEffect = effectLayer->GetFirstEffectIndexEndingAfter(mTimeline->GetTimeMSfromPosition(mTimeline->GetStartPixelOffset()));
+            if (firstEffect > 0) firstEffect--;
+
+            for(int effectIndex=firstEffect;effectIndex < effectLayer->GetEffectCount();effectIndex++)
             {
                 Effect* e = effectLayer->GetEffect(effectIndex);
                 EFFECT_SCREEN_MODE mode;
@@ -19,6 +19,8 @@
 #include "RowHeading.h"
 
 #include <map>
+#include <tuple>
+#include <climits>
 
 #define MINIMUM_EFFECT_WIDTH_FOR_SMALL_RECT 4
 
@@ -58,6 +60,7 @@ struct EffectDropData;
 
 class MainSequencer;
 class PixelBufferClass;
+class Model;
 class SequenceData;
 
 class EffectsGrid : public xlGLCanvas
@@ -124,13 +127,17 @@ public:
     void SetRenderDataSources(xLightsFrame *xl, const SequenceData *data) {
         seqData = data;
         xlights = xl;
+        mNodeColourSummaries.clear();
     }
+    void NodeValuesChanged(int startFrame, int endFrame);
+    void ClearNodeColourSummaries() { mNodeColourSummaries.clear(); }
 
     void ClearSelection();
 
     static EffectLayer* FindOpenLayer(Element* elem, int startTimeMS, int endTimeMS);
 
     void sendRenderEvent(const std::string &model, int start, int end, bool clear = true);
+    void sendRenderDirtyEvents(const std::string &model, std::list<std::pair<int, int>> &ranges, int start = -1, int end = -1);
     void sendRenderDirtyEvent();
     void UnselectEffect(bool force = false);
 protected:
@@ -212,6 +219,20 @@ private:
     void DuplicateAndTruncateEffect(EffectLayer* el, SettingsMap settings, std::string palette, std::string name, int originalStartMS, int originalEndMS, int startMS, int endMS, int offsetMS = 0);
     void TruncateBrightnessValueCurve(ValueCurve& vc, double startPos, double endPos, int startMS, int endMS, int originalLength);
 
+    // run length encoded colours of a node across the whole sequence ... only the frames re-rendered since
+    // the last paint are rescanned
+    struct NodeColourSummary
+    {
+        std::vector<int> startFrames; // first frame of each run
+        std::vector<xlColor> colors;
+        int dirtyStart = 0;
+        int dirtyEnd = INT_MAX;
+    };
+    std::map<std::tuple<std::string, int, int>, NodeColourSummary> mNodeColourSummaries;
+    unsigned int mNodeColourSummaryGeneration = 0;
+    const NodeColourSummary& GetNodeColourSummary(Model* m, int strand, int node);
+    void DrawNodeValues(int row, Model* m, int strand, int node, int width);
+
     SequenceElements* mSequenceElements;
     bool mIsDrawing = false;
     bool mGridIconBackgrounds;
@@ -1,6 +1,7 @@
 #include "Element.h"
 #include "../models/Model.h"
 #include <list>
+#include <algorithm>
 #include "UtilFunctions.h"
 #include <log4cpp/Category.hh>
 #include "SequenceElements.h"
@@ -201,6 +202,88 @@ void Element::IncrementChangeCount(int sms, int ems)
     listener->IncrementChangeCount(this);
 }
 
+void Element::SetDirtyRange(int start, int end)
+{
+    if (end < 0) {
+        // not a timed change
+        return;
+    }
+    if (start < 0) {
+        start = 0;
+    }
+    std::unique_lock<std::mutex> locker(dirtyLock);
+    auto it = dirtyRanges.begin();
+    while (it != dirtyRanges.end() && it->second < start) {
+        ++it;
+    }
+    // absorb every interval this one overlaps or touches
+    while (it != dirtyRanges.end() && it->first <= end) {
+        start = std::min(start, it->first);
+        end = std::max(end, it->second);
+        it = dirtyRanges.erase(it);
+    }
+    dirtyRanges.insert(it, std::make_pair(start, end));
+    UpdateDirtyBounds();
+}
+
+void Element::UpdateDirtyBounds()
+{
+    if (dirtyRanges.empty()) {
+        dirtyStart = dirtyEnd = -1;
+    } else {
+        dirtyStart = dirtyRanges.front().first;
+        dirtyEnd = dirtyRanges.back().second;
+    }
+}
+
+void Element::GetDirtyRanges(std::list<std::pair<int, int>> &ranges) const
+{
+    std::unique_lock<std::mutex> locker(dirtyLock);
+    ranges = dirtyRanges;
+}
+
+void Element::GetAndResetDirtyRange(int &changes, int &startMs, int &endMs)
+{
+    std::unique_lock<std::mutex> locker(dirtyLock);
+    changes = changeCount;
+    startMs = dirtyStart;
+    endMs = dirtyEnd;
+    dirtyRanges.clear();
+    UpdateDirtyBounds();
+}
+
+void Element::GetAndResetDirtyRanges(int &changes, std::list<std::pair<int, int>> &ranges)
+{
+    std::unique_lock<std::mutex> locker(dirtyLock);
+    changes = changeCount;
+    ranges.clear();
+    ranges.swap(dirtyRanges);
+    UpdateDirtyBounds();
+}
+
+void Element::GetAndResetDirtyRanges(int &changes, int startMs, int endMs, std::list<std::pair<int, int>> &ranges)
+{
+    std::unique_lock<std::mutex> locker(dirtyLock);
+    changes = changeCount;
+    ranges.clear();
+    for (auto it = dirtyRanges.begin(); it != dirtyRanges.end(); ) {
+        if (it->second >= startMs && it->first <= endMs) {
+            ranges.push_back(*it);
+            it = dirtyRanges.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    UpdateDirtyBounds();
+}
+
+void Element::ClearDirtyFlags()
+{
+    std::unique_lock<std::mutex> locker(dirtyLock);
+    dirtyRanges.clear();
+    UpdateDirtyBounds();
+}
+
 void SubModelElement::IncrementChangeCount(int startMs, int endMS) {
     GetModelElement()->IncrementChangeCount(startMs, endMS);
 }
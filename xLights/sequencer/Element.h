@@ -2,6 +2,7 @@
 #define ELEMENT_H
 
 #include <vector>
+#include <list>
 #include <atomic>
 #include <mutex>
 #include <string>
@@ -80,36 +81,24 @@ public:
     virtual void IncrementChangeCount(int startMs, int endMS);
     int getChangeCount() const { return changeCount; }
     
+    // dirtyStart/dirtyEnd is the span covering every change, dirtyRanges holds the separate changed
+    // intervals (sorted and merged where they touch) so edits far apart don't dirty everything between them
     void GetDirtyRange(int &startMs, int &endMs) const {
         startMs = dirtyStart;
         endMs = dirtyEnd;
     }
-    void GetAndResetDirtyRange(int &changes, int &startMs, int &endMs) {
-        changes = changeCount;
-        startMs = dirtyStart;
-        endMs = dirtyEnd;
-        dirtyStart = dirtyEnd = -1;
-    }
-    void SetDirtyRange(int start, int end) {
-        if (dirtyStart == -1) {
-            dirtyStart = start;
-            dirtyEnd = end;
-        } else {
-            if (dirtyEnd < end) {
-                dirtyEnd = end;
-            }
-            if (dirtyStart > start) {
-                dirtyStart = start;
-            }
-        }
-    }
-    void ClearDirtyFlags() {
-        dirtyStart = dirtyEnd = -1;
-    }
+    void GetDirtyRanges(std::list<std::pair<int, int>> &ranges) const;
+    void GetAndResetDirtyRange(int &changes, int &startMs, int &endMs);
+    void GetAndResetDirtyRanges(int &changes, std::list<std::pair<int, int>> &ranges);
+    // only takes the intervals which overlap startMs-endMs, the rest stay dirty
+    void GetAndResetDirtyRanges(int &changes, int startMs, int endMs, std::list<std::pair<int, int>> &ranges);
+    void SetDirtyRange(int start, int end);
+    void ClearDirtyFlags();
     virtual void CleanupAfterRender();
     
 protected:
     EffectLayer* AddEffectLayerInternal();
+    void UpdateDirtyBounds();
 
     SequenceElements *parent;
 
@@ -124,6 +113,8 @@ protected:
     volatile int changeCount = 0;
     volatile int dirtyStart = -1;
     volatile int dirtyEnd = -1;
+    std::list<std::pair<int, int>> dirtyRanges;
+    mutable std::mutex dirtyLock;
 
     std::recursive_timed_mutex changeLock;
 };
@@ -2044,17 +2044,27 @@ void SequenceElements::BreakdownWord(EffectLayer* phoneme_layer, int start_time,
 
 void SequenceElements::IncrementChangeCount(Element *el) {
     mChangeCount++;
+    if (el == nullptr) {
+        // sequence level changes are not journalled so the next autosave must be a full one
+        undo_mgr.GetJournal().SetNeedsFullSave();
+    }
     if (el != nullptr && el->GetType() == ELEMENT_TYPE_TIMING) {
         //need to check if we need to have some models re-rendered due to timing being changed
         std::unique_lock<std::mutex> locker(renderDepLock);
         std::map<std::string, std::set<std::string>>::iterator it = renderDependency.find(el->GetModelName());
         if (it != renderDependency.end()) {
-            int origChangeCount, ss, es;
-            el->GetAndResetDirtyRange(origChangeCount, ss, es);
+            int origChangeCount;
+            std::list<std::pair<int, int>> dirty;
+            el->GetAndResetDirtyRanges(origChangeCount, dirty);
             for (std::set<std::string>::iterator sit = it->second.begin(); sit != it->second.end(); ++sit) {
                 Element *el2 = this->GetElement(*sit);
                 if (el2 != nullptr) {
-                    el2->IncrementChangeCount(ss, es);
+                    if (dirty.empty()) {
+                        el2->IncrementChangeCount(-1, -1);
+                    }
+                    for (const auto &r : dirty) {
+                        el2->IncrementChangeCount(r.first, r.second);
+                    }
                     modelsToRender.insert(*sit);
                 }
             }
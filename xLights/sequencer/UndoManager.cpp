@@ -2,12 +2,17 @@
 #include "Element.h"
 #include "SequenceElements.h"
 #include <log4cpp/Category.hh>
+#include <wx/file.h>
+#include <fstream>
+#include <functional>
 
 DeletedEffectInfo::DeletedEffectInfo( const std::string &element_name_, int layer_index_, const std::string &name_, const std::string &settings_,
                                       const std::string &palette_, int &startTimeMS_, int &endTimeMS_, int Selected_, bool Protected_ )
-: element_name(element_name_), layer_index(layer_index_), name(name_), settings(settings_),
-  palette(palette_), startTimeMS(startTimeMS_), endTimeMS(endTimeMS_), Selected(Selected_), Protected(Protected_)
+: element_name(element_name_), layer_index(layer_index_), name(name_),
+  startTimeMS(startTimeMS_), endTimeMS(endTimeMS_), Selected(Selected_), Protected(Protected_)
 {
+    settings.Parse(settings_);
+    palette.Parse(palette_);
 }
 
 AddedEffectInfo::AddedEffectInfo( const std::string &element_name_, int layer_index_, int id_ )
@@ -21,15 +26,18 @@ MovedEffectInfo::MovedEffectInfo( const std::string &element_name_, int layer_in
 }
 
 ModifiedEffectInfo::ModifiedEffectInfo( const std::string &element_name_, int layer_index_, int id_, const std::string &settings_, const std::string &palette_ )
-: element_name(element_name_), layer_index(layer_index_), id(id_), settings(settings_), palette(palette_), effectName(""), effectType(-1)
+: element_name(element_name_), layer_index(layer_index_), id(id_), effectName(""), effectType(-1)
 {
+    settings.Parse(settings_);
+    palette.Parse(palette_);
 }
 
 
 ModifiedEffectInfo::ModifiedEffectInfo( const std::string &element_name_, int layer_index_, Effect *ef)
 : element_name(element_name_), layer_index(layer_index_), id(ef->GetID()),
-    settings(ef->GetSettingsAsString()), palette(ef->GetPaletteAsString()), effectName(ef->GetEffectName()), effectType(ef->GetEffectIndex())
+    effectName(ef->GetEffectName()), effectType(ef->GetEffectIndex())
 {
+    ef->CopySettings(settings, palette);
 }
 
 UndoStep::UndoStep( UNDO_ACTIONS action )
@@ -132,6 +140,7 @@ void UndoManager::CaptureEffectToBeDeleted( const std::string &element_name, int
     DeletedEffectInfo* effect_undo_action = new DeletedEffectInfo( element_name, layer_index, name, settings, palette, startTimeMS, endTimeMS, Selected, Protected );
     UndoStep* action = new UndoStep(UNDO_EFFECT_DELETED, effect_undo_action);
     mUndoSteps.push_back(action);
+    mJournal.MarkDirty(element_name);
 }
 
 void UndoManager::CaptureAddedEffect( const std::string &element_name, int layer_index, int id )
@@ -139,6 +148,7 @@ void UndoManager::CaptureAddedEffect( const std::string &element_name, int layer
     AddedEffectInfo* effect_undo_action = new AddedEffectInfo( element_name, layer_index, id );
     UndoStep* action = new UndoStep(UNDO_EFFECT_ADDED, effect_undo_action);
     mUndoSteps.push_back(action);
+    mJournal.MarkDirty(element_name);
 }
 
 void UndoManager::CaptureEffectToBeMoved( const std::string &element_name, int layer_index, int id, int startTimeMS, int endTimeMS )
@@ -146,6 +156,7 @@ void UndoManager::CaptureEffectToBeMoved( const std::string &element_name, int l
     MovedEffectInfo* effect_undo_action = new MovedEffectInfo( element_name, layer_index, id, startTimeMS, endTimeMS );
     UndoStep* action = new UndoStep(UNDO_EFFECT_MOVED, effect_undo_action);
     mUndoSteps.push_back(action);
+    mJournal.MarkDirty(element_name);
 }
 
 void UndoManager::CaptureModifiedEffect( const std::string &element_name, int layer_index, int id, const std::string &settings, const std::string &palette )
@@ -153,12 +164,14 @@ void UndoManager::CaptureModifiedEffect( const std::string &element_name, int la
     ModifiedEffectInfo* effect_undo_action = new ModifiedEffectInfo( element_name, layer_index, id, settings, palette );
     UndoStep* action = new UndoStep(UNDO_EFFECT_MODIFIED, effect_undo_action);
     mUndoSteps.push_back(action);
+    mJournal.MarkDirty(element_name);
 }
 void UndoManager::CaptureModifiedEffect( const std::string &element_name, int layer_index, Effect *ef )
 {
     ModifiedEffectInfo* effect_undo_action = new ModifiedEffectInfo( element_name, layer_index, ef );
     UndoStep* action = new UndoStep(UNDO_EFFECT_MODIFIED, effect_undo_action);
     mUndoSteps.push_back(action);
+    mJournal.MarkDirty(element_name);
 }
 void UndoManager::UndoLastStep()
 {
@@ -182,8 +195,8 @@ void UndoManager::UndoLastStep()
                 {
                     el->AddEffect(0,
                         next_action->deleted_effect_info[0]->name,
-                        next_action->deleted_effect_info[0]->settings,
-                        next_action->deleted_effect_info[0]->palette,
+                        next_action->deleted_effect_info[0]->settings.AsString(),
+                        next_action->deleted_effect_info[0]->palette.AsString(),
                         next_action->deleted_effect_info[0]->startTimeMS,
                         next_action->deleted_effect_info[0]->endTimeMS,
                         next_action->deleted_effect_info[0]->Selected,
@@ -246,8 +259,8 @@ void UndoManager::UndoLastStep()
                             eff->SetEffectName(next_action->modified_effect_info[0]->effectName);
                             eff->SetEffectIndex(next_action->modified_effect_info[0]->effectType);
                         }
-                        eff->SetSettings(next_action->modified_effect_info[0]->settings, false);
-                        eff->SetPalette(next_action->modified_effect_info[0]->palette);
+                        eff->SetSettings(next_action->modified_effect_info[0]->settings.AsString(), false);
+                        eff->SetPalette(next_action->modified_effect_info[0]->palette.AsString());
                     }
                 }
             }
@@ -285,3 +298,370 @@ std::string UndoManager::GetUndoString()
     }
     return undo_string;
 }
+
+
+#pragma region SequenceJournal
+// Journal lines are tab separated:
+//   B  base      journal header, base is 1 when it applies over the .xbkp rather than the sequence file
+//   G  group     start of a flush, only groups closed by an X line are replayed
+//   L  element kind key layer name    replace the effects of a layer of the element (M), a submodel (S)
+//                                     or a strand (T), kind N is node <layer> of strand <key> named <name>
+//   F  name start end protected settings palette    an effect on the preceding layer
+// Only the effects of existing layers are journalled, the layer structure is the same as the base file
+static std::string JournalEscape(const std::string &s)
+{
+    std::string res;
+    res.reserve(s.size());
+    for (auto c : s) {
+        switch (c) {
+        case '\\': res += "\\\\"; break;
+        case '\t': res += "\\t"; break;
+        case '\n': res += "\\n"; break;
+        case '\r': res += "\\r"; break;
+        default: res += c; break;
+        }
+    }
+    return res;
+}
+
+static std::string JournalUnescape(const std::string &s)
+{
+    std::string res;
+    res.reserve(s.size());
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '\\' && i + 1 < s.size()) {
+            i++;
+            switch (s[i]) {
+            case 't': res += '\t'; break;
+            case 'n': res += '\n'; break;
+            case 'r': res += '\r'; break;
+            default: res += s[i]; break;
+            }
+        } else {
+            res += s[i];
+        }
+    }
+    return res;
+}
+
+static std::vector<std::string> JournalSplit(const std::string &line)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+    size_t tab = line.find('\t');
+    while (tab != std::string::npos) {
+        fields.push_back(JournalUnescape(line.substr(start, tab - start)));
+        start = tab + 1;
+        tab = line.find('\t', start);
+    }
+    fields.push_back(JournalUnescape(line.substr(start)));
+    return fields;
+}
+
+struct JournalLayer
+{
+    char kind;
+    std::string key;
+    int index;
+    std::string name;
+    EffectLayer* layer;
+};
+
+// Lists the element's layers in journal order and returns everything about the element the
+// journal can't record. If that changes the journal no longer applies and a full save is needed.
+static std::string JournalStructure(Element* el, std::vector<JournalLayer> &layers)
+{
+    layers.clear();
+    std::string structure = std::to_string(el->GetVisible()) + std::to_string(el->GetCollapsed());
+    TimingElement* te = dynamic_cast<TimingElement*>(el);
+    if (te != nullptr) {
+        structure += "\t" + std::to_string(te->GetFixedTiming()) + "\t" + std::to_string(te->GetActive()) + "\t" + te->GetViews();
+    }
+    structure += "\tM" + std::to_string(el->GetEffectLayerCount());
+    for (size_t j = 0; j < el->GetEffectLayerCount(); j++) {
+        layers.push_back({ 'M', "", (int)j, "", el->GetEffectLayer(j) });
+    }
+
+    ModelElement* me = dynamic_cast<ModelElement*>(el);
+    if (me == nullptr) return structure;
+
+    for (int s = 0; s < me->GetSubModelAndStrandCount(); s++) {
+        SubModelElement* se = me->GetSubModel(s);
+        StrandElement* ste = dynamic_cast<StrandElement*>(se);
+        char kind = ste == nullptr ? 'S' : 'T';
+        std::string key = ste == nullptr ? se->GetName() : std::to_string(ste->GetStrand());
+        structure += "\t" + std::string(1, kind) + JournalEscape(key) + "|" + JournalEscape(se->GetName()) + "|" + std::to_string(se->GetEffectLayerCount());
+        for (size_t j = 0; j < se->GetEffectLayerCount(); j++) {
+            layers.push_back({ kind, key, (int)j, "", se->GetEffectLayer(j) });
+        }
+        if (ste != nullptr) {
+            structure += "|" + std::to_string(ste->GetNodeLayerCount());
+            for (int n = 0; n < ste->GetNodeLayerCount(); n++) {
+                NodeLayer* nl = ste->GetNodeLayer(n);
+                structure += "|" + JournalEscape(nl->GetName());
+                layers.push_back({ 'N', key, n, nl->GetName(), nl });
+            }
+        }
+    }
+    return structure;
+}
+
+static std::string JournalLayerEffects(EffectLayer* el)
+{
+    std::string data;
+    for (int i = 0; i < el->GetEffectCount(); i++) {
+        Effect* eff = el->GetEffect(i);
+        data += "F\t" + JournalEscape(eff->GetEffectName())
+            + "\t" + std::to_string(eff->GetStartTimeMS())
+            + "\t" + std::to_string(eff->GetEndTimeMS())
+            + "\t" + (eff->GetProtected() ? "1" : "0")
+            + "\t" + JournalEscape(eff->GetSettingsAsString())
+            + "\t" + JournalEscape(eff->GetPaletteAsString()) + "\n";
+    }
+    return data;
+}
+
+static EffectLayer* JournalFindLayer(Element* el, const std::string &kind, const std::string &key, int index)
+{
+    Element* container = el;
+    ModelElement* me = dynamic_cast<ModelElement*>(el);
+    if (kind != "M") {
+        if (me == nullptr) return nullptr;
+        if (kind == "S") {
+            container = me->GetSubModel(key);
+        } else {
+            StrandElement* ste = me->GetStrand(wxAtoi(key));
+            if (ste != nullptr && kind == "N") {
+                return index < ste->GetNodeLayerCount() ? ste->GetNodeLayer(index) : nullptr;
+            }
+            container = ste;
+        }
+    }
+    if (container == nullptr || index < 0 || index >= (int)container->GetEffectLayerCount()) return nullptr;
+    return container->GetEffectLayer(index);
+}
+
+SequenceJournal::SequenceJournal()
+: mNeedsFullSave(false), mFlushes(0), mBytes(0), mGroup(0), mWriter(nullptr), mStopWriter(false)
+{
+}
+
+SequenceJournal::~SequenceJournal()
+{
+    Close(false);
+}
+
+void SequenceJournal::MarkDirty(const std::string &element_name)
+{
+    if (!mFilename.empty()) {
+        mDirty.insert(element_name);
+    }
+}
+
+void SequenceJournal::Reset(const std::string &filename, bool baseIsBackup, SequenceElements &elements)
+{
+    if (mFilename != "" && mFilename != filename) {
+        Queue("", false, true);
+    }
+    mFilename = filename;
+    mNeedsFullSave = false;
+    mFlushes = 0;
+    mBytes = 0;
+    mDirty.clear();
+    mElements.clear();
+    std::hash<std::string> hasher;
+    for (size_t i = 0; i < elements.GetElementCount(); i++) {
+        Element* el = elements.GetElement(i);
+        ElementState &state = mElements[el];
+        std::vector<JournalLayer> layers;
+        state.name = el->GetName();
+        state.changeCount = el->getChangeCount();
+        state.structure = JournalStructure(el, layers);
+        for (const auto &l : layers) {
+            state.layerHashes.push_back(hasher(JournalLayerEffects(l.layer)));
+        }
+    }
+    Queue(baseIsBackup ? "B\t1\n" : "B\t0\n", true, false);
+}
+
+void SequenceJournal::Close(bool removeFile)
+{
+    if (removeFile && mFilename != "") {
+        Queue("", false, true);
+    }
+    if (mWriter != nullptr) {
+        {
+            std::unique_lock<std::mutex> lock(mWriteLock);
+            mStopWriter = true;
+        }
+        mWriteSignal.notify_all();
+        mWriter->join();
+        delete mWriter;
+        mWriter = nullptr;
+        mStopWriter = false;
+    }
+    mFilename = "";
+    mDirty.clear();
+    mElements.clear();
+}
+
+// Returns false when the journal cannot represent the changes and a full save is needed instead
+bool SequenceJournal::Flush(SequenceElements &elements)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (mFilename == "" || mNeedsFullSave) return false;
+    if (mFlushes >= JOURNAL_COMPACT_FLUSHES || mBytes >= JOURNAL_COMPACT_BYTES) return false;
+
+    // edits which bypass undo still move the element change count, anything other than the effects of
+    // existing layers changing (elements or layers added, removed or renamed ...) needs a full save
+    if (elements.GetElementCount() != mElements.size()) return false;
+    std::hash<std::string> hasher;
+    std::string data;
+    int changedLayers = 0;
+    std::list<std::pair<ElementState*, ElementState>> updates;
+    for (size_t i = 0; i < elements.GetElementCount(); i++) {
+        Element* el = elements.GetElement(i);
+        auto it = mElements.find(el);
+        if (it == mElements.end() || it->second.name != el->GetName()) return false;
+        std::vector<JournalLayer> layers;
+        if (JournalStructure(el, layers) != it->second.structure) return false;
+        if (it->second.changeCount == el->getChangeCount() && mDirty.find(el->GetName()) == mDirty.end()) continue;
+
+        // only the layers whose effects differ from what the base and journal already hold are written
+        ElementState state = it->second;
+        state.changeCount = el->getChangeCount();
+        for (size_t j = 0; j < layers.size(); j++) {
+            const JournalLayer &l = layers[j];
+            std::string effects = JournalLayerEffects(l.layer);
+            size_t hash = hasher(effects);
+            if (hash != state.layerHashes[j]) {
+                state.layerHashes[j] = hash;
+                data += "L\t" + JournalEscape(el->GetName()) + "\t" + l.kind + "\t" + JournalEscape(l.key) + "\t" + std::to_string(l.index) + "\t" + JournalEscape(l.name) + "\n";
+                data += effects;
+                changedLayers++;
+            }
+        }
+        updates.push_back({ &it->second, state });
+    }
+    mDirty.clear();
+    for (auto &u : updates) {
+        *u.first = u.second;
+    }
+    if (data.empty()) return true;
+
+    data = "G\t" + std::to_string(++mGroup) + "\n" + data + "X\t" + std::to_string(mGroup) + "\n";
+
+    mFlushes++;
+    mBytes += data.size();
+    logger_base.debug("Journalled %d changed layers (%d bytes).", changedLayers, (int)data.size());
+    Queue(data, false, false);
+    return true;
+}
+
+void SequenceJournal::Queue(const std::string &data, bool truncate, bool remove)
+{
+    std::unique_lock<std::mutex> lock(mWriteLock);
+    mPendingWrites.push_back({ mFilename, data, truncate, remove });
+    if (mWriter == nullptr) {
+        mWriter = new std::thread(&SequenceJournal::WriterThread, this);
+    }
+    lock.unlock();
+    mWriteSignal.notify_all();
+}
+
+void SequenceJournal::WriterThread()
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::unique_lock<std::mutex> lock(mWriteLock);
+    while (true) {
+        mWriteSignal.wait(lock, [this] { return mStopWriter || !mPendingWrites.empty(); });
+        if (mPendingWrites.empty()) break;
+
+        JournalWrite w = mPendingWrites.front();
+        mPendingWrites.pop_front();
+        lock.unlock();
+
+        if (w.remove) {
+            if (wxFile::Exists(w.filename)) {
+                wxRemoveFile(w.filename);
+            }
+        } else {
+            wxFile f;
+            if (f.Open(w.filename, w.truncate ? wxFile::write : wxFile::write_append)) {
+                f.Write(w.data.c_str(), w.data.size());
+                f.Flush();
+                f.Close();
+            } else {
+                logger_base.warn("Unable to write autosave journal %s.", (const char *)w.filename.c_str());
+            }
+        }
+
+        lock.lock();
+    }
+}
+
+bool SequenceJournal::HasRecoverableChanges(const std::string &filename, bool &baseIsBackup)
+{
+    std::ifstream in(filename);
+    if (!in.is_open()) return false;
+
+    std::string line;
+    if (!std::getline(in, line) || line.size() < 3 || line[0] != 'B') return false;
+    baseIsBackup = line[2] == '1';
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] == 'X') return true;
+    }
+    return false;
+}
+
+int SequenceJournal::Replay(const std::string &filename, SequenceElements &elements)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::ifstream in(filename);
+    if (!in.is_open()) return 0;
+
+    int groups = 0;
+    std::vector<std::string> group;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        if (line[0] == 'G') {
+            group.clear();
+        } else if (line[0] != 'X') {
+            group.push_back(line);
+        } else {
+            // only replay groups which were completely written
+            EffectLayer* layer = nullptr;
+            for (const auto &l : group) {
+                std::vector<std::string> f = JournalSplit(l);
+                if (f[0] == "F" && f.size() == 7) {
+                    if (layer != nullptr) {
+                        layer->AddEffect(0, f[1], f[5], f[6], wxAtoi(f[2]), wxAtoi(f[3]), EFFECT_NOT_SELECTED, f[4] == "1");
+                    }
+                } else if (f[0] == "L" && f.size() == 6) {
+                    layer = nullptr;
+                    Element* el = elements.GetElement(f[1]);
+                    if (el != nullptr) {
+                        layer = JournalFindLayer(el, f[2], f[3], wxAtoi(f[4]));
+                    }
+                    NodeLayer* nl = dynamic_cast<NodeLayer*>(layer);
+                    if (layer == nullptr || (f[2] == "N" && (nl == nullptr || nl->GetName() != f[5]))) {
+                        // the journal only holds layers which existed in the base file so this should not happen
+                        logger_base.warn("Autosave journal references missing layer %s %s %s %s.",
+                            (const char *)f[1].c_str(), (const char *)f[2].c_str(), (const char *)f[3].c_str(), (const char *)f[4].c_str());
+                        layer = nullptr;
+                        continue;
+                    }
+                    layer->RemoveAllEffects(nullptr);
+                }
+            }
+            group.clear();
+            groups++;
+        }
+    }
+    return groups;
+}
+#pragma endregion
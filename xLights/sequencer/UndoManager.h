@@ -3,10 +3,25 @@
 
 #include "wx/wx.h"
 #include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "../UtilClasses.h"
 
 class SequenceElements;
+class Element;
 class Effect;
 
+// after this many journal flushes or bytes the next autosave writes a full backup instead
+#define JOURNAL_COMPACT_FLUSHES 10
+#define JOURNAL_COMPACT_BYTES (32 * 1024 * 1024)
+
 enum UNDO_ACTIONS
 {
     UNDO_MARKER,   // use this to mark the beginning of a group of actions that should be undone together
@@ -22,8 +37,8 @@ public:
     std::string element_name;
     int layer_index;
     std::string name;
-    std::string settings;
-    std::string palette;
+    SettingsMap settings; // shares the interned maps rather than holding another string copy
+    SettingsMap palette;
     int startTimeMS;
     int endTimeMS;
     int Selected;
@@ -58,8 +73,8 @@ public:
     std::string element_name;
     int layer_index;
     int id;
-    std::string settings;
-    std::string palette;
+    SettingsMap settings;
+    SettingsMap palette;
     std::string effectName;
     int effectType;
     
@@ -83,6 +98,61 @@ public:
     std::vector<ModifiedEffectInfo*> modified_effect_info;
 };
 
+// Append-only record of the effect layers changed since the last full save. Flush snapshots
+// only the layers whose effects changed on the GUI thread and a background thread appends them
+// to the journal file so a crash can be recovered by replaying it over the last full save.
+// Anything else about an element changing (layers added, removed or renamed, strand and node
+// layers, display settings) can't be journalled and makes the next autosave a full one.
+class SequenceJournal
+{
+    public:
+        SequenceJournal();
+        virtual ~SequenceJournal();
+
+        void Reset(const std::string &filename, bool baseIsBackup, SequenceElements &elements);
+        void Close(bool removeFile);
+        void MarkDirty(const std::string &element_name);
+        void SetNeedsFullSave() { mNeedsFullSave = true; }
+        bool Flush(SequenceElements &elements);
+
+        static bool HasRecoverableChanges(const std::string &filename, bool &baseIsBackup);
+        static int Replay(const std::string &filename, SequenceElements &elements);
+
+    private:
+        struct JournalWrite
+        {
+            std::string filename;
+            std::string data;
+            bool truncate;
+            bool remove;
+        };
+
+        struct ElementState
+        {
+            std::string name;
+            int changeCount;
+            std::string structure;
+            std::vector<size_t> layerHashes;
+        };
+
+        void Queue(const std::string &data, bool truncate, bool remove);
+        void WriterThread();
+
+        std::string mFilename;
+        std::atomic<bool> mNeedsFullSave;
+        int mFlushes;
+        size_t mBytes;
+        int mGroup;
+        std::set<std::string> mDirty;
+        std::map<const Element*, ElementState> mElements;
+
+        std::thread* mWriter;
+        std::mutex mWriteLock;
+        std::condition_variable mWriteSignal;
+        std::list<JournalWrite> mPendingWrites;
+        bool mStopWriter;
+};
+
 class UndoManager
 {
     public:
@@ -107,13 +177,15 @@ class UndoManager
         void CaptureEffectToBeMoved( const std::string &element_name, int layer_index, int id, int startTimeMS, int endTimeMS );
         void CaptureModifiedEffect( const std::string &element_name, int layer_index, int id, const std::string &settings, const std::string &palette );
         void CaptureModifiedEffect( const std::string &element_name, int layer_index, Effect *ef);
+
+        SequenceJournal& GetJournal() { return mJournal; }
     protected:
 
     private:
         std::vector<UndoStep*> mUndoSteps;
         SequenceElements* mParentSequence;
         bool mCaptureUndo;
-
+        SequenceJournal mJournal;
 };
 
 #endif // UNDOMANAGER_H
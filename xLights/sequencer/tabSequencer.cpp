@@ -769,6 +769,11 @@ void xLightsFrame::LoadSequencer(xLightsXmlFile& xml_file)
     m_mgr->Update();
     _selectPanel->ReloadModels();
 
+    size_t uniqueSettings, settingsRefs, settingsBytes;
+    MapStringString::GetInternStats(uniqueSettings, settingsRefs, settingsBytes);
+    logger_base.debug("Effect settings: %d unique maps shared by %d references, approx %dKB.",
+        (int)uniqueSettings, (int)settingsRefs, (int)(settingsBytes / 1024));
+
     logger_base.debug("Sequence all loaded.");
 }
 
@@ -2078,9 +2083,15 @@ void xLightsFrame::TimerRgbSeq(long msec)
     std::vector<Element *> elsToRender;
     if (mSequenceElements.GetElementsToRender(elsToRender)) {
         for (std::vector<Element *>::iterator it = elsToRender.begin(); it != elsToRender.end(); ++it) {
-            int ss, es;
-            (*it)->GetDirtyRange(ss, es);
-            RenderEffectForModel((*it)->GetModelName(), ss, es);
+            //one render per dirty interval rather than everything between the first and last change
+            std::list<std::pair<int, int>> dirty;
+            (*it)->GetDirtyRanges(dirty);
+            if (dirty.empty()) {
+                RenderEffectForModel((*it)->GetModelName(), -1, -1);
+            }
+            for (const auto &r : dirty) {
+                RenderEffectForModel((*it)->GetModelName(), r.first, r.second);
+            }
         }
     }
 
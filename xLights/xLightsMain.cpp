@@ -352,6 +352,7 @@ const long xLightsFrame::ID_MNU_DEFAULTMODELBLENDOFF = wxNewId();
 const long xLightsFrame::ID_MNU_SNAP_TO_TIMING = wxNewId();
 const long xLightsFrame::ID_MENUITEM21 = wxNewId();
 const long xLightsFrame::ID_MENUITEM22 = wxNewId();
+const long xLightsFrame::ID_MNU_FSEQ_V2_DELTA = wxNewId();
 const long xLightsFrame::ID_MENUITEM1 = wxNewId();
 const long xLightsFrame::ID_MNU_MANUAL = wxNewId();
 const long xLightsFrame::ID_MNU_ZOOM = wxNewId();
@@ -1182,6 +1183,8 @@ xLightsFrame::xLightsFrame(wxWindow* parent, wxWindowID id) : mSequenceElements(
     MenuItem54->Append(MenuItemFSEQV1);
     MenuItemFSEQV2 = new wxMenuItem(MenuItem54, ID_MENUITEM22, _("V2"), wxEmptyString, wxITEM_RADIO);
     MenuItem54->Append(MenuItemFSEQV2);
+    MenuItemFSEQV2Delta = new wxMenuItem(MenuItem54, ID_MNU_FSEQ_V2_DELTA, _("V2 Delta"), wxEmptyString, wxITEM_RADIO);
+    MenuItem54->Append(MenuItemFSEQV2Delta);
     MenuSettings->Append(ID_MENUITEM1, _("FSEQ Version"), MenuItem54, wxEmptyString);
     MenuBar->Append(MenuSettings, _("&Settings"));
     MenuHelp = new wxMenu();
@@ -1432,6 +1435,7 @@ xLightsFrame::xLightsFrame(wxWindow* parent, wxWindowID id) : mSequenceElements(
     Connect(ID_MNU_SNAP_TO_TIMING,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xLightsFrame::OnMenuItem_SnapToTimingMarksSelected);
     Connect(ID_MENUITEM21,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xLightsFrame::OnMenuItemFSEQV1Selected);
     Connect(ID_MENUITEM22,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xLightsFrame::OnMenuItemFSEQV2Selected);
+    Connect(ID_MNU_FSEQ_V2_DELTA,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xLightsFrame::OnMenuItemFSEQV2DeltaSelected);
     Connect(ID_MNU_MANUAL,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xLightsFrame::OnMenuItem_UserManualSelected);
     Connect(ID_MNU_ZOOM,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xLightsFrame::OnMenuItem_ZoomSelected);
     Connect(ID_MNU_KEYBINDINGS,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xLightsFrame::OnMenuItem_ShowKeyBindingsSelected);
@@ -1614,8 +1618,11 @@ xLightsFrame::xLightsFrame(wxWindow* parent, wxWindowID id) : mSequenceElements(
     logger_base.debug("Snap To Timing Marks: %s.", _snapToTimingMarks ? "true" : "false");
 
     config->Read("xLightsFSEQVersion", &_fseqVersion, 2);
+    config->Read("xLightsFSEQDelta", &_fseqDelta, false);
+    if (_fseqVersion == 1) _fseqDelta = false;
     MenuItemFSEQV1->Check(_fseqVersion == 1);
-    MenuItemFSEQV2->Check(_fseqVersion == 2);
+    MenuItemFSEQV2->Check(_fseqVersion == 2 && !_fseqDelta);
+    MenuItemFSEQV2Delta->Check(_fseqVersion == 2 && _fseqDelta);
 
     logger_base.debug("xLightsFrame constructor creating sequencer.");
 
@@ -2246,6 +2253,7 @@ xLightsFrame::~xLightsFrame()
     config->Write("xLightsModelBlendDefaultOff", _modelBlendDefaultOff);
     config->Write("xLightsSnapToTimingMarks", _snapToTimingMarks);
     config->Write("xLightsFSEQVersion", _fseqVersion);
+    config->Write("xLightsFSEQDelta", _fseqDelta);
     config->Write("xLightsAutoSavePerspectives", _autoSavePerspecive);
     config->Write("xLightsBackupOnSave", mBackupOnSave);
     config->Write("xLightsBackupOnLaunch", mBackupOnLaunch);
@@ -4215,6 +4223,23 @@ void xLightsFrame::SaveWorking()
 
     CurrentSeqXmlFile->SetPath(p);
     CurrentSeqXmlFile->SetFullName(fn);
+
+    // the backup now holds everything so restart the journal on top of it
+    if (!_renderMode)
+    {
+        mSequenceElements.get_undo_mgr().GetJournal().Reset(GetSequenceJournalFile(), true, mSequenceElements);
+    }
+}
+
+std::string xLightsFrame::GetSequenceJournalFile() const
+{
+    wxString fn = CurrentSeqXmlFile->GetFullName();
+    if (fn == "")
+    {
+        return (CurrentSeqXmlFile->GetPath() + "/" + "__.xjrnl").ToStdString();
+    }
+    wxFileName fnp(fn);
+    return (CurrentSeqXmlFile->GetPath() + "/" + fnp.GetName() + ".xjrnl").ToStdString();
 }
 
 void xLightsFrame::OnTimer_AutoSaveTrigger(wxTimerEvent& event)
@@ -4228,7 +4253,12 @@ void xLightsFrame::OnTimer_AutoSaveTrigger(wxTimerEvent& event)
         {
             if (mSequenceElements.GetChangeCount() != mLastAutosaveCount)
             {
-                SaveWorking();
+                // append the changed layers to the journal, periodically compacting it into a full backup
+                if (!mSequenceElements.get_undo_mgr().GetJournal().Flush(mSequenceElements))
+                {
+                    logger_base.debug("    Writing full backup.");
+                    SaveWorking();
+                }
                 mLastAutosaveCount = mSequenceElements.GetChangeCount();
             }
             else
@@ -9335,11 +9365,21 @@ void xLightsFrame::OnMenuItem_Generate2DPathSelected(wxCommandEvent& event)
 void xLightsFrame::OnMenuItemFSEQV1Selected(wxCommandEvent& event)
 {
     _fseqVersion = 1;
+    _fseqDelta = false;
 }
 
 void xLightsFrame::OnMenuItemFSEQV2Selected(wxCommandEvent& event)
 {
     _fseqVersion = 2;
+    _fseqDelta = false;
+}
+
+// V2 with each frame stored as a delta of the previous one, smaller files but
+// players need to understand compression type 3
+void xLightsFrame::OnMenuItemFSEQV2DeltaSelected(wxCommandEvent& event)
+{
+    _fseqVersion = 2;
+    _fseqDelta = true;
 }
 
 void xLightsFrame::OnMenuItem_PrepareAudioSelected(wxCommandEvent& event)
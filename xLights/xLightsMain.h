@@ -48,6 +48,7 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <memory>
 
 #ifdef LINUX
 #include <unistd.h>
@@ -77,6 +78,8 @@ class ConvertDialog;
 class ConvertLogDialog;
 class wxDebugReport;
 class RenderTreeData;
+class RenderWatermark;
+class FSEQFile;
 class HousePreviewPanel;
 class SelectPanel;
 class SequenceVideoPanel;
@@ -342,6 +345,7 @@ public:
     void ConversionError(const wxString& msg);
     void SetMediaFilename(const wxString& filename);
     void RenderIseqData(bool bottom_layers, ConvertLogDialog* plog);
+    bool HasIseqLayersAbove();
     bool IsSequenceDataValid() const
     { return SeqData.IsValidData(); }
     void ClearSequenceData();
@@ -362,6 +366,7 @@ public:
     void ImportSuperStar(const wxFileName &filename);
     void SaveWorking();
     void SaveWorkingLayout();
+    std::string GetSequenceJournalFile() const;
     void PlayerError(const wxString& msg);
     void AskCloseSequence();
     void SaveCurrentTab();
@@ -560,6 +565,7 @@ public:
     void OnMenuItem_Generate2DPathSelected(wxCommandEvent& event);
     void OnMenuItemFSEQV1Selected(wxCommandEvent& event);
     void OnMenuItemFSEQV2Selected(wxCommandEvent& event);
+    void OnMenuItemFSEQV2DeltaSelected(wxCommandEvent& event);
     void OnMenuItem_PrepareAudioSelected(wxCommandEvent& event);
     void OnMenuItemOGLRenderOrder(wxCommandEvent& event);
     void OnMenuItem_UserManualSelected(wxCommandEvent& event);
@@ -818,6 +824,7 @@ public:
     static const long ID_MNU_SNAP_TO_TIMING;
     static const long ID_MENUITEM21;
     static const long ID_MENUITEM22;
+    static const long ID_MNU_FSEQ_V2_DELTA;
     static const long ID_MENUITEM1;
     static const long ID_MNU_MANUAL;
     static const long ID_MNU_ZOOM;
@@ -924,6 +931,7 @@ public:
     wxMenuItem* MenuItemEffectAssistWindow;
     wxMenuItem* MenuItemFSEQV1;
     wxMenuItem* MenuItemFSEQV2;
+    wxMenuItem* MenuItemFSEQV2Delta;
     wxMenuItem* MenuItemGridIconBackgroundOff;
     wxMenuItem* MenuItemGridIconBackgroundOn;
     wxMenuItem* MenuItemGridNodeValuesOff;
@@ -1090,6 +1098,7 @@ public:
     bool _snapToTimingMarks;
     bool _autoSavePerspecive;
     int _fseqVersion;
+    bool _fseqDelta;
     int _xFadePort;
     bool _wasMaximised = false;
     wxSocketServer* _xFadeSocket = nullptr;
@@ -1196,6 +1205,7 @@ public:
     void ReadXlightsFile(const wxString& FileName, wxString *mediaFilename = nullptr);
     void ReadFalconFile(const wxString& FileName, ConvertDialog* convertdlg);
     void WriteFalconPiFile(const wxString& filename); //  Falcon Pi Player *.pseq
+    FSEQFile* CreateFalconPiFile(const wxString& filename);
     OutputManager* GetOutputManager() { return &_outputManager; };
 
 private:
@@ -1226,7 +1236,7 @@ private:
 public:
     bool InitPixelBuffer(const std::string &modelName, PixelBufferClass &buffer, int layerCount, bool zeroBased = false);
     Model *GetModel(const std::string& name) const;
-    void RenderGridToSeqData(std::function<void()>&& callback);
+    void RenderGridToSeqData(std::function<void()>&& callback, const wxString& streamFseqFile = wxEmptyString);
     bool AbortRender();
     std::string GetSelectedLayoutPanelPreview() const;
     void UpdateRenderStatus();
@@ -1238,13 +1248,16 @@ public:
     void RenderEffectOnMainThread(RenderEvent *evt);
     void RenderEffectForModel(const std::string &model, int startms, int endms, bool clear = false);
     void RenderDirtyModels();
+    int GetWarmupStartFrame(const std::list<Model *> &models, int startFrame);
     void RenderTimeSlice(int startms, int endms, bool clear);
     void Render(const std::list<Model*> models,
                 const std::list<Model *> &restrictToModels,
                 int startFrame, int endFrame,
                 bool progressDialog, bool clear,
-                std::function<void()>&& callback);
+                std::function<void()>&& callback,
+                std::shared_ptr<RenderWatermark> watermark = nullptr);
     void BuildRenderTree();
+    void ClearRenderBufferPool();
 
     void RenderRange(RenderCommandEvent &cmd);
     void RenderDone();
@@ -1359,7 +1372,7 @@ private:
         RenderTree() : renderTreeChangeCount(0) {}
         ~RenderTree() { Clear(); }
         void Clear();
-        void Add(Model *el);
+        void Build(const std::list<Model*> &models);
         void Print();
 
         unsigned int renderTreeChangeCount;
@@ -72,6 +72,10 @@ protected:
     void SetPriority(size_t priority) { if (_priority != priority) { _priority = priority; _changeCount++; } }
     virtual bool Done() const { return false; }
     virtual void Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe) = 0;
+    // items which can decode their frame data into a private buffer without touching the output buffer
+    // or the UI can do so on a worker thread ahead of Frame being called
+    virtual bool CanPrepareFrame() const { return false; }
+    virtual void PrepareFrame(size_t ms, size_t framems, bool outputframe) {}
     virtual std::string GetSyncItemFSEQ() const { return ""; }
     virtual std::string GetSyncItemMedia() { return ""; }
     virtual std::string GetTitle() const = 0;
@@ -469,6 +469,31 @@ bool PlayListItemFSEQ::Done() const
     return GetPositionMS() >= GetDurationMS() - _msPerFrame;
 }
 
+bool PlayListItemFSEQ::DecodeFrame(int frame)
+{
+    _preparedFrame = -1;
+    FSEQFile::FrameData *data = _fseqFile->getFrame(frame);
+    if (data == nullptr) return false;
+
+    _preparedData.resize(_fseqFile->getMaxChannel() + 1);
+    data->readFrame(&_preparedData[0]);
+    delete data;
+    _preparedFrame = frame;
+    return true;
+}
+
+// Called from a worker thread before Frame ... only decodes so it must not touch audio or the output buffer
+void PlayListItemFSEQ::PrepareFrame(size_t ms, size_t framems, bool outputframe)
+{
+    if (!outputframe || _fseqFile == nullptr || ms < _delay)
+    {
+        _preparedFrame = -1;
+        return;
+    }
+
+    DecodeFrame((ms - _delay) / framems);
+}
+
 void PlayListItemFSEQ::Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe)
 {
     //static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -491,11 +516,9 @@ void PlayListItemFSEQ::Frame(uint8_t* buffer, size_t size, size_t ms, size_t fra
                 ms -= _delay;
                 
                 int frame =  ms / framems;
-                FSEQFile::FrameData *data = _fseqFile->getFrame(frame);
-                if (data != nullptr)
+                if (_preparedFrame == frame || DecodeFrame(frame))
                 {
-                    std::vector<uint8_t> buf(_fseqFile->getMaxChannel() + 1);
-                    data->readFrame(&buf[0]);
+                    uint8_t* buf = &_preparedData[0];
                     size_t channelsPerFrame = (size_t)_fseqFile->getMaxChannel() + 1;
                     if (_channels > 0) channelsPerFrame = std::min(_channels, (size_t)_fseqFile->getMaxChannel() + 1);
                     if (_channels > 0) {
@@ -505,7 +528,7 @@ void PlayListItemFSEQ::Frame(uint8_t* buffer, size_t size, size_t ms, size_t fra
                     else {
                         Blend(buffer, size, &buf[0], channelsPerFrame, _applyMethod, 0);
                     }
-                    delete data;
+                    _preparedFrame = -1;
                 }
                 else
                 {
@@ -600,6 +623,7 @@ void PlayListItemFSEQ::CloseFiles()
         delete _fseqFile;
         _fseqFile = nullptr;
     }
+    _preparedFrame = -1;
 
     if (_audioManager != nullptr)
     {
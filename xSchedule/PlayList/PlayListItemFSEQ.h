@@ -4,6 +4,7 @@
 #include "PlayListItem.h"
 #include "../Blend.h"
 #include <string>
+#include <vector>
 
 class wxXmlNode;
 class wxWindow;
@@ -32,12 +33,15 @@ protected:
     size_t _channels;
     bool _fastStartAudio;
     std::string _cachedAudioFilename;
+    std::vector<uint8_t> _preparedData;
+    int _preparedFrame = -1;
     #pragma endregion Member Variables
 
     void LoadFiles();
     void CloseFiles();
     void FastSetDuration();
     void LoadAudio();
+    bool DecodeFrame(int frame);
 
 public:
 
@@ -85,6 +89,8 @@ public:
 
     #pragma region Playing
     virtual void Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe) override;
+    virtual bool CanPrepareFrame() const override { return _fseqFile != nullptr; }
+    virtual void PrepareFrame(size_t ms, size_t framems, bool outputframe) override;
     virtual void Start(long stepLengthMS) override;
     virtual void Stop() override;
     virtual void Restart() override;
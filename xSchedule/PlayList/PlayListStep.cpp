@@ -28,6 +28,7 @@
 #include "PlayListItemRunCommand.h"
 #include "PlayListItemOSC.h"
 #include "PlayListItemAudio.h"
+#include "../../xLights/Parallel.h"
 #include "PlayListItemARTNetTrigger.h"
 #include <wx/filename.h>
 #include "../xScheduleMain.h"
@@ -466,6 +467,27 @@ bool PlayListStep::Frame(uint8_t* buffer, size_t size, bool outputframe)
     //logger_base.debug("Step %s frame %ld start.", (const char *)GetNameNoTime().c_str(), (long)frameMS);
 
     wxStopWatch sw;
+
+    // decode the frame data of items that can do so off this thread in parallel ... blending still happens below in render order
+    if (outputframe)
+    {
+        std::vector<PlayListItem*> prepare;
+        for (auto it = _items.begin(); it != _items.end(); ++it)
+        {
+            if ((*it)->CanPrepareFrame())
+            {
+                prepare.push_back(*it);
+            }
+        }
+
+        if (prepare.size() > 1)
+        {
+            parallel_for(0, prepare.size(), [&prepare, frameMS, msPerFrame](int i) {
+                prepare[i]->PrepareFrame(frameMS, msPerFrame, true);
+            });
+        }
+    }
+
     // we do this backwards to ensure the right render order
     for (auto it = _items.rbegin(); it != _items.rend(); ++it)
     {
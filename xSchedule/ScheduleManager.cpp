@@ -36,9 +36,169 @@
 #include "wxJSON/jsonreader.h"
 
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
 
 #include <log4cpp/Category.hh>
 
+// Sends prepared frames to the lights on its own thread so the next frame can be prepared while the
+// current one goes out. Frames are sent on an absolute clock (each one rate ms after the last) so
+// jitter in preparation does not show up in the output, frames which arrive after their slot are
+// sent immediately and counted as late. A frame more than a whole frame period past its slot is
+// treated as output resuming after a gap and restarts the clock, as does a flush.
+class FrameOutputThread
+{
+    OutputManager* _outputManager;
+    long _channels;
+    uint8_t* _sending;
+    long _msec = 0;
+    bool _pending = false;
+    bool _busy = false;
+    bool _stop = false;
+    std::chrono::steady_clock::time_point _deadline;
+    int _rate = 0;
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::thread* _thread = nullptr;
+
+    std::atomic<long> _frames;
+    std::atomic<long> _lateFrames;
+    std::atomic<long> _lastLateMS;
+    std::atomic<long> _maxLateMS;
+    std::atomic<long> _sendMS;
+    std::atomic<long> _maxSendMS;
+    std::atomic<long> _prepareMS;
+    std::atomic<long> _maxPrepareMS;
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> locker(_lock);
+        while (!_stop)
+        {
+            if (!_pending)
+            {
+                _signal.wait(locker);
+                continue;
+            }
+            auto deadline = _deadline;
+            locker.unlock();
+
+            auto now = std::chrono::steady_clock::now();
+            if (now < deadline)
+            {
+                std::this_thread::sleep_until(deadline);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            _outputManager->StartFrame(_msec);
+            _outputManager->SetManyChannelsZeroCopy(0, _sending, _channels);
+            _outputManager->EndFrame();
+            long sendMS = (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            _sendMS = sendMS;
+            if (sendMS > _maxSendMS) _maxSendMS = sendMS;
+            _frames++;
+
+            locker.lock();
+            _pending = false;
+            _busy = false;
+            _signal.notify_all();
+        }
+    }
+
+public:
+    FrameOutputThread(OutputManager* outputManager, long channels) :
+        _outputManager(outputManager), _channels(channels), _frames(0), _lateFrames(0), _lastLateMS(0), _maxLateMS(0), _sendMS(0), _maxSendMS(0), _prepareMS(0), _maxPrepareMS(0)
+    {
+        _sending = (uint8_t*)malloc(_channels);
+        memset(_sending, 0x00, _channels);
+        _thread = new std::thread(&FrameOutputThread::Run, this);
+    }
+
+    virtual ~FrameOutputThread()
+    {
+        {
+            std::unique_lock<std::mutex> locker(_lock);
+            _stop = true;
+            _signal.notify_all();
+        }
+        _thread->join();
+        delete _thread;
+        free(_sending);
+    }
+
+    // Hand over a prepared frame. The data is copied so the caller can start on the next frame straight away.
+    void Send(const uint8_t* buffer, long msec, int rate, long prepareMS)
+    {
+        static log4cpp::Category &logger_frame = log4cpp::Category::getInstance(std::string("log_frame"));
+
+        _prepareMS = prepareMS;
+        if (prepareMS > _maxPrepareMS) _maxPrepareMS = prepareMS;
+
+        std::unique_lock<std::mutex> locker(_lock);
+        while (_busy)
+        {
+            // the output of the previous frame is still going, this frame will be late
+            _signal.wait(locker);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (rate != _rate || _deadline.time_since_epoch().count() == 0)
+        {
+            // first frame, rate change or after a flush ... restart the clock from now
+            _rate = rate;
+            _deadline = now;
+        }
+        else if (now - _deadline > std::chrono::milliseconds(2 * rate))
+        {
+            // more than a whole frame past this frames slot means output stopped for a while (start,
+            // pause or idle) rather than the frame being late ... restart the clock without counting it
+            logger_frame.debug("Frame output resumed after %ldms gap, restarting the clock.",
+                (long)std::chrono::duration_cast<std::chrono::milliseconds>(now - _deadline).count());
+            _deadline = now;
+        }
+        else
+        {
+            _deadline += std::chrono::milliseconds(rate);
+            if (now > _deadline)
+            {
+                long late = (long)std::chrono::duration_cast<std::chrono::milliseconds>(now - _deadline).count();
+                _lateFrames++;
+                _lastLateMS = late;
+                if (late > _maxLateMS) _maxLateMS = late;
+                logger_frame.debug("Frame output %ldms late.", late);
+                // restart the clock so we dont rush the following frames out to catch up
+                _deadline = now;
+            }
+        }
+
+        memcpy(_sending, buffer, _channels);
+        _msec = msec;
+        _pending = true;
+        _busy = true;
+        _signal.notify_all();
+    }
+
+    // Wait for any frame in flight to be sent. Output has been interrupted so the next frame restarts the clock.
+    void Flush()
+    {
+        std::unique_lock<std::mutex> locker(_lock);
+        while (_busy)
+        {
+            _signal.wait(locker);
+        }
+        _deadline = std::chrono::steady_clock::time_point();
+    }
+
+    std::string GetStats() const
+    {
+        return wxString::Format("{\"outputframes\":\"%ld\",\"lateframes\":\"%ld\",\"lastlatems\":\"%ld\",\"maxlatems\":\"%ld\",\"sendms\":\"%ld\",\"maxsendms\":\"%ld\",\"preparems\":\"%ld\",\"maxpreparems\":\"%ld\"}",
+            (long)_frames, (long)_lateFrames, (long)_lastLateMS, (long)_maxLateMS, (long)_sendMS, (long)_maxSendMS, (long)_prepareMS, (long)_maxPrepareMS).ToStdString();
+    }
+};
+
 ScheduleManager::ScheduleManager(xScheduleFrame* frame, const std::string& showDir)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -184,6 +344,8 @@ ScheduleManager::ScheduleManager(xScheduleFrame* frame, const std::string& showD
     logger_base.info("Allocated frame buffer of %ld bytes", _outputManager->GetTotalChannels());
     _buffer = (uint8_t*)malloc(_outputManager->GetTotalChannels());
     memset(_buffer, 0x00, _outputManager->GetTotalChannels());
+
+    _frameOutput = new FrameOutputThread(_outputManager, _outputManager->GetTotalChannels());
 }
 
 void ScheduleManager::AddPlayList(PlayList* playlist)
@@ -470,6 +632,12 @@ ScheduleManager::~ScheduleManager()
         delete _listenerManager;
     }
 
+    if (_frameOutput != nullptr)
+    {
+        delete _frameOutput;
+        _frameOutput = nullptr;
+    }
+
     delete _scheduleOptions;
     delete _outputManager;
     _syncManager = nullptr;
@@ -684,6 +852,7 @@ void ScheduleManager::AllOff()
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     logger_base.debug("Turning all the lights off.");
 
+    FlushFrameOutput();
     memset(_buffer, 0x00, _outputManager->GetTotalChannels()); // clear out any prior frame data
     _outputManager->StartFrame(0);
 
@@ -758,10 +927,24 @@ void ScheduleManager::AllOff()
         (*it)->Frame(_buffer, _outputManager->GetTotalChannels());
     }
 
-    _outputManager->SetManyChannels(0, _buffer, _outputManager->GetTotalChannels());
+    _outputManager->SetManyChannelsZeroCopy(0, _buffer, _outputManager->GetTotalChannels());
     _outputManager->EndFrame();
 }
 
+void ScheduleManager::FlushFrameOutput()
+{
+    if (_frameOutput != nullptr)
+    {
+        _frameOutput->Flush();
+    }
+}
+
+std::string ScheduleManager::GetFrameStats() const
+{
+    if (_frameOutput == nullptr) return "{}";
+    return _frameOutput->GetStats();
+}
+
 int ScheduleManager::Frame(bool outputframe)
 {
     static bool reentry = false;
@@ -793,6 +976,7 @@ int ScheduleManager::Frame(bool outputframe)
 
         if (outputframe)
         {
+            FlushFrameOutput();
             memset(_buffer, 0x00, totalChannels); // clear out any prior frame data
             _outputManager->StartFrame(msec);
             TestFrame(_buffer, totalChannels, msec);
@@ -828,7 +1012,7 @@ int ScheduleManager::Frame(bool outputframe)
 
         if (outputframe)
         {
-            _outputManager->SetManyChannels(0, _buffer, totalChannels);
+            _outputManager->SetManyChannelsZeroCopy(0, _buffer, totalChannels);
             _outputManager->EndFrame();
         }
     }
@@ -853,7 +1037,6 @@ int ScheduleManager::Frame(bool outputframe)
             if (outputframe)
             {
                 memset(_buffer, 0x00, totalChannels); // clear out any prior frame data
-                _outputManager->StartFrame(msec);
             }
 
             bool done = false;
@@ -980,13 +1163,10 @@ int ScheduleManager::Frame(bool outputframe)
 
                 logger_frame.debug("Frame: Listening done %ldms", sw.Time());
 
-                _outputManager->SetManyChannels(0, _buffer, totalChannels);
-
-                logger_frame.debug("Frame: Data set %ldms", sw.Time());
+                // the output thread sends this frame on its slot while we get on with the next one
+                _frameOutput->Send(_buffer, msec, rate, sw.Time());
 
-                _outputManager->EndFrame();
-
-                logger_frame.debug("Frame: Data sent %ldms", sw.Time());
+                logger_frame.debug("Frame: Data queued for output %ldms", sw.Time());
             }
 
             if (done)
@@ -1014,6 +1194,7 @@ int ScheduleManager::Frame(bool outputframe)
             {
                 if (outputframe)
                 {
+                    FlushFrameOutput();
                     _outputManager->StartFrame(0);
                     _outputManager->AllOff(false);
                 }
@@ -1089,7 +1270,7 @@ int ScheduleManager::Frame(bool outputframe)
 
                 if (outputframe)
                 {
-                    _outputManager->SetManyChannels(0, _buffer, totalChannels);
+                    _outputManager->SetManyChannelsZeroCopy(0, _buffer, totalChannels);
                     _outputManager->EndFrame();
                 }
             }
@@ -1099,6 +1280,7 @@ int ScheduleManager::Frame(bool outputframe)
                 {
                     if (outputframe)
                     {
+                        FlushFrameOutput();
                         _outputManager->StartFrame(0);
                         _outputManager->AllOff(false);
                     }
@@ -1150,7 +1332,7 @@ int ScheduleManager::Frame(bool outputframe)
 
                     if (outputframe)
                     {
-                        _outputManager->SetManyChannels(0, _buffer, totalChannels);
+                        _outputManager->SetManyChannelsZeroCopy(0, _buffer, totalChannels);
                         _outputManager->EndFrame();
                     }
                 }
@@ -3015,6 +3197,7 @@ void ScheduleManager::StopPlayList(PlayList* playlist, bool atendofcurrentstep,
 // 127.0.0.1/xScheduleQuery?Query=GetPlayListSteps&Parameters=<playlistname>
 // 127.0.0.1/xScheduleQuery?Query=GetPlayingStatus&Parameters=
 // 127.0.0.1/xScheduleQuery?Query=GetButtons&Parameters=
+// 127.0.0.1/xScheduleQuery?Query=GetFrameStats&Parameters=
 
 bool ScheduleManager::Query(const wxString command, const wxString parameters, wxString& data, wxString& msg, const wxString& ip, const wxString& reference)
 {
@@ -3357,6 +3540,10 @@ bool ScheduleManager::Query(const wxString command, const wxString parameters, w
     {
         data = _scheduleOptions->GetButtonsJSON(_commandManager, reference);
     }
+    else if (command == "GetFrameStats")
+    {
+        data = GetFrameStats();
+    }
     else
     {
         result = false;
@@ -3641,6 +3828,7 @@ void ScheduleManager::SetOutputToLights(xScheduleFrame* frame, bool otl, bool in
         {
             if (IsOutputToLights())
             {
+                FlushFrameOutput();
                 _outputManager->StopOutput();
                 StopVirtualMatrices();
                 ManageBackground();
@@ -3671,6 +3859,7 @@ void ScheduleManager::ManualOutputToLightsClick(xScheduleFrame* frame)
     }
     else if (_manualOTL == 0)
     {
+        FlushFrameOutput();
         _outputManager->StopOutput();
         StopVirtualMatrices();
         ManageBackground();
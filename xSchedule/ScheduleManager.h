@@ -23,6 +23,7 @@ class PlayListItem;
 class xScheduleFrame;
 class Pinger;
 class ListenerManager;
+class FrameOutputThread;
 
 class PixelData
 {
@@ -95,6 +96,7 @@ class ScheduleManager
     bool _webRequestToggle;
     Pinger* _pinger;
     std::unique_ptr<SyncManager> _syncManager = nullptr;
+    FrameOutputThread* _frameOutput = nullptr;
 
     void DisableRemoteOutputs();
     std::string GetPingStatus();
@@ -167,6 +169,8 @@ class ScheduleManager
         void AdjustBrightness(int by) { _brightness += by; if (_brightness < 0) _brightness = 0; else if (_brightness > 100) _brightness = 100; }
         void SetBrightness(int brightness) { if (brightness < 0) _brightness = 0; else if (brightness > 100) _brightness = 100; else _brightness = brightness; }
         int Frame(bool outputframe); // called when a frame needs to be displayed ... returns desired frame rate
+        void FlushFrameOutput();
+        std::string GetFrameStats() const;
         int CheckSchedule();
         std::string GetShowDir() const { return _showDir; }
         bool PlayPlayList(PlayList* playlist, size_t& rate, bool loop = false, const std::string& step = "", bool forcelast = false, int loops = -1, bool random = false, int steploops = -1);
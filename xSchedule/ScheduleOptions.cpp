@@ -51,6 +51,8 @@ ScheduleOptions::ScheduleOptions(OutputManager* outputManager, wxXmlNode* node,
     _port = wxAtoi(node->GetAttribute("WebServerPort", "8080"));
 #endif
     _passwordTimeout = wxAtoi(node->GetAttribute("PasswordTimeout", "30"));
+    _webStatusInterval = wxAtoi(node->GetAttribute("WebStatusInterval", "500"));
+    if (_webStatusInterval < 100) _webStatusInterval = 100;
     _wwwRoot = node->GetAttribute("WWWRoot", "xScheduleWeb");
     _crashBehaviour = node->GetAttribute("CrashBehaviour", "Prompt user");
     _artNetTimeCodeFormat = static_cast<TIMECODEFORMAT>(wxAtoi(node->GetAttribute("ARTNetTimeCodeFormat", "1")));
@@ -286,6 +288,7 @@ wxXmlNode* ScheduleOptions::Save()
 
     res->AddAttribute("WebServerPort", wxString::Format(wxT("%i"), _port));
     res->AddAttribute("PasswordTimeout", wxString::Format(wxT("%i"), _passwordTimeout));
+    res->AddAttribute("WebStatusInterval", wxString::Format(wxT("%i"), _webStatusInterval));
     res->AddAttribute("ARTNetTimeCodeFormat", wxString::Format("%d", _artNetTimeCodeFormat));
 
     for (auto it : _buttons)
@@ -168,6 +168,7 @@ class ScheduleOptions
     std::string _password;
     std::string _crashBehaviour;
     int _passwordTimeout;
+    int _webStatusInterval = 500;
     std::vector<UserButton*> _buttons;
     std::list<MatrixMapper*> _matrices;
     std::list<VirtualMatrix*> _virtualMatrices;
@@ -247,10 +248,12 @@ class ScheduleOptions
         std::string GetPassword() const { return _password; }
         std::string GetCity() const { return _city; }
         int GetPasswordTimeout() const { return _passwordTimeout; }
+        int GetWebStatusInterval() const { return _webStatusInterval; }
         void SetAPIOnly(bool apiOnly) { if (_webAPIOnly != apiOnly) { _webAPIOnly = apiOnly; _changeCount++; } }
         void SetRemoteLatency(int remoteLatency) { if (remoteLatency != _remoteLatency) { _remoteLatency = remoteLatency; _changeCount++; } }
         void SetRemoteAcceptableJitter(int remoteAcceptableJitter) { if (remoteAcceptableJitter != _remoteAcceptableJitter) { _remoteAcceptableJitter = remoteAcceptableJitter; _changeCount++; } }
         void SetPasswordTimeout(int passwordTimeout) { if (_passwordTimeout != passwordTimeout) { _passwordTimeout = passwordTimeout; _changeCount++; } }
+        void SetWebStatusInterval(int webStatusInterval) { if (_webStatusInterval != webStatusInterval) { _webStatusInterval = webStatusInterval; _changeCount++; } }
         void SetPassword(const std::string& password) { if (_password != password) { _password = password; _changeCount++; } }
         void SetCity(const std::string& city) { if (_city != city) { _city = city; _changeCount++; } }
         OSCOptions* GetOSCOptions() const { return _oscOptions; }
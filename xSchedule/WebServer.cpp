@@ -13,18 +13,38 @@
 
 #include <log4cpp/Category.hh>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #undef WXUSINGDLL
 #include "wxJSON/jsonreader.h"
+#include "wxJSON/jsonwriter.h"
 
 //#define DETAILED_LOGGING
 
-bool __apiOnly = false;
+std::atomic<bool> __apiOnly(false);
 std::string __password = "";
 std::list<std::string> __Loggedin;
 int __loginTimeout = 30;
+wxString __wwwRoot = "";
+
+// the server thread reads the security state and web root so they are guarded
+std::mutex __securityLock;
+
+// last GetPlayingStatus with marker values in place of the per request ip and reference
+#define STATUS_IP_MARKER "\x01ip\x01"
+#define STATUS_REFERENCE_MARKER "\x01ref\x01"
+std::mutex __statusLock;
+wxString __status = "";
+wxLongLong __statusTime = 0;
+wxLongLong __lastStatusPoll = 0;
+int __statusMaxAge = 2000;
 
 void RemoveFromValid(HttpConnection& connection)
 {
+    std::unique_lock<std::mutex> lock(__securityLock);
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     // remove any existing entry for this machine ... one logged in entry per machine
     for (auto it = __Loggedin.begin(); it != __Loggedin.end(); ++it)
@@ -41,6 +61,7 @@ void RemoveFromValid(HttpConnection& connection)
 
 void UpdateValid(HttpConnection& connection)
 {
+    std::unique_lock<std::mutex> lock(__securityLock);
     if (__password == "") return; // no password ... always logged in
 
     for (auto it = __Loggedin.begin(); it != __Loggedin.end(); ++it)
@@ -58,6 +79,7 @@ void UpdateValid(HttpConnection& connection)
 
 void AddToValid(HttpConnection& connection)
 {
+    std::unique_lock<std::mutex> lock(__securityLock);
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     // remove any existing entry for this machine ... one logged in entry per machine
@@ -80,6 +102,7 @@ void AddToValid(HttpConnection& connection)
 
 bool CheckLoggedIn(HttpConnection& connection)
 {
+    std::unique_lock<std::mutex> lock(__securityLock);
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     if (__password == "") return true; // no password ... always logged in
@@ -278,7 +301,11 @@ wxString ProcessLogin(HttpConnection &connection, const wxString& credential, co
     wxString result;
     if (__password != "")
     {
-        wxString cred = connection.Address().IPAddress() + __password;
+        wxString cred;
+        {
+            std::unique_lock<std::mutex> lock(__securityLock);
+            cred = connection.Address().IPAddress() + __password;
+        }
 
         // calculate md5 hash
         wxString hash = md5(cred);
@@ -407,8 +434,108 @@ wxString ProcessStash(HttpConnection &connection, const wxString& command, const
     return result;
 }
 
+// Static content only touches the file system so it is safe to serve from the server thread
+bool ServeFile(HttpConnection &connection, HttpRequest &request, const wxString& wwwroot)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    wxString uri = wxURI(request.URI()).BuildUnescapedURI();
+
+    if (__apiOnly || !request.URI().StartsWith("/" + wwwroot))
+    {
+        return false;
+    }
+
+#ifdef __WXMSW__
+    wxString d = wxFileName(wxStandardPaths::Get().GetExecutablePath()).GetPath();
+#elif __LINUX__
+    wxString d = wxStandardPaths::Get().GetDataDir();
+    if (!wxDir::Exists(d)) {
+        d = wxFileName(wxStandardPaths::Get().GetExecutablePath()).GetPath();
+    }
+#else
+    wxString d = wxStandardPaths::Get().GetResourcesDir();
+#endif
+
+    wxString file = d;
+    if (uri.Contains("?"))
+    {
+        file += uri.BeforeFirst('?');
+    }
+    else
+    {
+        file += uri;
+    }
+
+    logger_base.info("File request received = '%s' : '%s'.", (const char *)file.c_str(), (const char *)uri.c_str());
+
+    if (!wxFile::Exists(file))
+    {
+        logger_base.error("    404: file not found.");
+    }
+
+    HttpResponse response(connection, request, HttpStatus::OK);
+
+    //response.AddHeader("Cache-Control", "max-age=14400");
+
+    response.MakeFromFile(file);
+
+    connection.SendResponse(response);
+
+    return true;
+}
+
+// Answers a GetPlayingStatus poll from the last status the GUI thread produced
+bool ServeCachedStatus(HttpConnection &connection, HttpRequest &request)
+{
+    wxURI url(request.URI());
+    std::map<wxString, wxString> parms = ParseURI(url.BuildUnescapedURI());
+    if (parms["Query"] != "GetPlayingStatus") return false;
+
+    wxString status;
+    {
+        std::unique_lock<std::mutex> lock(__statusLock);
+        __lastStatusPoll = wxGetLocalTimeMillis();
+        // too old means no one has been asking so the refresh has not been running
+        if (__status == "" || wxGetLocalTimeMillis() - __statusTime > __statusMaxAge) return false;
+        status = __status;
+    }
+
+    if (!CheckLoggedIn(connection)) return false;
+
+    status.Replace(STATUS_IP_MARKER, connection.Address().IPAddress(), false);
+    status.Replace(STATUS_REFERENCE_MARKER, parms["Reference"], false);
+
+    HttpResponse response(connection, request, HttpStatus::OK);
+    response.MakeFromText(status, "application/json");
+    connection.SendResponse(response);
+    return true;
+}
+
 bool MyRequestHandler(HttpConnection &connection, HttpRequest &request)
 {
+    if (!wxThread::IsMain())
+    {
+        // files and status polls are handled here, everything else needs the schedule so runs on the GUI thread
+        wxString wwwroot;
+        {
+            std::unique_lock<std::mutex> lock(__securityLock);
+            wwwroot = __wwwRoot;
+        }
+        if ((request.URI().Lower().StartsWith("/xschedulequery") && ServeCachedStatus(connection, request)) ||
+            (wwwroot != "" && !request.URI().Lower().StartsWith("/xschedule") && !request.URI().Lower().StartsWith("/xyzzy") && ServeFile(connection, request, wwwroot)))
+        {
+            wxTheApp->CallAfter([]() {
+                if (xScheduleFrame::GetScheduleManager() != nullptr) xScheduleFrame::GetScheduleManager()->WebRequestReceived();
+            });
+            return true;
+        }
+
+        bool res = false;
+        connection.Server()->RunOnMainThread([&connection, &request, &res]() { res = MyRequestHandler(connection, request); });
+        return res;
+    }
+
     wxLogNull logNo; //kludge: avoid "error 0" message from wxWidgets after new file is written
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
@@ -530,48 +657,7 @@ bool MyRequestHandler(HttpConnection &connection, HttpRequest &request)
     }
     else if (wwwroot != "")
     {
-        wxString uri = wxURI(request.URI()).BuildUnescapedURI();
-
-        if (!__apiOnly && request.URI().StartsWith("/" + wwwroot))
-        {
-#ifdef __WXMSW__
-            wxString d = wxFileName(wxStandardPaths::Get().GetExecutablePath()).GetPath();
-#elif __LINUX__
-            wxString d = wxStandardPaths::Get().GetDataDir();
-            if (!wxDir::Exists(d)) {
-                d = wxFileName(wxStandardPaths::Get().GetExecutablePath()).GetPath();
-            }
-#else
-            wxString d = wxStandardPaths::Get().GetResourcesDir();
-#endif
-
-            wxString file = d;
-            if (uri.Contains("?"))
-            {
-                file += uri.BeforeFirst('?');
-            }
-            else
-            {
-                file += uri;
-            }
-
-            logger_base.info("File request received = '%s' : '%s'.", (const char *)file.c_str(), (const char *)uri.c_str());
-
-            if (!wxFile::Exists(file))
-            {
-                logger_base.error("    404: file not found.");
-            }
-
-            HttpResponse response(connection, request, HttpStatus::OK);
-
-            //response.AddHeader("Cache-Control", "max-age=14400");
-
-            response.MakeFromFile(file);
-
-            connection.SendResponse(response);
-
-            res = true; // disable default processing
-        }
+        res = ServeFile(connection, request, wwwroot);
     }
 
     if (res)
@@ -588,6 +674,42 @@ bool MyRequestHandler(HttpConnection &connection, HttpRequest &request)
 
 void MyMessageHandler(HttpConnection &connection, WebSocketMessage &message)
 {
+    if (!wxThread::IsMain())
+    {
+        // subscribing only touches the connection so answer it here
+        if (message.Type() == WebSocketMessage::Text)
+        {
+            wxString text((char *)message.Content().GetData(), message.Content().GetDataLen());
+            wxJSONValue root;
+            wxJSONReader reader;
+            if (reader.Parse(text, &root) == 0 && root.Get("Type", wxString("")).AsString().Lower() == "subscribe")
+            {
+                connection.SetSubscribed(root.Get("Delta", wxString("true")).AsString().Lower() == "true");
+                wxString r = root.Get("Reference", wxString("")).AsString();
+                WebSocketMessage wsm("{\"result\":\"ok\",\"reference\":\"" + r + "\",\"subscribe\":\"" + (connection.IsSubscribed() ? "delta" : "full") + "\"}");
+                connection.SendMessage(wsm);
+
+                // deltas only make sense on top of a full status
+                wxString status;
+                {
+                    std::unique_lock<std::mutex> lock(__statusLock);
+                    status = __status;
+                }
+                if (status != "")
+                {
+                    status.Replace(STATUS_IP_MARKER, "", false);
+                    status.Replace(STATUS_REFERENCE_MARKER, "", false);
+                    WebSocketMessage wsms(status);
+                    connection.SendMessage(wsms);
+                }
+                return;
+            }
+        }
+
+        connection.Server()->RunOnMainThread([&connection, &message]() { MyMessageHandler(connection, message); });
+        return;
+    }
+
     wxLogNull logNo; //kludge: avoid "error 0" message from wxWidgets after new file is written
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
@@ -686,34 +808,33 @@ void MyMessageHandler(HttpConnection &connection, WebSocketMessage &message)
 
 void WebServer::SendMessageToAllWebSockets(const wxString& message)
 {
-    static bool reentry = false;
-    if (reentry)
-    {
-        return;
-    }
-    reentry = true;
-
-    for (auto it = _connections.begin(); it != _connections.end(); ++it)
-    {
-        if ((*it).second->IsWebSocket())
+    // the write happens on the server thread so a slow client never holds up the GUI
+    Post([this, message]() {
+        for (auto it = _connections.begin(); it != _connections.end(); ++it)
         {
-            WebSocketMessage wsm(message);
-            if (it->second->SendMessage(wsm))
+            if ((*it).second->IsWebSocket())
             {
-                UpdateValid(*it->second);
-            }
-            else
-            {
-                RemoveFromValid(*it->second);
+                WebSocketMessage wsm(message);
+                if (it->second->SendMessage(wsm))
+                {
+                    UpdateValid(*it->second);
+                }
+                else
+                {
+                    RemoveFromValid(*it->second);
+                }
             }
         }
-    }
-
-    reentry = false;
+    });
 }
 
 bool WebServer::IsSomeoneListening() const
 {
+    if (IsThreaded())
+    {
+        return _webSocketCount > 0;
+    }
+
     for (auto it : _connections)
     {
         if (it.second->IsWebSocket())
@@ -724,11 +845,153 @@ bool WebServer::IsSomeoneListening() const
     return false;
 }
 
-WebServer::WebServer(int port, bool apionly, const wxString& password, int mins)
+#pragma region Status Push
+
+// Called on the GUI thread. Refreshes the cached status used to answer polls and pushes it to
+// listening web sockets ... the full status to most clients, only the changed values to subscribers.
+void WebServer::PushStatus()
+{
+    ScheduleManager* schedule = xScheduleFrame::GetScheduleManager();
+    if (schedule == nullptr) return;
+
+    _statusRequested = false;
+    _lastStatusPush = wxGetLocalTimeMillis().GetValue();
+
+    wxString result;
+    if (schedule->IsXyzzy())
+    {
+        if (IsSomeoneListening())
+        {
+            schedule->DoXyzzy("q", "", result, "");
+            SendMessageToAllWebSockets(result);
+        }
+        return;
+    }
+
+    wxString msg;
+    schedule->Query("GetPlayingStatus", "", result, msg, STATUS_IP_MARKER, STATUS_REFERENCE_MARKER);
+    {
+        std::unique_lock<std::mutex> lock(__statusLock);
+        __status = result;
+        __statusTime = wxGetLocalTimeMillis();
+    }
+
+    if (!IsSomeoneListening())
+    {
+        _lastPushed.clear();
+        return;
+    }
+
+    wxString full = result;
+    full.Replace(STATUS_IP_MARKER, "", false);
+    full.Replace(STATUS_REFERENCE_MARKER, "", false);
+
+    wxJSONValue root;
+    wxJSONReader reader;
+    if (reader.Parse(full, &root) > 0 || !root.IsObject())
+    {
+        // we cant work out what changed so everyone gets everything
+        _lastPushed.clear();
+        SendMessageToAllWebSockets(full);
+        return;
+    }
+
+    std::map<wxString, wxString> values;
+    wxArrayString names = root.GetMemberNames();
+    for (auto it = names.begin(); it != names.end(); ++it)
+    {
+        wxJSONWriter writer(wxJSONWRITER_NONE);
+        wxString v;
+        writer.Write(root[*it], v);
+        values[*it] = v;
+    }
+
+    wxString delta;
+    bool sameKeys = values.size() == _lastPushed.size();
+    for (auto it = values.begin(); it != values.end(); ++it)
+    {
+        auto last = _lastPushed.find(it->first);
+        if (last == _lastPushed.end())
+        {
+            sameKeys = false;
+        }
+        else if (last->second == it->second)
+        {
+            continue;
+        }
+        delta += ",\"" + it->first + "\":" + it->second;
+    }
+    _lastPushed = values;
+
+    if (delta == "") return; // nothing changed
+
+    if (sameKeys)
+    {
+        delta = "{\"delta\":\"true\"" + delta + "}";
+    }
+    else
+    {
+        // idle <-> playing changes the shape of the status so resend it all
+        delta = full;
+    }
+
+    Post([this, full, delta]() {
+        for (auto it = _connections.begin(); it != _connections.end(); ++it)
+        {
+            if ((*it).second->IsWebSocket())
+            {
+                WebSocketMessage wsm(it->second->IsSubscribed() ? delta : full);
+                if (it->second->SendMessage(wsm))
+                {
+                    UpdateValid(*it->second);
+                }
+                else
+                {
+                    RemoveFromValid(*it->second);
+                }
+            }
+        }
+    });
+}
+
+// Server thread. Asks the GUI thread for a fresh status at the configured rate while anyone is listening or polling.
+void WebServer::OnServerIdle()
+{
+    if (_statusRequested) return;
+
+    wxLongLong now = wxGetLocalTimeMillis();
+    if (now.GetValue() - _lastStatusPush < _statusInterval) return;
+
+    bool polled;
+    {
+        std::unique_lock<std::mutex> lock(__statusLock);
+        polled = now - __lastStatusPoll < 10000;
+    }
+    if (!polled && _webSocketCount == 0) return;
+
+    _statusRequested = true;
+    std::shared_ptr<std::atomic<bool>> alive = _alive;
+    wxTheApp->CallAfter([this, alive]() {
+        if (*alive) PushStatus();
+    });
+}
+
+#pragma endregion
+
+WebServer::WebServer(int port, bool apionly, const wxString& password, int mins, const wxString& wwwroot, int statusInterval) :
+    _alive(std::make_shared<std::atomic<bool>>(true)), _statusRequested(false), _lastStatusPush(0), _statusInterval(statusInterval)
 {
     __apiOnly = apionly; // put this in a global.
-    __password = password;
-    __loginTimeout = mins;
+    {
+        std::unique_lock<std::mutex> lock(__securityLock);
+        __password = password;
+        __loginTimeout = mins;
+        __wwwRoot = wwwroot;
+    }
+    {
+        std::unique_lock<std::mutex> lock(__statusLock);
+        __statusMaxAge = std::max(2000, 2 * statusInterval);
+    }
 
     wxLogNull logNo; //kludge: avoid "error 0" message from wxWidgets after new file is written
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -737,6 +1000,7 @@ WebServer::WebServer(int port, bool apionly, const wxString& password, int mins)
     context.Port = port;
     context.RequestHandler = MyRequestHandler;
     context.MessageHandler = MyMessageHandler;
+    context.Threaded = true;
 
     if (!Start(context))
     {
@@ -748,6 +1012,7 @@ WebServer::WebServer(int port, bool apionly, const wxString& password, int mins)
 WebServer::~WebServer()
 {
     wxLogNull logNo; //kludge: avoid "error 0" message from wxWidgets after new file is written
+    *_alive = false;
     Stop();
 }
 
@@ -758,10 +1023,18 @@ void WebServer::SetAPIOnly(bool apiOnly)
 
 void WebServer::SetPasswordTimeout(int mins)
 {
+    std::unique_lock<std::mutex> lock(__securityLock);
     __loginTimeout = mins;
 }
 
 void WebServer::SetPassword(const wxString& password)
 {
+    std::unique_lock<std::mutex> lock(__securityLock);
     __password = password;
 }
+
+void WebServer::SetWWWRoot(const wxString& wwwroot)
+{
+    std::unique_lock<std::mutex> lock(__securityLock);
+    __wwwRoot = wwwroot;
+}
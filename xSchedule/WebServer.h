@@ -3,18 +3,34 @@
 
 #include "wxHTTPServer/wxhttpserver.h"
 
+#include <atomic>
+#include <map>
+#include <memory>
+
 class WebServer : HttpServer
 {
 
 public:
 
-        WebServer(int port, bool apionly = false, const wxString& password = "", int mins = 30);
+        WebServer(int port, bool apionly = false, const wxString& password = "", int mins = 30, const wxString& wwwroot = "", int statusInterval = 500);
         virtual ~WebServer();
         void SetAPIOnly(bool apiOnly);
         void SetPasswordTimeout(int mins);
         void SetPassword(const wxString& password);
+        void SetWWWRoot(const wxString& wwwroot);
         void SendMessageToAllWebSockets(const wxString& message);
         bool IsSomeoneListening() const;
+        void PushStatus();
+
+protected:
+        virtual void OnServerIdle() override;
+
+private:
+        std::shared_ptr<std::atomic<bool>> _alive;
+        std::atomic<bool> _statusRequested;
+        std::atomic<long long> _lastStatusPush;
+        int _statusInterval;
+        std::map<wxString, wxString> _lastPushed;
 };
 
 #endif
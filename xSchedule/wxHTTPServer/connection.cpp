@@ -23,6 +23,7 @@ HttpConnection::HttpConnection(HttpServer *server, wxSocketBase *socket) :
 	_server(server),
 	_socket(socket),
 	_isWebSocket(false),
+	_subscribed(false),
 	_message(NULL)
 {
 	if (!_socket->GetPeer(_address))
@@ -36,9 +37,17 @@ HttpConnection::~HttpConnection()
 	wxLogMessage(_("connection closed (socket %d)"), _socket->GetSocket());
 }
 
+void HttpConnection::SetFlags(wxSocketFlags flags)
+{
+	// sockets used off the GUI thread must never yield to the event loop
+	if (_server->_context.Threaded)
+		flags |= wxSOCKET_BLOCK;
+	_socket->SetFlags(flags);
+}
+
 bool HttpConnection::HandleRequest()
 {
-	_socket->SetFlags(wxSOCKET_NOWAIT);
+	SetFlags(wxSOCKET_NOWAIT);
 
 	wxMemoryBuffer input;
 	char           buffer[1024];
@@ -116,11 +125,11 @@ bool HttpConnection::HandleRequest()
 
 bool HttpConnection::SendResponse(HttpResponse &response)
 {
-    _socket->SetFlags(wxSOCKET_WAITALL);
+    SetFlags(wxSOCKET_WAITALL);
 	wxString row = wxString::Format("%s %d %s\r\n", response.Version(), response.Status().Code(), response.Status().Description());
 	_socket->Write(row.ToAscii(), row.Length());
     if (_socket->Error()) {
-        _socket->SetFlags(wxSOCKET_NOWAIT);
+        SetFlags(wxSOCKET_NOWAIT);
         return false;
     }
 
@@ -129,14 +138,14 @@ bool HttpConnection::SendResponse(HttpResponse &response)
 		wxString header = response[i];
 		_socket->Write(header.ToAscii(), header.Length());
         if (_socket->Error()) {
-            _socket->SetFlags(wxSOCKET_NOWAIT);
+            SetFlags(wxSOCKET_NOWAIT);
             return false;
         }
 	}
 
 	_socket->Write("\r\n", 2);
     if (_socket->Error()) {
-        _socket->SetFlags(wxSOCKET_NOWAIT);
+        SetFlags(wxSOCKET_NOWAIT);
         return false;
     }
     
@@ -144,19 +153,19 @@ bool HttpConnection::SendResponse(HttpResponse &response)
 	{
 		_socket->Write(response._content.GetData(), response._content.GetDataLen());
         if (_socket->Error()) {
-            _socket->SetFlags(wxSOCKET_NOWAIT);
+            SetFlags(wxSOCKET_NOWAIT);
             return false;
         }
 	}
 
-    _socket->SetFlags(wxSOCKET_NOWAIT);
+    SetFlags(wxSOCKET_NOWAIT);
 	return true;
 }
 
 bool HttpConnection::SendMessage(WebSocketMessage &message)
 {
     // As we are just writing dont set it to wait
-    //_socket->SetFlags(wxSOCKET_WAITALL);
+    //SetFlags(wxSOCKET_WAITALL);
 	wxMemoryBuffer header;
 
 	header.AppendByte((wxUint8)0x80 | message._type); // final + type
@@ -185,14 +194,14 @@ bool HttpConnection::SendMessage(WebSocketMessage &message)
 	_socket->Write(header.GetData(), header.GetDataLen());
     if (_socket->Error())
     {
-        _socket->SetFlags(wxSOCKET_NOWAIT);
+        SetFlags(wxSOCKET_NOWAIT);
         return false;
     }
 
 	if (!message._content.IsEmpty())
 		_socket->Write(message._content.GetData(), message._content.GetDataLen());
 
-    _socket->SetFlags(wxSOCKET_NOWAIT);
+    SetFlags(wxSOCKET_NOWAIT);
     return !_socket->Error();
 }
 
@@ -21,6 +21,7 @@ extern const char *PAGE400;
 extern const char *PAGE404;
 
 HttpContext::HttpContext() :
+	Threaded(false),
 	RequestHandler(NULL),
 	MessageHandler(NULL)
 {
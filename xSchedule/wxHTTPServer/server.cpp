@@ -15,6 +15,9 @@
 #include "wxhttpserver.h"
 #include <log4cpp/Category.hh>
 
+#include <condition_variable>
+#include <memory>
+
 //#define DETAILED_LOGGING
 
 #define SERVER_ID	100
@@ -30,7 +33,10 @@ BEGIN_EVENT_TABLE(HttpServer, wxEvtHandler)
 END_EVENT_TABLE()
 
 HttpServer::HttpServer() :
-	_server(NULL)
+	_webSocketCount(0),
+	_server(NULL),
+	_thread(nullptr),
+	_stopping(false)
 {
 }
 
@@ -56,7 +62,7 @@ bool HttpServer::Start(const HttpContext &context)
     logger_base.info("starting server on %s:%u...", (const char *)_address.IPAddress().c_str(), _address.Service());
 
 	// Create the socket
-	_server = new wxSocketServer(_address, wxSOCKET_REUSEADDR);
+	_server = new wxSocketServer(_address, _context.Threaded ? (wxSOCKET_REUSEADDR | wxSOCKET_BLOCK) : wxSOCKET_REUSEADDR);
 
 	// We use IsOk() here to see if the server is really listening
     if (!_server->IsOk())
@@ -78,10 +84,20 @@ bool HttpServer::Start(const HttpContext &context)
             logger_base.info("server running on %s:%u", (const char *)address.IPAddress().c_str(), address.Service());
         }
 
-		// Setup the event handler and subscribe to connection events
-		_server->SetEventHandler(*this, SERVER_ID);
-		_server->SetNotify(wxSOCKET_CONNECTION_FLAG);
-		_server->Notify(true);
+		if (_context.Threaded)
+		{
+			// sockets used from a worker thread need the socket layer initialised on the main thread
+			wxSocketBase::Initialize();
+			_stopping = false;
+			_thread = new std::thread(&HttpServer::Run, this);
+		}
+		else
+		{
+			// Setup the event handler and subscribe to connection events
+			_server->SetEventHandler(*this, SERVER_ID);
+			_server->SetNotify(wxSOCKET_CONNECTION_FLAG);
+			_server->Notify(true);
+		}
 	}
 
 	return _server->IsOk();
@@ -93,6 +109,17 @@ bool HttpServer::Stop()
     
     if (!_server) return false;
 
+    if (_thread != nullptr)
+    {
+        _stopping = true;
+        _thread->join();
+        delete _thread;
+        _thread = nullptr;
+
+        std::unique_lock<std::mutex> lock(_postLock);
+        _posted.clear();
+    }
+
     // close all open connections
     for (auto it = _connections.begin(); it != _connections.end(); ++it)
     {
@@ -234,3 +261,156 @@ void HttpServer::OnSocketEvent(wxSocketEvent& event)
     logger_base.info("OnSocketEvent Time %ld.", sw.Time());
 #endif
 }
+
+#pragma region Threaded Server
+
+// The wxSocket API only offers select style readiness checks so the loop polls each connection.
+// With the handful of phones and kiosks that talk to xSchedule this is cheap and it keeps the
+// socket I/O, file serving and web socket pushes off the GUI thread.
+void HttpServer::Run()
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    logger_base.debug("Web server thread started.");
+
+    while (!_stopping)
+    {
+        bool busy = false;
+
+        if (_server->WaitForAccept(0, 0))
+        {
+            wxSocketBase *socket = _server->Accept(false);
+            if (socket)
+            {
+#ifdef DETAILED_LOGGING
+                logger_base.info("created socket client (socket %d)", socket->GetSocket());
+#endif
+                socket->SetFlags(wxSOCKET_NOWAIT | wxSOCKET_BLOCK);
+                _connections[socket] = new HttpConnection(this, socket);
+                busy = true;
+            }
+        }
+
+        std::list<wxSocketBase*> lost;
+        int webSockets = 0;
+        for (auto it = _connections.begin(); it != _connections.end(); ++it)
+        {
+            wxSocketBase *socket = it->first;
+            if (socket->WaitForRead(0, 0))
+            {
+                // readable with nothing to read means the other end went away
+                char c;
+                socket->Peek(&c, 1);
+                if (socket->LastReadCount() == 0)
+                {
+                    lost.push_back(socket);
+                    continue;
+                }
+                it->second->HandleRequest();
+                busy = true;
+            }
+            if (it->second->IsWebSocket()) webSockets++;
+        }
+        for (auto it = lost.begin(); it != lost.end(); ++it)
+        {
+            CloseConnection(*it);
+        }
+        _webSocketCount = webSockets;
+
+        std::list<std::function<void()>> posted;
+        {
+            std::unique_lock<std::mutex> lock(_postLock);
+            posted.swap(_posted);
+        }
+        for (auto it = posted.begin(); it != posted.end(); ++it)
+        {
+            (*it)();
+        }
+
+        OnServerIdle();
+
+        if (!busy && posted.empty())
+        {
+            // doubles as our sleep but wakes immediately for a new connection
+            _server->WaitForAccept(0, 10);
+        }
+    }
+
+    logger_base.debug("Web server thread stopped.");
+}
+
+void HttpServer::CloseConnection(wxSocketBase *socket)
+{
+    auto it = _connections.find(socket);
+    if (it == _connections.end()) return;
+
+    HttpConnection *connection = it->second;
+    _connections.erase(it);
+    delete connection;
+
+#ifdef DETAILED_LOGGING
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    logger_base.info("deleted socket client (socket %d)", socket->GetSocket());
+#endif
+    // no events are ever delivered to threaded sockets so there is nothing to delay the delete for
+    socket->Close();
+    delete socket;
+}
+
+void HttpServer::Post(std::function<void()> fn)
+{
+    if (_thread == nullptr)
+    {
+        fn();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_postLock);
+    _posted.push_back(fn);
+}
+
+class MainThreadCall
+{
+public:
+    std::mutex lock;
+    std::condition_variable signal;
+    std::function<void()> fn;
+    bool done = false;
+    bool abandoned = false;
+};
+
+bool HttpServer::RunOnMainThread(std::function<void()> fn) const
+{
+    if (_thread == nullptr || wxThread::IsMain())
+    {
+        fn();
+        return true;
+    }
+
+    auto call = std::make_shared<MainThreadCall>();
+    call->fn = fn;
+
+    wxTheApp->CallAfter([call]() {
+        std::unique_lock<std::mutex> lock(call->lock);
+        if (!call->abandoned)
+        {
+            call->fn();
+        }
+        call->done = true;
+        call->signal.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(call->lock);
+    while (!call->done)
+    {
+        // Stop() joins this thread from the main thread so we cannot wait forever
+        if (_stopping)
+        {
+            call->abandoned = true;
+            return false;
+        }
+        call->signal.wait_for(lock, std::chrono::milliseconds(50));
+    }
+    return true;
+}
+
+#pragma endregion
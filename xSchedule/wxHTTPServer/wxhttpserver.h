@@ -24,6 +24,12 @@
 #include <wx/dynarray.h>
 #include <wx/hash.h>
 
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+
 #define SERVER_NAME    "xLights Web Server"
 #define SERVER_VERSION "1.0"
 
@@ -62,6 +68,10 @@ public:
 	// list of predefined documents
 	wxArrayString DefaultDocuments;
 
+	// run the server on its own thread rather than from socket events on the GUI thread
+	// handlers are then called on the server thread and must use RunOnMainThread for GUI state
+	bool          Threaded;
+
 	// overridables
 	RequestHandlerPtr RequestHandler;
 	MessageHandlerPtr MessageHandler;
@@ -210,8 +220,12 @@ public:
 	inline const wxSocketBase *Socket() const { return _socket; }
 	inline const IPaddress &Address() { return _address; }
 	inline bool IsWebSocket() { return _isWebSocket; }
+	// web socket clients which asked for pushed updates
+	inline bool IsSubscribed() const { return _subscribed; }
+	inline void SetSubscribed(bool subscribed) { _subscribed = subscribed; }
 
 protected:
+	void SetFlags(wxSocketFlags flags);
 	void ParseRequest(const wxString &content);
 	bool ParseFrame(wxMemoryBuffer &buffer);
 	bool WebSocketHandshake(HttpRequest &request);
@@ -221,6 +235,7 @@ protected:
 	wxSocketBase     *_socket;
 	IPaddress         _address;
 	bool              _isWebSocket;
+	bool              _subscribed;
 	WebSocketMessage *_message;
 };
 
@@ -321,21 +336,38 @@ public:
 	bool Start(const HttpContext &context);
 	bool Stop();
 
+	// run a function on the GUI thread and wait for it ... returns false if the server stopped first
+	bool RunOnMainThread(std::function<void()> fn) const;
+	// run a function on the server thread, this is where connections can be written to
+	void Post(std::function<void()> fn);
+
 	// properties
 
 	inline const HttpContext &Context() const { return _context; }
+	inline bool IsThreaded() const { return _thread != nullptr; }
 
 protected:
 	// event handlers (these functions should _not_ be virtual)
 	void OnServerEvent(wxSocketEvent &event);
 	void OnSocketEvent(wxSocketEvent &event);
+	// called on the server thread every pass of the loop
+	virtual void OnServerIdle() {}
+	void CloseConnection(wxSocketBase *socket);
     ConnectionMap   _connections;
+    std::atomic<int> _webSocketCount;
 
 private:
+	void Run();
+
 	wxSocketServer *_server;
 	HttpContext     _context;
 	IPaddress       _address;
 
+	std::thread                      *_thread;
+	std::atomic<bool>                 _stopping;
+	std::mutex                        _postLock;
+	std::list<std::function<void()>>  _posted;
+
 	DECLARE_EVENT_TABLE()
 
 	friend class HttpConnection;
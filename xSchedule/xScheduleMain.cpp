@@ -865,7 +865,8 @@ void xScheduleFrame::LoadSchedule()
         delete _webServer;
         _webServer = nullptr;
     }
-    _webServer = new WebServer(__schedule->GetOptions()->GetWebServerPort(), __schedule->GetOptions()->GetAPIOnly(), __schedule->GetOptions()->GetPassword(), __schedule->GetOptions()->GetPasswordTimeout());
+    _webServer = new WebServer(__schedule->GetOptions()->GetWebServerPort(), __schedule->GetOptions()->GetAPIOnly(), __schedule->GetOptions()->GetPassword(), __schedule->GetOptions()->GetPasswordTimeout(),
+        __schedule->GetOptions()->GetWWWRoot(), __schedule->GetOptions()->GetWebStatusInterval());
 
     if (wxFile::Exists(_showDir + "/xlights_networks.xml"))
     {
@@ -1575,13 +1576,15 @@ void xScheduleFrame::OnMenuItem_OptionsSelected(wxCommandEvent& event)
         {
             delete _webServer;
             _webServer = new WebServer(__schedule->GetOptions()->GetWebServerPort(), __schedule->GetOptions()->GetAPIOnly(),
-                __schedule->GetOptions()->GetPassword(), __schedule->GetOptions()->GetPasswordTimeout());
+                __schedule->GetOptions()->GetPassword(), __schedule->GetOptions()->GetPasswordTimeout(),
+                __schedule->GetOptions()->GetWWWRoot(), __schedule->GetOptions()->GetWebStatusInterval());
         }
         else
         {
             _webServer->SetAPIOnly(__schedule->GetOptions()->GetAPIOnly());
             _webServer->SetPassword(__schedule->GetOptions()->GetPassword());
             _webServer->SetPasswordTimeout(__schedule->GetOptions()->GetPasswordTimeout());
+            _webServer->SetWWWRoot(__schedule->GetOptions()->GetWWWRoot());
         }
 
         Schedule::SetCity(__schedule->GetOptions()->GetCity());
@@ -2215,9 +2218,7 @@ void xScheduleFrame::UpdateStatus(bool force)
 
     StaticText_Time->SetLabel(wxDateTime::Now().FormatTime());
 
-    SendStatus();
-
-    logger_frame.debug("            Status Sent %ldms", sw.Time());
+    // web status is pushed by the web server at WebStatusInterval, not at the UI refresh rate
 }
 
 void xScheduleFrame::OnBitmapButton_OutputToLightsClick(wxCommandEvent& event)
@@ -3163,23 +3164,9 @@ void xScheduleFrame::OnMenuItem_VirtualMatricesSelected(wxCommandEvent& event)
 
 void xScheduleFrame::SendStatus()
 {
-    if (_webServer != nullptr && __schedule != nullptr)
+    if (_webServer != nullptr && __schedule != nullptr && _webServer->IsSomeoneListening())
     {
-        if (_webServer->IsSomeoneListening())
-        {
-            wxString result;
-            if (__schedule->IsXyzzy())
-            {
-                __schedule->DoXyzzy("q", "", result, "");
-            }
-            else
-            {
-                wxString msg;
-                __schedule->Query("GetPlayingStatus", "", result, msg, "", "");
-            }
-
-            _webServer->SendMessageToAllWebSockets(result);
-        }
+        _webServer->PushStatus();
     }
 }
 